@@ -0,0 +1,291 @@
+#include "LTextEdit.h"
+#include "common.h"
+#include <stdlib.h>
+#include <string.h>
+
+// map character into supported one
+static char supported_char(char c)
+{
+  if (c == '\t')
+    return ' ';
+  else if (c < 32 || c > 126)
+    return '?';
+  return c;
+}
+
+static void free_line(LTextEdit_line* line)
+{
+  for (int i=0; i<line->num_runs; i++)
+  {
+    if (line->runs[i].texture != NULL)
+      LTexture_Free(line->runs[i].texture);
+  }
+  free(line->runs);
+  line->runs = NULL;
+  line->num_runs = 0;
+  line->capacity_runs = 0;
+}
+
+// add a new empty line at the end
+// return NULL if failed to allocate
+static LTextEdit_line* push_line(LTextEdit* edit)
+{
+  if (edit->num_lines == edit->capacity_lines)
+  {
+    int new_capacity = edit->capacity_lines == 0 ? 16 : edit->capacity_lines * 2;
+    LTextEdit_line* new_lines = realloc(edit->lines, sizeof(LTextEdit_line) * new_capacity);
+    if (new_lines == NULL)
+    {
+      SDL_Log("Unable to allocate memory for text lines");
+      return NULL;
+    }
+    edit->lines = new_lines;
+    edit->capacity_lines = new_capacity;
+  }
+
+  LTextEdit_line* line = &edit->lines[edit->num_lines++];
+  line->runs = NULL;
+  line->num_runs = 0;
+  line->capacity_runs = 0;
+  line->width = 0;
+  line->hard_break = false;
+  return line;
+}
+
+// add a new empty run at the end of line
+// return NULL if failed to allocate
+static LTextEdit_run* push_run(LTextEdit_line* line)
+{
+  if (line->num_runs == line->capacity_runs)
+  {
+    int new_capacity = line->capacity_runs == 0 ? 4 : line->capacity_runs * 2;
+    LTextEdit_run* new_runs = realloc(line->runs, sizeof(LTextEdit_run) * new_capacity);
+    if (new_runs == NULL)
+    {
+      SDL_Log("Unable to allocate memory for text runs");
+      return NULL;
+    }
+    line->runs = new_runs;
+    line->capacity_runs = new_capacity;
+  }
+
+  LTextEdit_run* run = &line->runs[line->num_runs++];
+  run->text[0] = '\0';
+  run->len = 0;
+  run->x = line->width;
+  run->width = 0;
+  run->texture = NULL;
+  run->dirty = true;
+  return run;
+}
+
+LTextEdit* LTextEdit_new(SDL_Color color, int wrap_width)
+{
+  LTextEdit* out = malloc(sizeof(LTextEdit));
+  out->color = color;
+  out->wrap_width = wrap_width;
+  out->line_height = TTF_FontLineSkip(gFont);
+
+  // cache advance of all characters, so layout doesn't need to query font
+  for (int c=0; c<128; c++)
+  {
+    int advance = 0;
+    if (c >= 32 && c <= 126)
+      TTF_GlyphMetrics(gFont, c, NULL, NULL, NULL, NULL, &advance);
+    out->advances[c] = advance;
+  }
+
+  out->lines = NULL;
+  out->num_lines = 0;
+  out->capacity_lines = 0;
+  out->first_rendered_line = 0;
+  out->length = 0;
+
+  // always has at least one line
+  if (push_line(out) == NULL)
+  {
+    free(out);
+    return NULL;
+  }
+  return out;
+}
+
+void LTextEdit_append(LTextEdit* edit, const char* text)
+{
+  LTextEdit_line* line = &edit->lines[edit->num_lines-1];
+
+  for (const char* p = text; *p != '\0'; p++)
+  {
+    if (*p == '\r')
+    {
+      continue;
+    }
+    else if (*p == '\n')
+    {
+      line->hard_break = true;
+      if ((line = push_line(edit)) == NULL)
+        return;
+      edit->length++;
+      continue;
+    }
+
+    char c = supported_char(*p);
+    int advance = edit->advances[(int)c];
+
+    // wrap to next line if it doesn't fit, always keep at least one character per line
+    if (line->width > 0 && line->width + advance > edit->wrap_width)
+    {
+      if ((line = push_line(edit)) == NULL)
+        return;
+    }
+
+    // append into the last run, or start a new one if full
+    LTextEdit_run* run = line->num_runs > 0 ? &line->runs[line->num_runs-1] : NULL;
+    if (run == NULL || run->len == LTEXTEDIT_RUN_LENGTH)
+    {
+      if ((run = push_run(line)) == NULL)
+        return;
+    }
+
+    run->text[run->len++] = c;
+    run->text[run->len] = '\0';
+    run->width += advance;
+    run->dirty = true;
+    line->width += advance;
+    edit->length++;
+  }
+}
+
+void LTextEdit_backspace(LTextEdit* edit)
+{
+  LTextEdit_line* line = &edit->lines[edit->num_lines-1];
+
+  // empty line, remove it and go back to the previous line
+  if (line->num_runs == 0)
+  {
+    if (edit->num_lines == 1)
+      return;
+
+    free_line(line);
+    edit->num_lines--;
+    line = &edit->lines[edit->num_lines-1];
+
+    // remove newline character
+    if (line->hard_break)
+    {
+      line->hard_break = false;
+      edit->length--;
+      return;
+    }
+    // otherwise line was wrapped, remove its last character instead
+  }
+
+  LTextEdit_run* run = &line->runs[line->num_runs-1];
+  int advance = edit->advances[(int)run->text[run->len-1]];
+  run->text[--run->len] = '\0';
+  run->width -= advance;
+  line->width -= advance;
+  edit->length--;
+
+  if (run->len == 0)
+  {
+    if (run->texture != NULL)
+      LTexture_Free(run->texture);
+    line->num_runs--;
+  }
+  else
+  {
+    run->dirty = true;
+  }
+}
+
+void LTextEdit_clear(LTextEdit* edit)
+{
+  for (int i=0; i<edit->num_lines; i++)
+  {
+    free_line(&edit->lines[i]);
+  }
+  edit->num_lines = 0;
+  edit->first_rendered_line = 0;
+  edit->length = 0;
+  push_line(edit);
+}
+
+char* LTextEdit_get_text(const LTextEdit* edit)
+{
+  char* out = malloc(edit->length + 1);
+  if (out == NULL)
+    return NULL;
+
+  char* p = out;
+  for (int i=0; i<edit->num_lines; i++)
+  {
+    const LTextEdit_line* line = &edit->lines[i];
+    for (int j=0; j<line->num_runs; j++)
+    {
+      memcpy(p, line->runs[j].text, line->runs[j].len);
+      p += line->runs[j].len;
+    }
+    if (line->hard_break)
+      *p++ = '\n';
+  }
+  *p = '\0';
+  return out;
+}
+
+void LTextEdit_render(LTextEdit* edit, int x, int y, int view_height)
+{
+  int visible_lines = view_height / edit->line_height;
+  if (visible_lines < 1)
+    visible_lines = 1;
+  int first_line = edit->num_lines - visible_lines;
+  if (first_line < 0)
+    first_line = 0;
+
+  // release textures of lines scrolled out of view
+  for (int i=edit->first_rendered_line; i<first_line; i++)
+  {
+    LTextEdit_line* line = &edit->lines[i];
+    for (int j=0; j<line->num_runs; j++)
+    {
+      if (line->runs[j].texture != NULL)
+      {
+        LTexture_Free(line->runs[j].texture);
+        line->runs[j].texture = NULL;
+        line->runs[j].dirty = true;
+      }
+    }
+  }
+  edit->first_rendered_line = first_line;
+
+  for (int i=first_line; i<edit->num_lines; i++)
+  {
+    LTextEdit_line* line = &edit->lines[i];
+    int line_y = y + (i - first_line) * edit->line_height;
+
+    for (int j=0; j<line->num_runs; j++)
+    {
+      LTextEdit_run* run = &line->runs[j];
+      if (run->dirty)
+      {
+        if (run->texture != NULL)
+          LTexture_Free(run->texture);
+        run->texture = LTexture_LoadFromRenderedTextBlended(run->text, edit->color);
+        run->dirty = false;
+      }
+
+      if (run->texture != NULL)
+        LTexture_Render(run->texture, x + run->x, line_y);
+    }
+  }
+}
+
+void LTextEdit_free(LTextEdit* edit)
+{
+  for (int i=0; i<edit->num_lines; i++)
+  {
+    free_line(&edit->lines[i]);
+  }
+  free(edit->lines);
+  free(edit);
+}
@@ -0,0 +1,117 @@
+/*
+ * LTextEdit
+ *
+ * Editable multi-line text that only re-renders what has changed.
+ *
+ * Text is wrapped by pixel width into lines, and each line is split into runs
+ * of at most LTEXTEDIT_RUN_LENGTH characters each with its own texture.
+ * Appending or removing a character only re-renders the last run, and only runs of
+ * visible lines are rendered at all, thus pasting large text doesn't stall.
+ *
+ * It renders text with gFont, only ASCII characters are supported, others show as '?'.
+ * Text is wrapped at character boundary.
+ */
+
+#ifndef LTextEdit_h_
+#define LTextEdit_h_
+
+#include <stdbool.h>
+#include "SDL.h"
+#include "LTexture.h"
+
+// maximum number of characters in a single run
+#define LTEXTEDIT_RUN_LENGTH 16
+
+typedef struct {
+	// characters of this run, null-terminated
+	char text[LTEXTEDIT_RUN_LENGTH+1];
+	int len;
+
+	// position x relative to its line, and width in pixels
+	int x;
+	int width;
+
+	// rendered text, NULL if not rendered yet or released
+	LTexture* texture;
+
+	// whether texture needs to be re-rendered
+	bool dirty;
+} LTextEdit_run;
+
+typedef struct {
+	LTextEdit_run* runs;
+	int num_runs;
+	int capacity_runs;
+
+	// width of line in pixels
+	int width;
+
+	// whether line ends with newline character, otherwise it's wrapped
+	bool hard_break;
+} LTextEdit_line;
+
+typedef struct {
+	// color of text
+	SDL_Color color;
+
+	// width in pixels to wrap text
+	int wrap_width;
+
+	// height of a line in pixels
+	int line_height;
+
+	// advance in pixels of each ASCII character
+	int advances[128];
+
+	LTextEdit_line* lines;
+	int num_lines;
+	int capacity_lines;
+
+	// first line that has been rendered last time, textures of lines before it are released
+	int first_rendered_line;
+
+	// total number of characters including newlines
+	int length;
+} LTextEdit;
+
+/*
+ * Create a new LTextEdit with empty text.
+ * wrap_width is the width in pixels to wrap text.
+ * Return newly created LTextEdit, or NULL if failed.
+ */
+extern LTextEdit* LTextEdit_new(SDL_Color color, int wrap_width);
+
+/*
+ * Append text at the end.
+ * Only the last run of each touched line is marked to be re-rendered.
+ */
+extern void LTextEdit_append(LTextEdit* edit, const char* text);
+
+/*
+ * Remove the last character, if any.
+ */
+extern void LTextEdit_backspace(LTextEdit* edit);
+
+/*
+ * Remove all text.
+ */
+extern void LTextEdit_clear(LTextEdit* edit);
+
+/*
+ * Get whole text as a single string.
+ * Return newly allocated string, free it with free().
+ */
+extern char* LTextEdit_get_text(const LTextEdit* edit);
+
+/*
+ * Render the last lines that fit into view_height at given point.
+ * Dirty runs of visible lines are re-rendered first.
+ */
+extern void LTextEdit_render(LTextEdit* edit, int x, int y, int view_height);
+
+/*
+ * Free LTextEdit and all of its textures.
+ */
+extern void LTextEdit_free(LTextEdit* edit);
+
+#endif
@@ -60,21 +60,9 @@ LTexture* LTexture_LoadFromFileColorKeyFlag(const char* path, bool withColorKey,
 }
 
 #ifndef DISABLE_SDL_TTF_LIB
-LTexture* LTexture_LoadFromRenderedText(const char* textureText, SDL_Color textColor, Uint32 wrapLength)
+// create LTexture from rendered text surface, textSurface will be freed
+static LTexture* create_from_text_surface(SDL_Surface* textSurface)
 {
-  // render text surface
-  SDL_Surface *textSurface = NULL;
-
-  // if wrapLength is 0, then render without auto-wrapping support
-  if (wrapLength == 0)
-  {
-    textSurface = TTF_RenderText_Solid(gFont, textureText, textColor);
-  }
-  else
-  {
-    textSurface = TTF_RenderText_Blended_Wrapped(gFont, textureText, textColor, wrapLength);
-  }
-
   if (textSurface == NULL)
   {
     printf("Unable to render text surface! SDL_ttf error: %s\n", TTF_GetError());
@@ -102,6 +90,29 @@ LTexture* LTexture_LoadFromRenderedText(const char* textureText, SDL_Color textC
 
   return out;
 }
+
+LTexture* LTexture_LoadFromRenderedText(const char* textureText, SDL_Color textColor, Uint32 wrapLength)
+{
+  // render text surface
+  SDL_Surface *textSurface = NULL;
+
+  // if wrapLength is 0, then render without auto-wrapping support
+  if (wrapLength == 0)
+  {
+    textSurface = TTF_RenderText_Solid(gFont, textureText, textColor);
+  }
+  else
+  {
+    textSurface = TTF_RenderText_Blended_Wrapped(gFont, textureText, textColor, wrapLength);
+  }
+
+  return create_from_text_surface(textSurface);
+}
+
+LTexture* LTexture_LoadFromRenderedTextBlended(const char* textureText, SDL_Color textColor)
+{
+  return create_from_text_surface(TTF_RenderText_Blended(gFont, textureText, textColor));
+}
 #endif
 
 void LTexture_Render(LTexture* texture, int x, int y)
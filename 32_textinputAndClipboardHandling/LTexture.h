@@ -39,6 +39,12 @@ extern LTexture* LTexture_LoadFromFileWithColorKey(const char* path, Uint8 color
  * Return newly created LTexture as loaded from rendered text.
  */
 extern LTexture* LTexture_LoadFromRenderedText(const char* textureText, SDL_Color textColor, Uint32 wrapLength);
+
+/*
+ * Load texture from rendered text, and color as anti-aliased single line without wrapping.
+ * Return newly created LTexture as loaded from rendered text.
+ */
+extern LTexture* LTexture_LoadFromRenderedTextBlended(const char* textureText, SDL_Color textColor);
 #endif
 
 /*
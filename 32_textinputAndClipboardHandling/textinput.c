@@ -8,7 +8,9 @@
 #include "common.h"
 #include "LTexture.h"
 #include "LTimer.h"
+#include "LTextEdit.h"
 #include <string.h>
+#include <stdlib.h>
 
 #define SCREEN_WIDTH 640
 #define SCREEN_HEIGHT 480
@@ -44,13 +46,10 @@ Uint32 prevTime = 0;
 char fpsText[FPS_BUFFER];
 #endif
 
-// limit 20 characters to be entered (1 for null-terminated character)
-#define TEXT_BUFFER 21
-char text_input[TEXT_BUFFER];
 SDL_Color text_color = { 0, 0, 0, 0xff };
 LTexture* hinttext_texture = NULL;
-LTexture* text_texture = NULL;
-bool render_text = false;
+// text being entered, only edited part is re-rendered
+LTextEdit* text_edit = NULL;
 
 bool init() {
   // initialize sdl
@@ -121,10 +120,14 @@ bool setup()
     return false;
   }
 
-  // set the current string to our holding string
-  strncpy(text_input, "Some text here", 14);
-  // initially render text into texture
-  text_texture = LTexture_LoadFromRenderedText(text_input, text_color, 0);
+  // set the initial text
+  text_edit = LTextEdit_new(text_color, SCREEN_WIDTH-10);
+  if (text_edit == NULL)
+  {
+    SDL_Log("Failed to create text edit");
+    return false;
+  }
+  LTextEdit_append(text_edit, "Some text here");
 
   // enable text input
   SDL_StartTextInput();
@@ -151,32 +154,33 @@ void handleEvent(SDL_Event *e, float deltaTime)
     {
       // if there's some characters already there, then remove it
       case SDLK_BACKSPACE:
-      {
-        size_t str_length = strlen(text_input);
-        if (str_length > 0)
-        {
-          text_input[str_length-1] = '\0';
-          render_text = true;
-        }
+        LTextEdit_backspace(text_edit);
+        break;
+      // new line
+      case SDLK_RETURN:
+        LTextEdit_append(text_edit, "\n");
         break;
-      }
       // copy text already entered into clipboard
       case SDLK_c:
         if (SDL_GetModState() & KMOD_CTRL)
         {
-          SDL_SetClipboardText(text_input);
+          char* text = LTextEdit_get_text(text_edit);
+          if (text != NULL)
+          {
+            SDL_SetClipboardText(text);
+            free(text);
+          }
         }
         break;
-      // handle paste
+      // handle paste, append at the end
       case SDLK_v:
         if (SDL_GetModState() & KMOD_CTRL)
         {
           char* text_onclipboard = SDL_GetClipboardText();
           if (text_onclipboard != NULL)
           {
-            // copy at most TEXT_BUFFER
-            strncpy(text_input, text_onclipboard, TEXT_BUFFER);
-            render_text = true;
+            LTextEdit_append(text_edit, text_onclipboard);
+            SDL_free(text_onclipboard);
           }
         }
         break;
@@ -189,42 +193,15 @@ void handleEvent(SDL_Event *e, float deltaTime)
   {
     // not copy or pasting
     char c_chk = e->text.text[0];
-    // limit number of characters to be appended and ignore copy and paste event as we handled it previously
-    if (strlen(text_input) < TEXT_BUFFER-1 && !((c_chk == 'c' ||
+    // ignore copy and paste event as we handled it previously
+    if (!((c_chk == 'c' ||
         c_chk == 'C' ||
         c_chk == 'v' ||
         c_chk == 'V') && (SDL_GetModState() & KMOD_CTRL)))
     {
-      // append character
-      strncat(text_input, &c_chk, 1);
-      render_text = true;
-    }
-  }
-
-  // if render_text flag is set then we generate texture to render it
-  if (render_text)
-  {
-    if (strlen(text_input) > 0)
-    {
-      // free the previous rendered texture first
-      if (text_texture != NULL)
-      {
-        LTexture_Free(text_texture);
-      }
-      // render a new texture from text
-      text_texture = LTexture_LoadFromRenderedText(text_input, text_color, SCREEN_WIDTH-10);
-    }
-    // text is empty, then render a space as workaround due to SDL_ttf won't render empty string
-    else
-    {
-      // free previous rendered texture first (if any)
-      if (text_texture != NULL)
-      {
-        LTexture_Free(text_texture);
-      }
-
-      // render a new texture from text
-      text_texture = LTexture_LoadFromRenderedText(" ", text_color, 0);
+      // append character, only its run will be re-rendered
+      char c_str[2] = { c_chk, '\0' };
+      LTextEdit_append(text_edit, c_str);
     }
   }
 }
@@ -250,7 +227,9 @@ void render(float deltaTime)
 #endif
 
   LTexture_Render(hinttext_texture, SCREEN_WIDTH/2-hinttext_texture->width/2, 10);
-  LTexture_Render(text_texture, SCREEN_WIDTH/2-text_texture->width/2, 10 + hinttext_texture->height + 10);
+  // render as many last lines as fit on screen
+  int text_y = 10 + hinttext_texture->height + 10;
+  LTextEdit_render(text_edit, 5, text_y, SCREEN_HEIGHT - text_y);
 }
 
 void close()
@@ -266,9 +245,9 @@ void close()
   {
     LTexture_Free(hinttext_texture);
   }
-  if (text_texture != NULL)
+  if (text_edit != NULL)
   {
-    LTexture_Free(text_texture);
+    LTextEdit_free(text_edit);
   }
 
   // disable text input
@@ -0,0 +1,176 @@
+#include "ForceField.h"
+#include <math.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// avoid division by zero for particle right at position of force field
+#define DISTANCE_EPSILON_SQ 1e-4f
+
+static void init(ForceField* ff, ForceFieldType type, float x, float y, float strength, float radius)
+{
+  ff->type = type;
+  ff->x = x;
+  ff->y = y;
+  ff->dir_x = 0.0f;
+  ff->dir_y = 0.0f;
+  ff->strength = strength;
+  ff->radius = radius;
+}
+
+void ForceField_init_point(ForceField* ff, float x, float y, float strength, float radius)
+{
+  init(ff, FORCEFIELD_POINT, x, y, strength, radius);
+}
+
+void ForceField_init_vortex(ForceField* ff, float x, float y, float strength, float radius)
+{
+  init(ff, FORCEFIELD_VORTEX, x, y, strength, radius);
+}
+
+void ForceField_init_wind(ForceField* ff, float x, float y, float dir_x, float dir_y, float strength, float radius)
+{
+  init(ff, FORCEFIELD_WIND, x, y, strength, radius);
+
+  const float len = sqrtf(dir_x*dir_x + dir_y*dir_y);
+  if (len > 0.0f)
+  {
+    ff->dir_x = dir_x / len;
+    ff->dir_y = dir_y / len;
+  }
+}
+
+void ForceField_init_drag(ForceField* ff, float coefficient)
+{
+  init(ff, FORCEFIELD_DRAG, 0.0f, 0.0f, coefficient, 0.0f);
+}
+
+// add force of a single field to particles in [start, count) one by one
+static void evaluate_scalar(const ForceField* ff, const float* px, const float* py, const float* vx, const float* vy, float* out_fx, float* out_fy, int start, int count)
+{
+  const float inv_radius = ff->radius > 0.0f ? 1.0f / ff->radius : 0.0f;
+
+  for (int i=start; i<count; i++)
+  {
+    if (ff->type == FORCEFIELD_DRAG)
+    {
+      out_fx[i] -= ff->strength * vx[i];
+      out_fy[i] -= ff->strength * vy[i];
+      continue;
+    }
+
+    // vector from force field to particle
+    const float rx = px[i] - ff->x;
+    const float ry = py[i] - ff->y;
+    const float d = sqrtf(rx*rx + ry*ry + DISTANCE_EPSILON_SQ);
+
+    // linear falloff, no falloff when radius is 0 as inv_radius is 0
+    float falloff = 1.0f - d * inv_radius;
+    if (falloff < 0.0f) falloff = 0.0f;
+    const float s = ff->strength * falloff;
+
+    switch (ff->type)
+    {
+      case FORCEFIELD_POINT:
+        out_fx[i] -= s * rx / d;
+        out_fy[i] -= s * ry / d;
+        break;
+      case FORCEFIELD_VORTEX:
+        out_fx[i] -= s * ry / d;
+        out_fy[i] += s * rx / d;
+        break;
+      case FORCEFIELD_WIND:
+        out_fx[i] += s * ff->dir_x;
+        out_fy[i] += s * ff->dir_y;
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+#ifdef __SSE2__
+// add force of a single field to particles 4 at a time
+// return number of particles processed, remaining ones are left for evaluate_scalar()
+static int evaluate_sse2(const ForceField* ff, const float* px, const float* py, const float* vx, const float* vy, float* out_fx, float* out_fy, int count)
+{
+  const __m128 strength = _mm_set1_ps(ff->strength);
+  int i = 0;
+
+  if (ff->type == FORCEFIELD_DRAG)
+  {
+    for (; i + 4 <= count; i += 4)
+    {
+      _mm_storeu_ps(out_fx + i, _mm_sub_ps(_mm_loadu_ps(out_fx + i), _mm_mul_ps(strength, _mm_loadu_ps(vx + i))));
+      _mm_storeu_ps(out_fy + i, _mm_sub_ps(_mm_loadu_ps(out_fy + i), _mm_mul_ps(strength, _mm_loadu_ps(vy + i))));
+    }
+    return i;
+  }
+
+  const __m128 fx = _mm_set1_ps(ff->x);
+  const __m128 fy = _mm_set1_ps(ff->y);
+  const __m128 inv_radius = _mm_set1_ps(ff->radius > 0.0f ? 1.0f / ff->radius : 0.0f);
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 eps = _mm_set1_ps(DISTANCE_EPSILON_SQ);
+  const __m128 dir_x = _mm_set1_ps(ff->dir_x);
+  const __m128 dir_y = _mm_set1_ps(ff->dir_y);
+
+  for (; i + 4 <= count; i += 4)
+  {
+    const __m128 rx = _mm_sub_ps(_mm_loadu_ps(px + i), fx);
+    const __m128 ry = _mm_sub_ps(_mm_loadu_ps(py + i), fy);
+    const __m128 d = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(rx, rx), _mm_mul_ps(ry, ry)), eps));
+
+    const __m128 falloff = _mm_max_ps(zero, _mm_sub_ps(one, _mm_mul_ps(d, inv_radius)));
+    const __m128 s = _mm_mul_ps(strength, falloff);
+
+    __m128 out_x = _mm_loadu_ps(out_fx + i);
+    __m128 out_y = _mm_loadu_ps(out_fy + i);
+
+    if (ff->type == FORCEFIELD_WIND)
+    {
+      out_x = _mm_add_ps(out_x, _mm_mul_ps(s, dir_x));
+      out_y = _mm_add_ps(out_y, _mm_mul_ps(s, dir_y));
+    }
+    else
+    {
+      const __m128 s_over_d = _mm_div_ps(s, d);
+      if (ff->type == FORCEFIELD_POINT)
+      {
+        out_x = _mm_sub_ps(out_x, _mm_mul_ps(s_over_d, rx));
+        out_y = _mm_sub_ps(out_y, _mm_mul_ps(s_over_d, ry));
+      }
+      else
+      {
+        out_x = _mm_sub_ps(out_x, _mm_mul_ps(s_over_d, ry));
+        out_y = _mm_add_ps(out_y, _mm_mul_ps(s_over_d, rx));
+      }
+    }
+
+    _mm_storeu_ps(out_fx + i, out_x);
+    _mm_storeu_ps(out_fy + i, out_y);
+  }
+
+  return i;
+}
+#endif
+
+void ForceField_evaluate(const ForceField* fields, int num_fields, const float* px, const float* py, const float* vx, const float* vy, float* out_fx, float* out_fy, int count)
+{
+  for (int i=0; i<count; i++)
+  {
+    out_fx[i] = 0.0f;
+    out_fy[i] = 0.0f;
+  }
+
+  // one field at a time over all particles, so the type is decided once per field
+  for (int f=0; f<num_fields; f++)
+  {
+    int start = 0;
+#ifdef __SSE2__
+    start = evaluate_sse2(fields + f, px, py, vx, vy, out_fx, out_fy, count);
+#endif
+    evaluate_scalar(fields + f, px, py, vx, vy, out_fx, out_fy, start, count);
+  }
+}
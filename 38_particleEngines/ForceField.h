@@ -0,0 +1,105 @@
+#ifndef ForceField_h_
+#define ForceField_h_
+
+#include "SDL.h"
+
+///
+/// Type of ForceField
+///
+typedef enum {
+  /// pull towards (positive strength), or push away from (negative strength) its position
+  FORCEFIELD_POINT,
+  /// swirl around its position, clockwise on screen for positive strength
+  FORCEFIELD_VORTEX,
+  /// push along its direction
+  FORCEFIELD_WIND,
+  /// resist velocity, independent of position
+  FORCEFIELD_DRAG
+} ForceFieldType;
+
+///
+/// ForceField affects motion of particles according to their positions and velocities.
+/// It's evaluated in batch over arrays of particle positions, see ForceField_evaluate().
+///
+/// All positions and velocities are in world space.
+///
+typedef struct {
+  /// type of force field
+  ForceFieldType type;
+
+  /// position of force field, not used by FORCEFIELD_DRAG
+  float x;
+  float y;
+
+  /// normalized direction, used only by FORCEFIELD_WIND
+  float dir_x;
+  float dir_y;
+
+  /// magnitude of force, or drag coefficient for FORCEFIELD_DRAG
+  float strength;
+
+  /// distance from position at which force fades out linearly to zero.
+  /// Set to 0 for no falloff. Not used by FORCEFIELD_DRAG.
+  float radius;
+} ForceField;
+
+///
+/// Initialize ForceField as point attractor (positive strength) or repulsor (negative strength).
+///
+/// \param ff ForceField to initialize
+/// \param x Position x
+/// \param y Position y
+/// \param strength Magnitude of force
+/// \param radius Distance at which force fades out to zero, 0 for no falloff
+///
+extern void ForceField_init_point(ForceField* ff, float x, float y, float strength, float radius);
+
+///
+/// Initialize ForceField as vortex.
+///
+/// \param ff ForceField to initialize
+/// \param x Position x of vortex's center
+/// \param y Position y of vortex's center
+/// \param strength Magnitude of tangential force, positive swirls clockwise on screen
+/// \param radius Distance at which force fades out to zero, 0 for no falloff
+///
+extern void ForceField_init_vortex(ForceField* ff, float x, float y, float strength, float radius);
+
+///
+/// Initialize ForceField as directional wind.
+///
+/// \param ff ForceField to initialize
+/// \param x Position x where wind is strongest
+/// \param y Position y where wind is strongest
+/// \param dir_x Direction x, it will be normalized
+/// \param dir_y Direction y, it will be normalized
+/// \param strength Magnitude of force
+/// \param radius Distance at which force fades out to zero, 0 for no falloff i.e. global wind
+///
+extern void ForceField_init_wind(ForceField* ff, float x, float y, float dir_x, float dir_y, float strength, float radius);
+
+///
+/// Initialize ForceField as drag.
+///
+/// \param ff ForceField to initialize
+/// \param coefficient Drag coefficient, force is -coefficient * velocity
+///
+extern void ForceField_init_drag(ForceField* ff, float coefficient);
+
+///
+/// Evaluate sum of forces from all force fields for arrays of particles.
+/// Particles are processed 4 at a time with SSE2 if available.
+///
+/// \param fields Force fields
+/// \param num_fields Number of force fields
+/// \param px Positions x of particles
+/// \param py Positions y of particles
+/// \param vx Velocities x of particles
+/// \param vy Velocities y of particles
+/// \param out_fx Resulting forces in x direction
+/// \param out_fy Resulting forces in y direction
+/// \param count Number of particles
+///
+extern void ForceField_evaluate(const ForceField* fields, int num_fields, const float* px, const float* py, const float* vx, const float* vy, float* out_fx, float* out_fy, int count);
+
+#endif
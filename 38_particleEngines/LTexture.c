@@ -8,6 +8,24 @@ extern LWindow* gWindow;
 
 static LTexture* LTexture_LoadFromFileColorKeyFlag(const char* path, bool withColorKey, Uint8 colorKeyRed, Uint8 colorKeyGreen, Uint8 colorKeyBlue);
 
+/// number of SDL calls avoided due to setting the same render state
+static Uint32 avoided_state_calls = 0;
+
+/// sync cached render state with what texture currently has
+/// SDL sets blending mode for us when create texture from surface with alpha channel or color key, so query it
+static void init_render_state(LTexture* ltexture)
+{
+  ltexture->color_r = 0xFF;
+  ltexture->color_g = 0xFF;
+  ltexture->color_b = 0xFF;
+  ltexture->alpha = 0xFF;
+  ltexture->blend_mode = SDL_BLENDMODE_NONE;
+
+  SDL_GetTextureColorMod(ltexture->texture, &ltexture->color_r, &ltexture->color_g, &ltexture->color_b);
+  SDL_GetTextureAlphaMod(ltexture->texture, &ltexture->alpha);
+  SDL_GetTextureBlendMode(ltexture->texture, &ltexture->blend_mode);
+}
+
 LTexture* LTexture_LoadFromFile(const char* path)
 {
   return LTexture_LoadFromFileColorKeyFlag(path, false, 0x00, 0xFF, 0xFF);
@@ -51,6 +69,7 @@ LTexture* LTexture_LoadFromFileColorKeyFlag(const char* path, bool withColorKey,
   out->height = loadedSurface->h;
   // set texture to ltexture
   out->texture = newTexture;
+  init_render_state(out);
 
   // free surface, we don't need it anymore
   SDL_FreeSurface(loadedSurface);
@@ -100,6 +119,7 @@ LTexture* LTexture_LoadFromRenderedText_withFont(const char* textureText, TTF_Fo
   out->width = textSurface->w;
   out->height = textSurface->h;
   out->texture = newTexture;
+  init_render_state(out);
 
   // free surface, we don't need it anymore
   SDL_FreeSurface(textSurface);
@@ -146,20 +166,62 @@ void LTexture_ClippedRenderEx(LTexture *ltexture, int x, int y, float scale, SDL
 
 void LTexture_SetColor(LTexture* ltexture, Uint8 red, Uint8 green, Uint8 blue)
 {
+  // skip if nothing changes
+  if (ltexture->color_r == red && ltexture->color_g == green && ltexture->color_b == blue)
+  {
+    avoided_state_calls++;
+    return;
+  }
+
   // set color for modulation
-  SDL_SetTextureColorMod(ltexture->texture, red, green, blue);
+  if (SDL_SetTextureColorMod(ltexture->texture, red, green, blue) == 0)
+  {
+    ltexture->color_r = red;
+    ltexture->color_g = green;
+    ltexture->color_b = blue;
+  }
 }
 
 void LTexture_SetBlendMode(LTexture* ltexture, SDL_BlendMode blending)
 {
+  // skip if nothing changes
+  if (ltexture->blend_mode == blending)
+  {
+    avoided_state_calls++;
+    return;
+  }
+
   // set blending mode
-  SDL_SetTextureBlendMode(ltexture->texture, blending);
+  if (SDL_SetTextureBlendMode(ltexture->texture, blending) == 0)
+  {
+    ltexture->blend_mode = blending;
+  }
 }
 
 void LTexture_SetAlpha(LTexture* ltexture, Uint8 alpha)
 {
+  // skip if nothing changes
+  if (ltexture->alpha == alpha)
+  {
+    avoided_state_calls++;
+    return;
+  }
+
   // modulate texture alpha
-  SDL_SetTextureAlphaMod(ltexture->texture, alpha);
+  if (SDL_SetTextureAlphaMod(ltexture->texture, alpha) == 0)
+  {
+    ltexture->alpha = alpha;
+  }
+}
+
+Uint32 LTexture_GetAvoidedStateCalls()
+{
+  return avoided_state_calls;
+}
+
+void LTexture_ResetAvoidedStateCalls()
+{
+  avoided_state_calls = 0;
 }
 
 void LTexture_Free(LTexture* ltexture)
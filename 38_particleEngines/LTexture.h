@@ -19,6 +19,17 @@ struct LTexture {
 	SDL_Texture* texture;
 	int width;
 	int height;
+
+  /// current color modulation of texture, internally managed to avoid redundant state changes (read-only)
+  Uint8 color_r;
+  Uint8 color_g;
+  Uint8 color_b;
+
+  /// current alpha modulation of texture, internally managed (read-only)
+  Uint8 alpha;
+
+  /// current blending mode of texture, internally managed (read-only)
+  SDL_BlendMode blend_mode;
 };
 typedef struct LTexture LTexture;
 
@@ -70,19 +81,34 @@ extern void LTexture_ClippedRenderEx(LTexture* ltexture, int x, int y, float sca
 
 /*
  * Set color modulation.
+ * It won't call into SDL if color is the same as currently set.
  */
 extern void LTexture_SetColor(LTexture* ltexture, Uint8 red, Uint8 green, Uint8 blue);
 
 /*
  * Set blending mode.
+ * It won't call into SDL if blending mode is the same as currently set.
  */
 extern void LTexture_SetBlendMode(LTexture* ltexture, SDL_BlendMode blending);
 
 /*
  * Set alpha.
+ * It won't call into SDL if alpha is the same as currently set.
  */
 extern void LTexture_SetAlpha(LTexture* ltexture, Uint8 alpha);
 
+/*
+ * Get number of SDL calls avoided by LTexture_SetColor(), LTexture_SetBlendMode(), and LTexture_SetAlpha()
+ * as state to set is the same as current one. It's accumulated across all LTextures.
+ * Use it for profiling.
+ */
+extern Uint32 LTexture_GetAvoidedStateCalls();
+
+/*
+ * Reset number of avoided SDL calls back to 0.
+ */
+extern void LTexture_ResetAvoidedStateCalls();
+
 /*
  * Free LTexture's resource.
  * After this call, texture will be NULL.
@@ -12,6 +12,8 @@ static void init_default(Particle* p)
   p->accy = 0;
   p->frame = 0;
   p->scale = 1.0;
+  p->angle = 0;
+  p->curve_step = 0;
   p->lifetime = 0;
   p->original_lifetime = 0;
   p->is_dead = false;
@@ -55,6 +57,8 @@ void Particle_reset(Particle* p)
   p->accy = 0;
   p->frame = 0;
   p->scale = 1.0;
+  p->angle = 0;
+  p->curve_step = 0;
   p->lifetime = 0;
   p->original_lifetime = 0;
   p->is_dead = false;
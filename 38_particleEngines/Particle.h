@@ -37,6 +37,13 @@ typedef struct {
   /// scale of particle. Use for both x & y axis.
   float scale;
 
+  /// rotation angle of particle in degrees
+  float angle;
+
+  /// (internally used) multiplier to convert elapsed lifetime into index of ParticleGroup's curves.
+  /// It's (PARTICLEGROUP_CURVE_SIZE-1) / original_lifetime.
+  float curve_step;
+
   /// whether this particle is dead
   bool is_dead;
 
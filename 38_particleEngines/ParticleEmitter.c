@@ -1,20 +1,197 @@
 #include "ParticleEmitter.h"
 #include "krr_math.h"
 #include "LTexture.h"
+#include <stdlib.h>
+#include <math.h>
+
+#define DEFAULT_LOD_GRACE_TIME 1.0f
+#define DEFAULT_LOD_INTERVAL 0.25f
+#define DEFAULT_RESTITUTION 0.5f
+
+// number of particles to evaluate force fields for at once
+#define FORCEFIELD_BLOCK 64
+
+// distinguish seeds of emitters created at the same time
+static Uint64 seed_counter = 0;
+
+// spawn particle with random attributes as configured in ParticleGroup
+static void spawn_particle(ParticleEmitter* emitter, Particle* p)
+{
+  ParticleGroup* pg = emitter->particlegroup;
+  krr_rng* rng = &emitter->rng;
+
+  // (we will render this relatively to position of particle emitter)
+  Particle_reset(p);
+  p->x = krr_rng_int2(rng, pg->start_particle_offsetx, pg->end_particle_offsetx);
+  p->y = krr_rng_int2(rng, pg->start_particle_offsety, pg->end_particle_offsety);
+  p->mass = krr_rng_int2(rng, pg->start_particle_mass, pg->end_particle_mass);
+  p->velx = krr_rng_float2(rng, pg->start_particle_velx, pg->end_particle_velx);
+  p->vely = krr_rng_float2(rng, pg->start_particle_vely, pg->end_particle_vely);
+  p->accx = krr_rng_float2(rng, pg->start_particle_accx, pg->end_particle_accx);
+  p->accy = krr_rng_float2(rng, pg->start_particle_accy, pg->end_particle_accy);
+  p->scale = krr_rng_float2(rng, pg->start_particle_scale, pg->end_particle_scale);
+  p->angle = krr_rng_float2(rng, pg->start_particle_angle, pg->end_particle_angle);
+  p->original_lifetime = krr_rng_float2(rng, pg->start_particle_lifetime, pg->end_particle_lifetime);
+  p->lifetime = p->original_lifetime;
+  p->curve_step = p->original_lifetime > 0 ? (PARTICLEGROUP_CURVE_SIZE - 1) / p->original_lifetime : 0;
+}
+
+// grow emitter's local bounds to cover particle
+static inline void track_bounds(ParticleEmitter* emitter, const Particle* p)
+{
+  if (p->x < emitter->local_min_x) emitter->local_min_x = p->x;
+  if (p->x > emitter->local_max_x) emitter->local_max_x = p->x;
+  if (p->y < emitter->local_min_y) emitter->local_min_y = p->y;
+  if (p->y > emitter->local_max_y) emitter->local_max_y = p->y;
+}
+
+// advance particle by t seconds in one step as if it had been updated every step seconds
+// velocity gains acceleration every step, so after n steps
+//   vel' = vel + n*acc
+//   pos' = pos + step * (n*vel + acc*n*(n+1)/2)
+// particle that would have died in the meantime is re-spawned, and advanced by remaining time
+static void advance_particle(ParticleEmitter* emitter, Particle* p, float t, float step)
+{
+  const ParticleGroup* pg = emitter->particlegroup;
+
+  if (p->is_dead || t >= p->lifetime)
+  {
+    t = p->is_dead ? t : t - p->lifetime;
+    spawn_particle(emitter, p);
+    // it could have gone through many generations, only the last one matters
+    if (p->original_lifetime > 0)
+    {
+      t = fmodf(t, p->original_lifetime);
+    }
+  }
+
+  const float n = step > 0 ? t / step : 1.0f;
+  const float sum_n = n * (n + 1) * 0.5f;
+  p->x += step * (n * p->velx + p->accx * sum_n);
+  p->y += step * (n * p->vely + p->accy * sum_n);
+  p->velx += n * p->accx;
+  p->vely += n * p->accy;
+
+  p->anim_timecount += t;
+  if (pg->anim_delay > 0 && p->anim_timecount >= pg->anim_delay)
+  {
+    const int frames = (int)(p->anim_timecount / pg->anim_delay);
+    p->frame = (p->frame + frames) % pg->num_anim_rects;
+    p->anim_timecount -= frames * pg->anim_delay;
+  }
+
+  p->lifetime -= t;
+  if (p->lifetime <= 0)
+  {
+    p->is_dead = true;
+  }
+
+  track_bounds(emitter, p);
+}
+
+// evaluate force fields for block of particles
+// particle is rendered at (emitter->x - p->x, emitter->y - p->y) so both its position
+// and velocity are flipped when going to world space, and forces are flipped back
+static void eval_force_fields(const ParticleEmitter* emitter, const Particle* block, int count, float* force_x, float* force_y)
+{
+  float px[FORCEFIELD_BLOCK];
+  float py[FORCEFIELD_BLOCK];
+  float vx[FORCEFIELD_BLOCK];
+  float vy[FORCEFIELD_BLOCK];
+
+  for (int i=0; i<count; i++)
+  {
+    px[i] = (float)(emitter->x - block[i].x);
+    py[i] = (float)(emitter->y - block[i].y);
+    vx[i] = -block[i].velx;
+    vy[i] = -block[i].vely;
+  }
+
+  ForceField_evaluate(emitter->force_fields, emitter->num_force_fields, px, py, vx, vy, force_x, force_y, count);
+
+  for (int i=0; i<count; i++)
+  {
+    force_x[i] = -force_x[i];
+    force_y[i] = -force_y[i];
+  }
+}
+
+// bounce particle off solid tile it has just moved into
+// particle is rendered at (emitter->x - p->x, emitter->y - p->y), its center is offset by (half_w, half_h)
+static inline void collide_particle(const ParticleEmitter* emitter, const TileSolidMap* map, Particle* p, int old_x, int old_y, int half_w, int half_h)
+{
+  const int cx = emitter->x - p->x + half_w;
+  const int cy = emitter->y - p->y + half_h;
+  if (!TileSolidMap_is_solid(map, cx, cy))
+  {
+    return;
+  }
+
+  const int old_cx = emitter->x - old_x + half_w;
+  const int old_cy = emitter->y - old_y + half_h;
+  // let particle spawned inside solid tile leave it
+  if (TileSolidMap_is_solid(map, old_cx, old_cy))
+  {
+    return;
+  }
+
+  // find which axis of movement got particle into solid tile, it's both when hitting a corner
+  bool hit_x = TileSolidMap_is_solid(map, cx, old_cy);
+  bool hit_y = TileSolidMap_is_solid(map, old_cx, cy);
+  if (!hit_x && !hit_y)
+  {
+    hit_x = true;
+    hit_y = true;
+  }
+
+  if (hit_x)
+  {
+    p->x = old_x;
+    p->velx = -p->velx * emitter->restitution;
+  }
+  if (hit_y)
+  {
+    p->y = old_y;
+    p->vely = -p->vely * emitter->restitution;
+  }
+}
+
+// simulate all particles for t seconds in one analytic step
+static void catch_up(ParticleEmitter* emitter, float t, float step)
+{
+  for (int i=0; i<emitter->num_particles; i++)
+  {
+    advance_particle(emitter, emitter->particles + i, t, step);
+  }
+}
 
 static void init_defaults(ParticleEmitter* emitter)
 {
   emitter->particles = NULL;
   emitter->particlegroup = NULL;
   emitter->num_particles = 0;
+  emitter->owns_particles = false;
   emitter->particle_update = NULL;
   emitter->x = 0;
   emitter->y = 0;
+  emitter->local_min_x = 0;
+  emitter->local_min_y = 0;
+  emitter->local_max_x = 0;
+  emitter->local_max_y = 0;
+  emitter->lod_grace_time = DEFAULT_LOD_GRACE_TIME;
+  emitter->lod_interval = DEFAULT_LOD_INTERVAL;
+  emitter->offscreen_time = 0;
+  emitter->pending_time = 0;
+  emitter->visible = true;
+  emitter->force_fields = NULL;
+  emitter->num_force_fields = 0;
+  emitter->collision_map = NULL;
+  emitter->restitution = DEFAULT_RESTITUTION;
 }
 
 ParticleEmitter* ParticleEmitter_new(ParticleGroup* pg, int num_particles, int x, int y)
 {
-  ParticleEmitter* out = malloc(sizeof(ParticleGroup));
+  ParticleEmitter* out = malloc(sizeof(ParticleEmitter));
   
   // init default
   init_defaults(out);
@@ -31,98 +208,242 @@ ParticleEmitter* ParticleEmitter_new(ParticleGroup* pg, int num_particles, int x
 }
 
 bool ParticleEmitter_init(ParticleEmitter* emitter, ParticleGroup* pg, int num_particles, int x, int y)
+{
+  // create particles according to input num_particles
+  Particle *particles = malloc(sizeof(Particle) * num_particles);
+  if (particles == NULL)
+  {
+    SDL_Log("Failed to allocate memory for particles");
+    return false;
+  }
+
+  if (!ParticleEmitter_init_with_storage(emitter, pg, particles, num_particles, x, y))
+  {
+    free(particles);
+    return false;
+  }
+  emitter->owns_particles = true;
+
+  return true;
+}
+
+bool ParticleEmitter_init_with_storage(ParticleEmitter* emitter, ParticleGroup* pg, Particle* particles, int num_particles, int x, int y)
 {
   // set position to emitter
   emitter->x = x;
   emitter->y = y;
 
-  // create particles according to input num_particles
-  Particle *particles = malloc(sizeof(Particle) * num_particles);
+  // set particlegroup
+  emitter->particlegroup = pg;
+
+  // start bounds from spawning area, they grow as particles move
+  emitter->local_min_x = SDL_min(pg->start_particle_offsetx, pg->end_particle_offsetx);
+  emitter->local_max_x = SDL_max(pg->start_particle_offsetx, pg->end_particle_offsetx);
+  emitter->local_min_y = SDL_min(pg->start_particle_offsety, pg->end_particle_offsety);
+  emitter->local_max_y = SDL_max(pg->start_particle_offsety, pg->end_particle_offsety);
+  emitter->lod_grace_time = DEFAULT_LOD_GRACE_TIME;
+  emitter->lod_interval = DEFAULT_LOD_INTERVAL;
+  emitter->offscreen_time = 0;
+  emitter->pending_time = 0;
+  emitter->visible = true;
+  emitter->force_fields = NULL;
+  emitter->num_force_fields = 0;
+  emitter->collision_map = NULL;
+  emitter->restitution = DEFAULT_RESTITUTION;
+  emitter->particle_update = NULL;
+
+  // seed from time, each emitter gets its own stream
+  krr_rng_seed(&emitter->rng, SDL_GetPerformanceCounter() ^ (++seed_counter * 0x9e3779b97f4a7c15ULL));
+
   // loop through all particles in the pool to initialize its values
   // mostly randomly from what ParticleGroup has been configured
   for (int i=0; i<num_particles; i++)
   {
-    // (we will render this relatively to position of particle emitter)
-    // init particle
-    Particle_init(particles + i, krr_math_rand_int2(pg->start_particle_offsetx, pg->end_particle_offsetx), krr_math_rand_int2(pg->start_particle_offsety, pg->end_particle_offsety));
-    // set its other attributes randomly
-    particles[i].mass = krr_math_rand_int2(pg->start_particle_mass, pg->end_particle_mass);
-    particles[i].velx = krr_math_rand_float2(pg->start_particle_velx, pg->end_particle_velx);
-    particles[i].vely = krr_math_rand_float2(pg->start_particle_vely, pg->end_particle_vely);
-    particles[i].accx = krr_math_rand_float2(pg->start_particle_accx, pg->end_particle_accx);
-    particles[i].accy = krr_math_rand_float2(pg->start_particle_accy, pg->end_particle_accy);
-    particles[i].scale = krr_math_rand_float2(pg->start_particle_scale, pg->end_particle_scale);
-    particles[i].original_lifetime = krr_math_rand_float2(pg->start_particle_lifetime, pg->end_particle_lifetime);
-    particles[i].lifetime = particles[i].lifetime;
+    spawn_particle(emitter, particles + i);
   }
 
   // set particles to emitter
   emitter->particles = particles;
   emitter->num_particles = num_particles;
-
-  // set particlegroup
-  emitter->particlegroup = pg;
+  emitter->owns_particles = false;
 
   return true;
 }
 
+void ParticleEmitter_set_seed(ParticleEmitter* emitter, Uint64 seed)
+{
+  krr_rng_seed(&emitter->rng, seed);
+
+  for (int i=0; i<emitter->num_particles; i++)
+  {
+    spawn_particle(emitter, emitter->particles + i);
+  }
+}
+
 void ParticleEmitter_update(ParticleEmitter* emitter, float delta_time)
 {
   ParticleGroup* pg = emitter->particlegroup;
+  const bool has_fields = emitter->num_force_fields > 0;
 
-  // temporary to hold particle in loop
-  Particle* p = NULL;
-  for(int i=0; i<emitter->num_particles; i++)
+  // collision is checked at center of particle's frame
+  const TileSolidMap* map = emitter->collision_map;
+  const int half_w = pg->num_anim_rects > 0 ? pg->anim_rects[0].w / 2 : 0;
+  const int half_h = pg->num_anim_rects > 0 ? pg->anim_rects[0].h / 2 : 0;
+
+  // forces from force fields of current block of particles, in particle's space
+  float force_x[FORCEFIELD_BLOCK];
+  float force_y[FORCEFIELD_BLOCK];
+
+  // process in blocks so force fields can be evaluated in batch right before integrating
+  for (int base=0; base<emitter->num_particles; base += FORCEFIELD_BLOCK)
   {
-    // get particle
-    p = emitter->particles + i;
+    const int count = SDL_min(FORCEFIELD_BLOCK, emitter->num_particles - base);
+    Particle* block = emitter->particles + base;
 
-    // if particle is dead, then reset and re-random its attributes
-    if (p->is_dead)
+    if (has_fields)
     {
-      Particle_reset(p);
-
-      p->x = krr_math_rand_int2(pg->start_particle_offsetx, pg->end_particle_offsetx);
-      p->y = krr_math_rand_int2(pg->start_particle_offsety, pg->end_particle_offsety);
-      p->mass = krr_math_rand_int2(pg->start_particle_mass, pg->end_particle_mass);
-      p->velx = krr_math_rand_float2(pg->start_particle_velx, pg->end_particle_velx);
-      p->vely = krr_math_rand_float2(pg->start_particle_vely, pg->end_particle_vely);
-      p->accx = krr_math_rand_float2(pg->start_particle_accx, pg->end_particle_accx);
-      p->accy = krr_math_rand_float2(pg->start_particle_accy, pg->end_particle_accy);
-      p->scale = krr_math_rand_float2(pg->start_particle_scale, pg->end_particle_scale);
-      p->original_lifetime = krr_math_rand_float2(pg->start_particle_lifetime, pg->end_particle_lifetime);     
-      p->lifetime = p->original_lifetime;
+      eval_force_fields(emitter, block, count, force_x, force_y);
     }
-    // otherwise, update its position and age
-    else
+
+    // temporary to hold particle in loop
+    Particle* p = NULL;
+    for(int i=0; i<count; i++)
     {
-      // chose to apply delta_time with velocity when additioned to position
-      // to avoid having too small value of acceleration
-      p->velx += p->accx;
-      p->vely += p->accy;
-      p->x += p->velx * delta_time;
-      p->y += p->vely * delta_time;
-
-      // update accumulated time
-      p->anim_timecount += delta_time;
-      if (p->anim_timecount >= pg->anim_delay)
+      // get particle
+      p = block + i;
+
+      // if particle is dead, then reset and re-random its attributes
+      if (p->is_dead)
       {
-        // increment to next frame
-        p->frame = (p->frame+1) % pg->num_anim_rects;
-        // reset animation timecount
-        p->anim_timecount -= pg->anim_delay;
+        spawn_particle(emitter, p);
       }
-
-      // decrease lifetime of particle
-      p->lifetime -= delta_time;
-      if (p->lifetime <= 0)
+      // otherwise, update its position and age
+      else
       {
-        p->is_dead = true;
+        // chose to apply delta_time with velocity when additioned to position
+        // to avoid having too small value of acceleration
+        p->velx += p->accx;
+        p->vely += p->accy;
+        if (has_fields)
+        {
+          const float inv_mass = p->mass != 0 ? 1.0f / p->mass : 1.0f;
+          p->velx += force_x[i] * inv_mass * delta_time;
+          p->vely += force_y[i] * inv_mass * delta_time;
+        }
+        const int old_x = p->x;
+        const int old_y = p->y;
+        p->x += p->velx * delta_time;
+        p->y += p->vely * delta_time;
+        if (map != NULL)
+        {
+          collide_particle(emitter, map, p, old_x, old_y, half_w, half_h);
+        }
+        track_bounds(emitter, p);
+
+        // update accumulated time
+        p->anim_timecount += delta_time;
+        if (p->anim_timecount >= pg->anim_delay)
+        {
+          // increment to next frame
+          p->frame = (p->frame+1) % pg->num_anim_rects;
+          // reset animation timecount
+          p->anim_timecount -= pg->anim_delay;
+        }
+
+        // decrease lifetime of particle
+        p->lifetime -= delta_time;
+        if (p->lifetime <= 0)
+        {
+          p->is_dead = true;
+        }
       }
     }
   }
 }
 
+void ParticleEmitter_set_collision_map(ParticleEmitter* emitter, const TileSolidMap* map, float restitution)
+{
+  emitter->collision_map = map;
+  emitter->restitution = restitution;
+}
+
+void ParticleEmitter_set_force_fields(ParticleEmitter* emitter, const ForceField* fields, int num_fields)
+{
+  emitter->force_fields = fields;
+  emitter->num_force_fields = fields != NULL ? num_fields : 0;
+}
+
+void ParticleEmitter_update_lod(ParticleEmitter* emitter, float delta_time, const SDL_Rect* view)
+{
+  emitter->visible = ParticleEmitter_in_view(emitter, view);
+
+  if (emitter->visible)
+  {
+    emitter->offscreen_time = 0;
+
+    // bring particles to where they would be now before continuing at full rate
+    if (emitter->pending_time > 0)
+    {
+      catch_up(emitter, emitter->pending_time, delta_time);
+      emitter->pending_time = 0;
+    }
+    ParticleEmitter_update(emitter, delta_time);
+    return;
+  }
+
+  // keep full rate for a while, emitter might come back into view soon
+  emitter->offscreen_time += delta_time;
+  if (emitter->offscreen_time <= emitter->lod_grace_time)
+  {
+    ParticleEmitter_update(emitter, delta_time);
+    return;
+  }
+
+  emitter->pending_time += delta_time;
+  if (emitter->pending_time >= emitter->lod_interval)
+  {
+    catch_up(emitter, emitter->pending_time, delta_time);
+    emitter->pending_time = 0;
+  }
+}
+
+void ParticleEmitter_get_bounds(const ParticleEmitter* emitter, SDL_Rect* out)
+{
+  const ParticleGroup* pg = emitter->particlegroup;
+
+  // largest scale a particle can be rendered with
+  float max_curve = 0.0f;
+  for (int i=0; i<PARTICLEGROUP_CURVE_SIZE; i++)
+  {
+    if (pg->scale_curve[i] > max_curve)
+      max_curve = pg->scale_curve[i];
+  }
+  const float max_scale = SDL_max(pg->start_particle_scale, pg->end_particle_scale) * max_curve;
+
+  // particle is rendered at (x - p->x, y - p->y) then scaled and rotated around center of its frame,
+  // (w+h)*scale/2 covers half of its diagonal at any angle
+  int frame_w = 0;
+  int frame_h = 0;
+  if (pg->num_anim_rects > 0)
+  {
+    frame_w = pg->anim_rects[0].w;
+    frame_h = pg->anim_rects[0].h;
+  }
+  const int pad = (int)ceilf((frame_w + frame_h) * max_scale * 0.5f) + 1;
+
+  out->x = emitter->x - emitter->local_max_x + frame_w/2 - pad;
+  out->y = emitter->y - emitter->local_max_y + frame_h/2 - pad;
+  out->w = emitter->local_max_x - emitter->local_min_x + pad*2;
+  out->h = emitter->local_max_y - emitter->local_min_y + pad*2;
+}
+
+bool ParticleEmitter_in_view(const ParticleEmitter* emitter, const SDL_Rect* view)
+{
+  SDL_Rect bounds;
+  ParticleEmitter_get_bounds(emitter, &bounds);
+  return SDL_HasIntersection(&bounds, view);
+}
+
 void ParticleEmitter_apply_force(ParticleEmitter* emitter, int force_x, int force_y)
 {
   Particle* p = NULL;
@@ -151,7 +472,9 @@ void ParticleEmitter_render(ParticleEmitter* emitter)
   Particle* p = NULL;
   // set blend mode
   // as we will render particles's alpha according to its current age
-  SDL_SetTextureBlendMode(texture->texture, SDL_BLENDMODE_BLEND);
+  // note: we don't set it back to normal after rendering, so multiple emitters sharing
+  // the same texture won't flip blend mode back and forth
+  LTexture_SetBlendMode(texture, pg->blend_mode);
 
   for (int i=0; i<emitter->num_particles; i++)
   {
@@ -161,16 +484,23 @@ void ParticleEmitter_render(ParticleEmitter* emitter)
     // if particle not dead yet
     if (!p->is_dead)
     {
-      // set alpha value according to its current age
-      SDL_SetTextureAlphaMod(texture->texture, (int)(p->lifetime / p->original_lifetime * 255));
+      // index into curves according to its current age
+      int c = (int)((p->original_lifetime - p->lifetime) * p->curve_step);
+      if (c >= PARTICLEGROUP_CURVE_SIZE)
+      {
+        c = PARTICLEGROUP_CURVE_SIZE - 1;
+      }
+
+      // set alpha and color from curves
+      // it will be skipped if the same as previous particle
+      const SDL_Color color = pg->color_curve[c];
+      LTexture_SetAlpha(texture, pg->alpha_curve[c]);
+      LTexture_SetColor(texture, color.r, color.g, color.b);
 
       // render current frame
-      LTexture_ClippedRenderEx(texture, emitter->x - p->x, emitter->y - p->y, p->scale, &anim_rects[p->frame], 0, NULL, SDL_FLIP_NONE);
+      LTexture_ClippedRenderEx(texture, emitter->x - p->x, emitter->y - p->y, p->scale * pg->scale_curve[c], &anim_rects[p->frame], p->angle + pg->angle_curve[c], NULL, SDL_FLIP_NONE);
     }
   }
-
-  // set blend mode back to normal
-  SDL_SetTextureBlendMode(texture->texture, SDL_BLENDMODE_NONE);
 }
 
 void ParticleEmitter_free_internals(ParticleEmitter* emitter)
@@ -186,8 +516,12 @@ void ParticleEmitter_free_internals(ParticleEmitter* emitter)
         Particle_free_internals(emitter->particles + i);
       }
       
-      free(emitter->particles);
+      if (emitter->owns_particles)
+      {
+        free(emitter->particles);
+      }
       emitter->particles = NULL;
+      emitter->num_particles = 0;
     }
 
     // reset update function
@@ -3,6 +3,9 @@
 
 #include "Particle.h"
 #include "ParticleGroup.h"
+#include "krr_math.h"
+#include "ForceField.h"
+#include "TileSolidMap.h"
 
 ///
 /// ParticleEmitter is the manager for similar type of Particle
@@ -18,12 +21,56 @@ typedef struct {
   /// (read-only) number of particles
   int num_particles;
 
+  /// (read-only) whether particles memory is owned by emitter and will be freed along with it.
+  /// It's false when particles live in external storage i.e. ParticleSystem's arena.
+  bool owns_particles;
+
   /// position x
   int x;
 
   /// position y
   int y;
 
+  /// (read-only) random number generator used to spawn particles, internally managed.
+  /// Use ParticleEmitter_set_seed() to get reproducible result.
+  krr_rng rng;
+
+  /// (read-only) conservative extent of particles' offsets seen so far, internally managed.
+  /// It's in the same space as Particle's x, y and only grows. Use ParticleEmitter_get_bounds() for world bounds.
+  int local_min_x;
+  int local_min_y;
+  int local_max_x;
+  int local_max_y;
+
+  /// how long in seconds emitter keeps updating at full rate after it goes out of view
+  float lod_grace_time;
+
+  /// interval in seconds between reduced-rate updates once grace time has passed
+  float lod_interval;
+
+  /// (read-only) how long emitter has been out of view, internally managed.
+  float offscreen_time;
+
+  /// (read-only) elapsed time not yet simulated, internally managed.
+  float pending_time;
+
+  /// (read-only) whether emitter was in view as of last ParticleEmitter_update_lod(), internally managed.
+  bool visible;
+
+  /// (read-only) force fields affecting particles, set via ParticleEmitter_set_force_fields()
+  /// (not manage in freeing this attribute)
+  const ForceField* force_fields;
+
+  /// (read-only) number of force fields
+  int num_force_fields;
+
+  /// (read-only) solidity of tiles for particles to bounce off, set via ParticleEmitter_set_collision_map()
+  /// (not manage in freeing this attribute)
+  const TileSolidMap* collision_map;
+
+  /// fraction of velocity kept after bouncing off solid tile
+  float restitution;
+
   /// update for individual Particle (not used)
   /// It will be set to default update function by default which has default behavior.
   /// User can set this to custom update function to achieve different behavior of emitter.
@@ -53,6 +100,29 @@ extern ParticleEmitter* ParticleEmitter_new(ParticleGroup* pg, int num_particles
 ///
 extern bool ParticleEmitter_init(ParticleEmitter* emitter, ParticleGroup* pg, int num_particles, int x, int y);
 
+///
+/// Initialize ParticleEmitter with particles living in external storage.
+/// Emitter won't free such storage, it has to outlive emitter.
+///
+/// \param emitter ParticleEmitter to initialize
+/// \param pg ParticleGroup
+/// \param particles Storage for particles, at least num_particles in size
+/// \param num_particles Number of particles to be managed in emitter
+/// \param x Position x for ParticleEmitter
+/// \param y Position y for ParticleEmitter
+/// \return True if initialize successfully, otherwise return false.
+///
+extern bool ParticleEmitter_init_with_storage(ParticleEmitter* emitter, ParticleGroup* pg, Particle* particles, int num_particles, int x, int y);
+
+///
+/// Re-seed random number generator of ParticleEmitter, and re-spawn all particles from it.
+/// Emitters with the same seed, and the same configuration behave identically.
+///
+/// \param emitter ParticleEmitter to set seed
+/// \param seed Seed number
+///
+extern void ParticleEmitter_set_seed(ParticleEmitter* emitter, Uint64 seed);
+
 ///
 /// Update particles managed by ParticleEmitter
 ///
@@ -61,6 +131,60 @@ extern bool ParticleEmitter_init(ParticleEmitter* emitter, ParticleGroup* pg, in
 ///
 extern void ParticleEmitter_update(ParticleEmitter* emitter, float delta_time);
 
+///
+/// Update particles managed by ParticleEmitter according to whether it's in view.
+///
+/// It updates at full rate when emitter's bounds overlap with view, and keeps doing so
+/// for lod_grace_time seconds after it goes out of view. Afterwards, elapsed time is
+/// accumulated and simulated every lod_interval seconds in one analytic step.
+/// Any time left over is caught up immediately once emitter comes back into view.
+///
+/// \param emitter ParticleEmitter to update
+/// \param delta_time Elapsed time since last frame
+/// \param view View rectangle in world space i.e. Camera's view_rect
+///
+extern void ParticleEmitter_update_lod(ParticleEmitter* emitter, float delta_time, const SDL_Rect* view);
+
+///
+/// Get conservative bounds in world space covering all particles rendered so far.
+/// Bounds are learnt while updating, so they only grow over time.
+///
+/// \param emitter ParticleEmitter
+/// \param out Bounds to be filled
+///
+extern void ParticleEmitter_get_bounds(const ParticleEmitter* emitter, SDL_Rect* out);
+
+///
+/// Whether ParticleEmitter's bounds overlap with view.
+///
+/// \param emitter ParticleEmitter
+/// \param view View rectangle in world space
+/// \return True if overlap, otherwise return false.
+///
+extern bool ParticleEmitter_in_view(const ParticleEmitter* emitter, const SDL_Rect* view);
+
+///
+/// Set tile map for particles to collide with, and bounce off its solid tiles.
+/// Each particle looks up solidity of tile at center of its frame in O(1) while integrating
+/// in ParticleEmitter_update(). Map is in the same world space as emitter's position.
+///
+/// \param emitter ParticleEmitter
+/// \param map TileSolidMap, or NULL to disable collision
+/// \param restitution Fraction of velocity kept after bouncing, 0 stops particle, 1 bounces without loss
+///
+extern void ParticleEmitter_set_collision_map(ParticleEmitter* emitter, const TileSolidMap* map, float restitution);
+
+///
+/// Set force fields to affect particles of ParticleEmitter.
+/// Forces are divided by particle's mass, and applied while integrating in ParticleEmitter_update().
+/// Array is referenced not copied, so it can be modified later e.g. to move fields around, and has to outlive emitter.
+///
+/// \param emitter ParticleEmitter
+/// \param fields Array of force fields, or NULL to remove all
+/// \param num_fields Number of force fields
+///
+extern void ParticleEmitter_set_force_fields(ParticleEmitter* emitter, const ForceField* fields, int num_fields);
+
 ///
 /// Apply force to all particles.
 ///
@@ -1,6 +1,25 @@
 #include "ParticleGroup.h"
 #include <stdlib.h>
 
+// interpolate evenly spaced keys at entry i of lookup table
+// keys are read with stride in number of floats to support multi-component keys
+static float sample_keys(const float* keys, int num_keys, int stride, int i)
+{
+  if (num_keys == 1)
+  {
+    return keys[0];
+  }
+
+  const float pos = (float)i * (num_keys - 1) / (PARTICLEGROUP_CURVE_SIZE - 1);
+  int k = (int)pos;
+  if (k >= num_keys - 1)
+  {
+    k = num_keys - 2;
+  }
+  const float t = pos - k;
+  return keys[k*stride] + (keys[(k+1)*stride] - keys[k*stride]) * t;
+}
+
 static void init_defaults(ParticleGroup* pg)
 {
   pg->texture = NULL;
@@ -8,6 +27,13 @@ static void init_defaults(ParticleGroup* pg)
   pg->num_anim_rects = 0;
   pg->anim_delay = 0;
 
+  ParticleGroup_reset_settings(pg);
+}
+
+void ParticleGroup_reset_settings(ParticleGroup* pg)
+{
+  pg->blend_mode = SDL_BLENDMODE_BLEND;
+
   // default of particle's configuations as follows
   // users are freely to configure them
   pg->start_particle_mass = 1;
@@ -39,6 +65,17 @@ static void init_defaults(ParticleGroup* pg)
 
   pg->start_particle_angle = 0.0;
   pg->end_particle_angle = 0.0;
+
+  for (int i=0; i<PARTICLEGROUP_CURVE_SIZE; i++)
+  {
+    pg->scale_curve[i] = 1.0f;
+    pg->alpha_curve[i] = (Uint8)(255 - i * 255 / (PARTICLEGROUP_CURVE_SIZE - 1));
+    pg->color_curve[i].r = 0xff;
+    pg->color_curve[i].g = 0xff;
+    pg->color_curve[i].b = 0xff;
+    pg->color_curve[i].a = 0xff;
+    pg->angle_curve[i] = 0.0f;
+  }
 }
 
 ParticleGroup* ParticleGroup_new(LTexture* texture, int frame_width, int frame_height, int anim_num_row, int anim_num_column, int anim_speed_fps)
@@ -81,6 +118,113 @@ bool ParticleGroup_init(ParticleGroup* pg, LTexture* texture, int frame_width, i
   return true;
 }
 
+bool ParticleGroup_set_scale_curve(ParticleGroup* pg, const float* keys, int num_keys)
+{
+  if (num_keys < 1)
+  {
+    return false;
+  }
+
+  for (int i=0; i<PARTICLEGROUP_CURVE_SIZE; i++)
+  {
+    pg->scale_curve[i] = sample_keys(keys, num_keys, 1, i);
+  }
+  return true;
+}
+
+bool ParticleGroup_set_alpha_curve(ParticleGroup* pg, const Uint8* keys, int num_keys)
+{
+  if (num_keys < 1)
+  {
+    return false;
+  }
+
+  float* fkeys = malloc(sizeof(float) * num_keys);
+  if (fkeys == NULL)
+  {
+    return false;
+  }
+  for (int k=0; k<num_keys; k++)
+  {
+    fkeys[k] = keys[k];
+  }
+
+  for (int i=0; i<PARTICLEGROUP_CURVE_SIZE; i++)
+  {
+    pg->alpha_curve[i] = (Uint8)(sample_keys(fkeys, num_keys, 1, i) + 0.5f);
+  }
+
+  free(fkeys);
+  return true;
+}
+
+bool ParticleGroup_set_color_curve(ParticleGroup* pg, const SDL_Color* keys, int num_keys)
+{
+  if (num_keys < 1)
+  {
+    return false;
+  }
+
+  // r, g, b interleaved
+  float* fkeys = malloc(sizeof(float) * 3 * num_keys);
+  if (fkeys == NULL)
+  {
+    return false;
+  }
+  for (int k=0; k<num_keys; k++)
+  {
+    fkeys[k*3 + 0] = keys[k].r;
+    fkeys[k*3 + 1] = keys[k].g;
+    fkeys[k*3 + 2] = keys[k].b;
+  }
+
+  for (int i=0; i<PARTICLEGROUP_CURVE_SIZE; i++)
+  {
+    pg->color_curve[i].r = (Uint8)(sample_keys(fkeys + 0, num_keys, 3, i) + 0.5f);
+    pg->color_curve[i].g = (Uint8)(sample_keys(fkeys + 1, num_keys, 3, i) + 0.5f);
+    pg->color_curve[i].b = (Uint8)(sample_keys(fkeys + 2, num_keys, 3, i) + 0.5f);
+    pg->color_curve[i].a = 0xff;
+  }
+
+  free(fkeys);
+  return true;
+}
+
+bool ParticleGroup_set_angle_curve(ParticleGroup* pg, const float* keys, int num_keys)
+{
+  if (num_keys < 1)
+  {
+    return false;
+  }
+
+  for (int i=0; i<PARTICLEGROUP_CURVE_SIZE; i++)
+  {
+    pg->angle_curve[i] = sample_keys(keys, num_keys, 1, i);
+  }
+  return true;
+}
+
+void ParticleGroup_copy_settings(ParticleGroup* dst, const ParticleGroup* src)
+{
+  if (dst == src)
+  {
+    return;
+  }
+
+  // keep what's tied to texture of destination
+  LTexture* texture = dst->texture;
+  SDL_Rect* anim_rects = dst->anim_rects;
+  const int num_anim_rects = dst->num_anim_rects;
+  const float anim_delay = dst->anim_delay;
+
+  *dst = *src;
+
+  dst->texture = texture;
+  dst->anim_rects = anim_rects;
+  dst->num_anim_rects = num_anim_rects;
+  dst->anim_delay = anim_delay;
+}
+
 void ParticleGroup_free_internals(ParticleGroup* pg)
 {
   if (pg->anim_rects != NULL)
@@ -4,6 +4,11 @@
 #include "LTexture.h"
 #include <stdbool.h>
 
+/// number of entries in each curve's lookup table, either 64 or 256 is sensible
+#ifndef PARTICLEGROUP_CURVE_SIZE
+#define PARTICLEGROUP_CURVE_SIZE 64
+#endif
+
 ///
 /// Provide shared information & data for individual particle to operate
 /// This reduces memory usage, and better able to control behavior of
@@ -14,6 +19,11 @@
 /// the start, and when a particle's lifetime has ended. This is to keep performance
 /// in good shape.
 ///
+/// Instead, changes over lifetime are driven by curves (scale, alpha, color, and angle).
+/// Each curve is baked into lookup table of PARTICLEGROUP_CURVE_SIZE entries indexed by
+/// normalized age of particle, so sampling it costs one multiply and one array access.
+/// Set them via ParticleGroup_set_*_curve().
+///
 typedef struct {
   /// (read-only) texture used to render particles
   LTexture* texture;
@@ -27,6 +37,9 @@ typedef struct {
   /// (read-only) managed internally to cache delay value for animation speed
   float anim_delay;
 
+  /// blending mode to render particles with. Default is SDL_BLENDMODE_BLEND.
+  SDL_BlendMode blend_mode;
+
   /// mass of particle
   int start_particle_mass;
   int end_particle_mass;
@@ -66,6 +79,22 @@ typedef struct {
   // start/end of rotation angle of particle
   float start_particle_angle;
   float end_particle_angle;
+
+  /// (read-only) scale multiplier over normalized age of particle
+  /// Default is 1.0 throughout.
+  float scale_curve[PARTICLEGROUP_CURVE_SIZE];
+
+  /// (read-only) alpha over normalized age of particle
+  /// Default is linearly fading out from 255 to 0.
+  Uint8 alpha_curve[PARTICLEGROUP_CURVE_SIZE];
+
+  /// (read-only) color modulation over normalized age of particle, alpha component is not used
+  /// Default is white throughout.
+  SDL_Color color_curve[PARTICLEGROUP_CURVE_SIZE];
+
+  /// (read-only) rotation angle in degrees added on top of particle's angle over normalized age of particle
+  /// Default is 0 throughout.
+  float angle_curve[PARTICLEGROUP_CURVE_SIZE];
 } ParticleGroup;
 
 ///
@@ -83,6 +112,69 @@ extern ParticleGroup* ParticleGroup_new(LTexture* texture, int frame_width, int
 
 extern bool ParticleGroup_init(ParticleGroup* pg, LTexture* texture, int frame_width, int frame_height, int anim_num_row, int anim_num_column, int anim_speed_fps);
 
+///
+/// Set scale curve of ParticleGroup.
+/// Keys are evenly spaced over lifetime of particle i.e. first key at birth, and last key at death,
+/// then linearly interpolated into lookup table.
+///
+/// \param pg ParticleGroup
+/// \param keys Scale multipliers
+/// \param num_keys Number of keys, at least 1
+/// \return True if set successfully, otherwise return false.
+///
+extern bool ParticleGroup_set_scale_curve(ParticleGroup* pg, const float* keys, int num_keys);
+
+///
+/// Set alpha curve of ParticleGroup.
+/// Keys are evenly spaced over lifetime of particle, see ParticleGroup_set_scale_curve().
+///
+/// \param pg ParticleGroup
+/// \param keys Alpha values
+/// \param num_keys Number of keys, at least 1
+/// \return True if set successfully, otherwise return false.
+///
+extern bool ParticleGroup_set_alpha_curve(ParticleGroup* pg, const Uint8* keys, int num_keys);
+
+///
+/// Set color curve of ParticleGroup.
+/// Keys are evenly spaced over lifetime of particle, see ParticleGroup_set_scale_curve().
+///
+/// \param pg ParticleGroup
+/// \param keys Colors, alpha component is ignored
+/// \param num_keys Number of keys, at least 1
+/// \return True if set successfully, otherwise return false.
+///
+extern bool ParticleGroup_set_color_curve(ParticleGroup* pg, const SDL_Color* keys, int num_keys);
+
+///
+/// Set angle curve of ParticleGroup.
+/// Keys are evenly spaced over lifetime of particle, see ParticleGroup_set_scale_curve().
+///
+/// \param pg ParticleGroup
+/// \param keys Angles in degrees
+/// \param num_keys Number of keys, at least 1
+/// \return True if set successfully, otherwise return false.
+///
+extern bool ParticleGroup_set_angle_curve(ParticleGroup* pg, const float* keys, int num_keys);
+
+///
+/// Reset settings of ParticleGroup to defaults.
+/// Settings are everything except texture and animation i.e. blending mode, start/end ranges, and curves.
+///
+/// \param pg ParticleGroup
+///
+extern void ParticleGroup_reset_settings(ParticleGroup* pg);
+
+///
+/// Copy settings from one ParticleGroup to another, see ParticleGroup_reset_settings().
+/// Texture and animation of destination are kept as is, so emitters using it are unaffected
+/// other than picking up new settings.
+///
+/// \param dst Destination ParticleGroup
+/// \param src Source ParticleGroup
+///
+extern void ParticleGroup_copy_settings(ParticleGroup* dst, const ParticleGroup* src);
+
 ///
 /// Free internals of ParticleGroup
 ///
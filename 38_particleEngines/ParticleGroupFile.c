@@ -0,0 +1,611 @@
+#include "ParticleGroupFile.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <limits.h>
+#include <math.h>
+
+#define PACK_MAGIC 0x4B504750 /* 'PGPK' */
+#define PACK_VERSION 1
+
+// longest line accepted in text definition
+#define MAX_LINE 512
+
+typedef enum {
+  VALUE_INT,
+  VALUE_FLOAT
+} ValueType;
+
+// start/end pair of settings, end field always directly follows start field
+typedef struct {
+  const char* key;
+  ValueType type;
+  size_t start_offset;
+  size_t end_offset;
+} RangeSetting;
+
+#define RANGE(key, type, field) { key, type, offsetof(ParticleGroup, start_particle_##field), offsetof(ParticleGroup, end_particle_##field) }
+static const RangeSetting range_settings[] = {
+  RANGE("mass", VALUE_INT, mass),
+  RANGE("offsetx", VALUE_INT, offsetx),
+  RANGE("offsety", VALUE_INT, offsety),
+  RANGE("lifetime", VALUE_FLOAT, lifetime),
+  RANGE("velx", VALUE_FLOAT, velx),
+  RANGE("vely", VALUE_FLOAT, vely),
+  RANGE("accx", VALUE_FLOAT, accx),
+  RANGE("accy", VALUE_FLOAT, accy),
+  RANGE("scale", VALUE_FLOAT, scale),
+  RANGE("angle", VALUE_FLOAT, angle)
+};
+#undef RANGE
+#define NUM_RANGE_SETTINGS (int)(sizeof(range_settings) / sizeof(range_settings[0]))
+
+static const struct {
+  const char* name;
+  SDL_BlendMode mode;
+} blend_modes[] = {
+  { "none", SDL_BLENDMODE_NONE },
+  { "blend", SDL_BLENDMODE_BLEND },
+  { "add", SDL_BLENDMODE_ADD },
+  { "mod", SDL_BLENDMODE_MOD }
+};
+#define NUM_BLEND_MODES (int)(sizeof(blend_modes) / sizeof(blend_modes[0]))
+
+// return reason why start/end pair can't be used for setting, or NULL if it's valid
+// int settings are checked as they'd be truncated
+static const char* check_range(const RangeSetting* s, double start, double end)
+{
+  if (!isfinite(start) || !isfinite(end))
+  {
+    return "values must be finite";
+  }
+  if (s->type == VALUE_INT)
+  {
+    if (start < INT_MIN || start > INT_MAX || end < INT_MIN || end > INT_MAX)
+    {
+      return "values must fit in int";
+    }
+    start = (int)start;
+    end = (int)end;
+    // random range would wrap around
+    if (start > end)
+    {
+      return "start must not be greater than end";
+    }
+  }
+
+  // mass divides forces applied to particles
+  if (strcmp(s->key, "mass") == 0 && start < 1)
+  {
+    return "mass must be at least 1";
+  }
+  if (strcmp(s->key, "lifetime") == 0 && (start <= 0 || end <= 0))
+  {
+    return "lifetime must be positive";
+  }
+  return NULL;
+}
+
+static bool is_known_blend_mode(SDL_BlendMode mode)
+{
+  for (int i=0; i<NUM_BLEND_MODES; i++)
+  {
+    if (blend_modes[i].mode == mode)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool is_space(char c)
+{
+  return c == ' ' || c == '\t' || c == '\r';
+}
+
+// read up to max_values numbers from s, return number of values read or -1 if there's anything else
+static int read_values(const char* s, float* out_values, int max_values)
+{
+  int n = 0;
+  while (true)
+  {
+    while (is_space(*s)) s++;
+    if (*s == '\0')
+    {
+      return n;
+    }
+    if (n >= max_values)
+    {
+      return -1;
+    }
+
+    char* end = NULL;
+    out_values[n] = strtof(s, &end);
+    if (end == s)
+    {
+      return -1;
+    }
+    s = end;
+    n++;
+  }
+}
+
+// parse a single line, it's already stripped of comment and newline
+static bool parse_line(ParticleGroup* pg, char* line, const char* source_name, int line_number)
+{
+  char* key = line;
+  while (is_space(*key)) key++;
+  if (*key == '\0')
+  {
+    return true;
+  }
+
+  char* rest = key;
+  while (*rest != '\0' && !is_space(*rest)) rest++;
+  if (*rest != '\0')
+  {
+    *rest++ = '\0';
+  }
+
+  // blending mode is the only setting with non-numeric value
+  if (strcmp(key, "blend") == 0)
+  {
+    while (is_space(*rest)) rest++;
+    char* end = rest;
+    while (*end != '\0' && !is_space(*end)) end++;
+    *end = '\0';
+
+    for (int i=0; i<NUM_BLEND_MODES; i++)
+    {
+      if (strcmp(rest, blend_modes[i].name) == 0)
+      {
+        pg->blend_mode = blend_modes[i].mode;
+        return true;
+      }
+    }
+    SDL_Log("%s:%d: unknown blending mode '%s'", source_name, line_number, rest);
+    return false;
+  }
+
+  float values[PARTICLEGROUPFILE_MAX_KEYS * 3];
+  const int num_values = read_values(rest, values, sizeof(values) / sizeof(values[0]));
+  if (num_values < 0)
+  {
+    SDL_Log("%s:%d: invalid or too many values for '%s'", source_name, line_number, key);
+    return false;
+  }
+
+  for (int i=0; i<NUM_RANGE_SETTINGS; i++)
+  {
+    const RangeSetting* s = range_settings + i;
+    if (strcmp(key, s->key) != 0)
+    {
+      continue;
+    }
+    if (num_values != 2)
+    {
+      SDL_Log("%s:%d: '%s' needs start and end values", source_name, line_number, key);
+      return false;
+    }
+    const char* error = check_range(s, values[0], values[1]);
+    if (error != NULL)
+    {
+      SDL_Log("%s:%d: invalid '%s', %s", source_name, line_number, key, error);
+      return false;
+    }
+
+    Uint8* base = (Uint8*)pg;
+    if (s->type == VALUE_INT)
+    {
+      *(int*)(base + s->start_offset) = (int)values[0];
+      *(int*)(base + s->end_offset) = (int)values[1];
+    }
+    else
+    {
+      *(float*)(base + s->start_offset) = values[0];
+      *(float*)(base + s->end_offset) = values[1];
+    }
+    return true;
+  }
+
+  // curves
+  const bool is_color = strcmp(key, "color_curve") == 0;
+  const int num_keys = is_color ? num_values / 3 : num_values;
+  if (num_keys < 1 || num_keys > PARTICLEGROUPFILE_MAX_KEYS || (is_color && num_values % 3 != 0))
+  {
+    SDL_Log("%s:%d: '%s' needs between 1 and %d keys", source_name, line_number, key, PARTICLEGROUPFILE_MAX_KEYS);
+    return false;
+  }
+
+  if (strcmp(key, "scale_curve") == 0)
+  {
+    return ParticleGroup_set_scale_curve(pg, values, num_keys);
+  }
+  else if (strcmp(key, "angle_curve") == 0)
+  {
+    return ParticleGroup_set_angle_curve(pg, values, num_keys);
+  }
+  else if (strcmp(key, "alpha_curve") == 0)
+  {
+    Uint8 keys[PARTICLEGROUPFILE_MAX_KEYS];
+    for (int k=0; k<num_keys; k++)
+    {
+      keys[k] = (Uint8)SDL_clamp(values[k], 0.0f, 255.0f);
+    }
+    return ParticleGroup_set_alpha_curve(pg, keys, num_keys);
+  }
+  else if (is_color)
+  {
+    SDL_Color keys[PARTICLEGROUPFILE_MAX_KEYS];
+    for (int k=0; k<num_keys; k++)
+    {
+      keys[k].r = (Uint8)SDL_clamp(values[k*3 + 0], 0.0f, 255.0f);
+      keys[k].g = (Uint8)SDL_clamp(values[k*3 + 1], 0.0f, 255.0f);
+      keys[k].b = (Uint8)SDL_clamp(values[k*3 + 2], 0.0f, 255.0f);
+      keys[k].a = 0xff;
+    }
+    return ParticleGroup_set_color_curve(pg, keys, num_keys);
+  }
+
+  SDL_Log("%s:%d: unknown setting '%s'", source_name, line_number, key);
+  return false;
+}
+
+bool ParticleGroup_parse_settings(ParticleGroup* pg, const char* text, const char* source_name)
+{
+  // parse into a copy, so pg is left untouched on error
+  ParticleGroup parsed = *pg;
+  ParticleGroup_reset_settings(&parsed);
+
+  int line_number = 0;
+  // number of lines with a setting, empty text is most likely a file caught while being written
+  int num_settings = 0;
+  const char* c = text;
+  while (*c != '\0')
+  {
+    line_number++;
+
+    const char* eol = c;
+    while (*eol != '\0' && *eol != '\n') eol++;
+
+    // strip comment
+    const char* end = memchr(c, '#', eol - c);
+    if (end == NULL)
+    {
+      end = eol;
+    }
+
+    if (end - c >= MAX_LINE)
+    {
+      SDL_Log("%s:%d: line is too long", source_name, line_number);
+      return false;
+    }
+    char line[MAX_LINE];
+    memcpy(line, c, end - c);
+    line[end - c] = '\0';
+
+    const char* key = line;
+    while (is_space(*key)) key++;
+    if (*key != '\0')
+    {
+      num_settings++;
+    }
+
+    if (!parse_line(&parsed, line, source_name, line_number))
+    {
+      return false;
+    }
+
+    c = *eol == '\n' ? eol + 1 : eol;
+  }
+
+  if (num_settings == 0)
+  {
+    SDL_Log("%s: no settings", source_name);
+    return false;
+  }
+
+  ParticleGroup_copy_settings(pg, &parsed);
+  return true;
+}
+
+bool ParticleGroup_load_settings(ParticleGroup* pg, const char* path)
+{
+  // SDL_LoadFile() null-terminates loaded data
+  char* text = SDL_LoadFile(path, NULL);
+  if (text == NULL)
+  {
+    SDL_Log("Unable to load %s: %s", path, SDL_GetError());
+    return false;
+  }
+
+  const bool result = ParticleGroup_parse_settings(pg, text, path);
+  SDL_free(text);
+  return result;
+}
+
+// -- packed binary file
+// all values are little-endian, floats are written as their IEEE 754 bits
+//
+// header: magic, version, curve size, number of groups
+// for each group:
+//   name length, name (without null-terminator), blending mode
+//   int ranges (mass, offsetx, offsety) as start/end pairs
+//   float ranges (lifetime, velx, vely, accx, accy, scale, angle) as start/end pairs
+//   curves interleaved per entry as scale, alpha, r, g, b, angle
+
+static Uint32 float_bits(float f)
+{
+  Uint32 u;
+  memcpy(&u, &f, sizeof(u));
+  return u;
+}
+
+static float bits_float(Uint32 u)
+{
+  float f;
+  memcpy(&f, &u, sizeof(f));
+  return f;
+}
+
+bool ParticleGroupPack_write(const char* path, const char* const* names, const ParticleGroup* groups, int num_groups)
+{
+  SDL_RWops* file = SDL_RWFromFile(path, "wb");
+  if (file == NULL)
+  {
+    SDL_Log("Unable to open %s for writing: %s", path, SDL_GetError());
+    return false;
+  }
+
+  // each write returns 1 on success
+  size_t written = 0;
+  size_t expected = 4;
+  written += SDL_WriteLE32(file, PACK_MAGIC);
+  written += SDL_WriteLE32(file, PACK_VERSION);
+  written += SDL_WriteLE32(file, PARTICLEGROUP_CURVE_SIZE);
+  written += SDL_WriteLE32(file, num_groups);
+
+  for (int g=0; g<num_groups; g++)
+  {
+    const ParticleGroup* pg = groups + g;
+    const size_t name_length = strlen(names[g]);
+    if (name_length >= PARTICLEGROUPPACK_NAME_MAX)
+    {
+      SDL_Log("Name of group '%s' is too long", names[g]);
+      SDL_RWclose(file);
+      return false;
+    }
+
+    written += SDL_WriteLE32(file, (Uint32)name_length);
+    written += SDL_RWwrite(file, names[g], name_length, 1) == 1 || name_length == 0;
+    written += SDL_WriteLE32(file, (Uint32)pg->blend_mode);
+    expected += 3;
+
+    for (int i=0; i<NUM_RANGE_SETTINGS; i++)
+    {
+      const RangeSetting* s = range_settings + i;
+      const Uint8* base = (const Uint8*)pg;
+      if (s->type == VALUE_INT)
+      {
+        written += SDL_WriteLE32(file, (Uint32)*(const int*)(base + s->start_offset));
+        written += SDL_WriteLE32(file, (Uint32)*(const int*)(base + s->end_offset));
+      }
+      else
+      {
+        written += SDL_WriteLE32(file, float_bits(*(const float*)(base + s->start_offset)));
+        written += SDL_WriteLE32(file, float_bits(*(const float*)(base + s->end_offset)));
+      }
+      expected += 2;
+    }
+
+    for (int i=0; i<PARTICLEGROUP_CURVE_SIZE; i++)
+    {
+      written += SDL_WriteLE32(file, float_bits(pg->scale_curve[i]));
+      written += SDL_WriteU8(file, pg->alpha_curve[i]);
+      written += SDL_WriteU8(file, pg->color_curve[i].r);
+      written += SDL_WriteU8(file, pg->color_curve[i].g);
+      written += SDL_WriteU8(file, pg->color_curve[i].b);
+      written += SDL_WriteLE32(file, float_bits(pg->angle_curve[i]));
+    }
+    expected += PARTICLEGROUP_CURVE_SIZE * 6;
+  }
+  SDL_RWclose(file);
+
+  if (written != expected)
+  {
+    SDL_Log("Unable to write all groups into %s", path);
+    return false;
+  }
+  return true;
+}
+
+// bounds-checked reading over loaded file
+typedef struct {
+  const Uint8* p;
+  const Uint8* end;
+  bool ok;
+} Reader;
+
+static Uint32 read_le32(Reader* r)
+{
+  if (r->end - r->p < 4)
+  {
+    r->ok = false;
+    return 0;
+  }
+  const Uint32 v = (Uint32)r->p[0] | ((Uint32)r->p[1] << 8) | ((Uint32)r->p[2] << 16) | ((Uint32)r->p[3] << 24);
+  r->p += 4;
+  return v;
+}
+
+static Uint8 read_u8(Reader* r)
+{
+  if (r->p >= r->end)
+  {
+    r->ok = false;
+    return 0;
+  }
+  return *r->p++;
+}
+
+ParticleGroupPack* ParticleGroupPack_load(const char* path)
+{
+  size_t size = 0;
+  Uint8* data = SDL_LoadFile(path, &size);
+  if (data == NULL)
+  {
+    SDL_Log("Unable to load %s: %s", path, SDL_GetError());
+    return NULL;
+  }
+
+  Reader r = { data, data + size, true };
+  const Uint32 magic = read_le32(&r);
+  const Uint32 version = read_le32(&r);
+  const Uint32 curve_size = read_le32(&r);
+  const Uint32 num_groups = read_le32(&r);
+  if (!r.ok || magic != PACK_MAGIC || version != PACK_VERSION)
+  {
+    SDL_Log("Packed file %s has unknown format", path);
+    SDL_free(data);
+    return NULL;
+  }
+  if (curve_size != PARTICLEGROUP_CURVE_SIZE)
+  {
+    SDL_Log("Packed file %s has curve size %u, expected %d", path, curve_size, PARTICLEGROUP_CURVE_SIZE);
+    SDL_free(data);
+    return NULL;
+  }
+  // cheap sanity check against bogus count before allocating, each group takes at least this many bytes
+  const size_t min_group_size = 4 + 4 + NUM_RANGE_SETTINGS * 8 + PARTICLEGROUP_CURVE_SIZE * 10;
+  if (num_groups > size / min_group_size)
+  {
+    SDL_Log("Packed file %s is truncated", path);
+    SDL_free(data);
+    return NULL;
+  }
+
+  ParticleGroupPack* pack = malloc(sizeof(ParticleGroupPack));
+  if (pack == NULL)
+  {
+    SDL_free(data);
+    return NULL;
+  }
+  pack->num_groups = (int)num_groups;
+  pack->names = calloc(num_groups > 0 ? num_groups : 1, sizeof(pack->names[0]));
+  pack->groups = calloc(num_groups > 0 ? num_groups : 1, sizeof(ParticleGroup));
+  if (pack->names == NULL || pack->groups == NULL)
+  {
+    SDL_Log("Unable to allocate memory for ParticleGroupPack");
+    SDL_free(data);
+    ParticleGroupPack_free(pack);
+    return NULL;
+  }
+
+  // settings are checked the same as in text definition, as ParticleGroup relies on them
+  bool valid = true;
+  for (int g=0; g<pack->num_groups && r.ok && valid; g++)
+  {
+    ParticleGroup* pg = pack->groups + g;
+
+    const Uint32 name_length = read_le32(&r);
+    if (name_length >= PARTICLEGROUPPACK_NAME_MAX || (size_t)(r.end - r.p) < name_length)
+    {
+      r.ok = false;
+      break;
+    }
+    memcpy(pack->names[g], r.p, name_length);
+    pack->names[g][name_length] = '\0';
+    r.p += name_length;
+
+    pg->blend_mode = (SDL_BlendMode)read_le32(&r);
+    if (!is_known_blend_mode(pg->blend_mode))
+    {
+      valid = false;
+    }
+
+    for (int i=0; i<NUM_RANGE_SETTINGS; i++)
+    {
+      const RangeSetting* s = range_settings + i;
+      Uint8* base = (Uint8*)pg;
+      const Uint32 start = read_le32(&r);
+      const Uint32 end = read_le32(&r);
+      if (s->type == VALUE_INT)
+      {
+        *(int*)(base + s->start_offset) = (Sint32)start;
+        *(int*)(base + s->end_offset) = (Sint32)end;
+        valid = valid && check_range(s, (Sint32)start, (Sint32)end) == NULL;
+      }
+      else
+      {
+        *(float*)(base + s->start_offset) = bits_float(start);
+        *(float*)(base + s->end_offset) = bits_float(end);
+        valid = valid && check_range(s, bits_float(start), bits_float(end)) == NULL;
+      }
+    }
+
+    for (int i=0; i<PARTICLEGROUP_CURVE_SIZE; i++)
+    {
+      pg->scale_curve[i] = bits_float(read_le32(&r));
+      pg->alpha_curve[i] = read_u8(&r);
+      pg->color_curve[i].r = read_u8(&r);
+      pg->color_curve[i].g = read_u8(&r);
+      pg->color_curve[i].b = read_u8(&r);
+      pg->color_curve[i].a = 0xff;
+      pg->angle_curve[i] = bits_float(read_le32(&r));
+    }
+  }
+  SDL_free(data);
+
+  if (!r.ok)
+  {
+    SDL_Log("Packed file %s is truncated", path);
+    ParticleGroupPack_free(pack);
+    return NULL;
+  }
+  if (!valid)
+  {
+    SDL_Log("Packed file %s has group with invalid settings", path);
+    ParticleGroupPack_free(pack);
+    return NULL;
+  }
+  return pack;
+}
+
+const ParticleGroup* ParticleGroupPack_find(const ParticleGroupPack* pack, const char* name)
+{
+  for (int i=0; i<pack->num_groups; i++)
+  {
+    if (strcmp(pack->names[i], name) == 0)
+    {
+      return pack->groups + i;
+    }
+  }
+  return NULL;
+}
+
+bool ParticleGroupPack_apply(const ParticleGroupPack* pack, const char* name, ParticleGroup* pg)
+{
+  const ParticleGroup* found = ParticleGroupPack_find(pack, name);
+  if (found == NULL)
+  {
+    SDL_Log("No group '%s' in ParticleGroupPack", name);
+    return false;
+  }
+
+  ParticleGroup_copy_settings(pg, found);
+  return true;
+}
+
+void ParticleGroupPack_free(ParticleGroupPack* pack)
+{
+  if (pack == NULL)
+  {
+    return;
+  }
+
+  free(pack->names);
+  pack->names = NULL;
+  free(pack->groups);
+  pack->groups = NULL;
+  free(pack);
+}
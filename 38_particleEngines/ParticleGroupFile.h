@@ -0,0 +1,125 @@
+#ifndef ParticleGroupFile_h_
+#define ParticleGroupFile_h_
+
+#include "ParticleGroup.h"
+#include <stdbool.h>
+
+///
+/// Loading of ParticleGroup's settings (see ParticleGroup_reset_settings()) from file,
+/// so effects can be tuned without recompiling.
+///
+/// Text definition (.pgroup) has one setting per line as key followed by values
+/// separated by spaces. '#' starts a comment until end of line. Settings not mentioned
+/// in file take their defaults.
+///
+///   mass <start> <end>              integers
+///   offsetx <start> <end>           integers
+///   offsety <start> <end>           integers
+///   lifetime <start> <end>          seconds
+///   velx, vely <start> <end>
+///   accx, accy <start> <end>
+///   scale <start> <end>
+///   angle <start> <end>             degrees
+///   blend none|blend|add|mod
+///   scale_curve <key> ...           evenly spaced keys, see ParticleGroup_set_scale_curve()
+///   alpha_curve <key> ...           0-255
+///   color_curve <r> <g> <b> ...     0-255, three values per key
+///   angle_curve <key> ...           degrees
+///
+/// For release builds, definitions are parsed once into a packed binary file (.pgpack) via
+/// pgpack tool which holds settings of all groups with curves already baked, see ParticleGroupPack.
+///
+
+/// maximum number of keys per curve in text definition
+#define PARTICLEGROUPFILE_MAX_KEYS 32
+
+/// maximum length of group's name in ParticleGroupPack including null-terminator
+#define PARTICLEGROUPPACK_NAME_MAX 64
+
+///
+/// Parse text definition into settings of ParticleGroup.
+/// ParticleGroup is modified only if the whole text is parsed successfully.
+/// Text without any setting (empty, or only comments) fails, as it's usually a file being written.
+/// Ranges are validated: int ranges can't be reversed, mass is at least 1, and lifetime is positive.
+///
+/// \param pg ParticleGroup to receive settings
+/// \param text Null-terminated text definition
+/// \param source_name Name used to report errors, usually path to file
+/// \return True if parsed successfully, otherwise return false.
+///
+extern bool ParticleGroup_parse_settings(ParticleGroup* pg, const char* text, const char* source_name);
+
+///
+/// Load text definition from file into settings of ParticleGroup.
+/// ParticleGroup is modified only if the whole file is parsed successfully, so it's safe to call
+/// on ParticleGroup in use by emitters.
+///
+/// \param pg ParticleGroup to receive settings
+/// \param path Path to text definition file
+/// \return True if loaded successfully, otherwise return false.
+///
+extern bool ParticleGroup_load_settings(ParticleGroup* pg, const char* path);
+
+///
+/// Settings of multiple ParticleGroups loaded from packed binary file.
+/// Groups hold settings only, their texture and animation are not set.
+///
+typedef struct {
+  /// (read-only) number of groups
+  int num_groups;
+
+  /// (read-only) names of groups
+  char (*names)[PARTICLEGROUPPACK_NAME_MAX];
+
+  /// (read-only) settings of groups
+  ParticleGroup* groups;
+} ParticleGroupPack;
+
+///
+/// Write settings of ParticleGroups into packed binary file.
+///
+/// \param path Path to output file
+/// \param names Names of groups, each shorter than PARTICLEGROUPPACK_NAME_MAX
+/// \param groups ParticleGroups to take settings from
+/// \param num_groups Number of groups
+/// \return True if written successfully, otherwise return false.
+///
+extern bool ParticleGroupPack_write(const char* path, const char* const* names, const ParticleGroup* groups, int num_groups);
+
+///
+/// Load packed binary file.
+/// It fails if the file was packed with different PARTICLEGROUP_CURVE_SIZE,
+/// or any group has settings which wouldn't pass ParticleGroup_parse_settings().
+///
+/// \param path Path to packed binary file
+/// \return Newly created ParticleGroupPack, or NULL if failed.
+///
+extern ParticleGroupPack* ParticleGroupPack_load(const char* path);
+
+///
+/// Find group by name.
+///
+/// \param pack ParticleGroupPack
+/// \param name Name of group
+/// \return Settings of group, or NULL if not found.
+///
+extern const ParticleGroup* ParticleGroupPack_find(const ParticleGroupPack* pack, const char* name);
+
+///
+/// Copy settings of named group into ParticleGroup, see ParticleGroup_copy_settings().
+///
+/// \param pack ParticleGroupPack
+/// \param name Name of group
+/// \param pg ParticleGroup to receive settings
+/// \return True if group is found, otherwise return false.
+///
+extern bool ParticleGroupPack_apply(const ParticleGroupPack* pack, const char* name, ParticleGroup* pg);
+
+///
+/// Free ParticleGroupPack.
+///
+/// \param pack ParticleGroupPack to be freed
+///
+extern void ParticleGroupPack_free(ParticleGroupPack* pack);
+
+#endif
@@ -0,0 +1,213 @@
+#ifdef __linux__
+// for inotify and read()
+#define _DEFAULT_SOURCE
+#endif
+
+#include "ParticleGroupWatcher.h"
+#include "ParticleGroupFile.h"
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+// return modification time of file, or 0 if it doesn't exist
+static time_t modification_time(const char* path)
+{
+  struct stat st;
+  if (stat(path, &st) != 0)
+  {
+    return 0;
+  }
+  return st.st_mtime;
+}
+
+// return pointer to file name part of path
+static const char* file_name(const char* path)
+{
+  const char* name = path;
+  for (const char* c = path; *c != '\0'; c++)
+  {
+    if (*c == '/' || *c == '\\')
+    {
+      name = c + 1;
+    }
+  }
+  return name;
+}
+
+ParticleGroupWatcher* ParticleGroupWatcher_new(void)
+{
+  ParticleGroupWatcher* out = malloc(sizeof(ParticleGroupWatcher));
+  if (out == NULL)
+  {
+    return NULL;
+  }
+
+  out->num_watches = 0;
+  out->last_poll_time = SDL_GetTicks();
+  out->fd = -1;
+#ifdef __linux__
+  out->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (out->fd < 0)
+  {
+    SDL_Log("Warning: inotify is not available, falling back to polling modification time");
+  }
+#endif
+
+  return out;
+}
+
+bool ParticleGroupWatcher_add(ParticleGroupWatcher* watcher, const char* path, ParticleGroup* pg)
+{
+  if (watcher->num_watches >= PARTICLEGROUPWATCHER_MAX_FILES)
+  {
+    SDL_Log("Unable to watch %s, already watching %d files", path, PARTICLEGROUPWATCHER_MAX_FILES);
+    return false;
+  }
+  if (strlen(path) >= PARTICLEGROUPWATCHER_PATH_MAX)
+  {
+    SDL_Log("Unable to watch %s, path is too long", path);
+    return false;
+  }
+
+  ParticleGroupWatch* w = watcher->watches + watcher->num_watches;
+  strcpy(w->path, path);
+  w->pg = pg;
+  w->wd = -1;
+  w->mtime = modification_time(path);
+
+#ifdef __linux__
+  if (watcher->fd >= 0)
+  {
+    // watch directory rather than file itself, as file is replaced when editors save via rename
+    char dir[PARTICLEGROUPWATCHER_PATH_MAX];
+    const size_t dir_length = file_name(path) - path;
+    if (dir_length == 0)
+    {
+      strcpy(dir, ".");
+    }
+    else
+    {
+      memcpy(dir, path, dir_length);
+      dir[dir_length] = '\0';
+    }
+
+    // watching the same directory again returns the same descriptor
+    // in-place saves end with close, and rename-on-save with move; creation isn't watched as it comes before content
+    w->wd = inotify_add_watch(watcher->fd, dir, IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (w->wd < 0)
+    {
+      SDL_Log("Warning: unable to watch %s via inotify, polling it instead", path);
+    }
+  }
+#endif
+
+  watcher->num_watches++;
+  return ParticleGroup_load_settings(pg, path);
+}
+
+// reload watch, return whether it's successfully loaded
+static bool reload(ParticleGroupWatch* w)
+{
+  if (!ParticleGroup_load_settings(w->pg, w->path))
+  {
+    // keep previous settings until file is fixed
+    SDL_Log("Failed to reload %s, keeping previous settings", w->path);
+    return false;
+  }
+  SDL_Log("Reloaded %s", w->path);
+  return true;
+}
+
+int ParticleGroupWatcher_poll(ParticleGroupWatcher* watcher)
+{
+  // several events often arrive for a single save, so mark first then reload each file at most once
+  bool changed[PARTICLEGROUPWATCHER_MAX_FILES] = { false };
+
+#ifdef __linux__
+  if (watcher->fd >= 0)
+  {
+    // buffer aligned for inotify_event as recommended in inotify(7)
+    char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    ssize_t len;
+    while ((len = read(watcher->fd, buffer, sizeof(buffer))) > 0)
+    {
+      for (char* p = buffer; p < buffer + len; )
+      {
+        const struct inotify_event* event = (const struct inotify_event*)p;
+        if (event->len > 0)
+        {
+          for (int i=0; i<watcher->num_watches; i++)
+          {
+            const ParticleGroupWatch* w = watcher->watches + i;
+            if (w->wd == event->wd && strcmp(file_name(w->path), event->name) == 0)
+            {
+              changed[i] = true;
+            }
+          }
+        }
+        p += sizeof(struct inotify_event) + event->len;
+      }
+    }
+    if (len < 0 && errno != EAGAIN)
+    {
+      SDL_Log("Warning: failed to read inotify events");
+    }
+  }
+#endif
+
+  // poll files not watched via inotify
+  const Uint32 now = SDL_GetTicks();
+  if (now - watcher->last_poll_time >= PARTICLEGROUPWATCHER_POLL_INTERVAL)
+  {
+    watcher->last_poll_time = now;
+    for (int i=0; i<watcher->num_watches; i++)
+    {
+      ParticleGroupWatch* w = watcher->watches + i;
+      if (w->wd >= 0)
+      {
+        continue;
+      }
+
+      const time_t mtime = modification_time(w->path);
+      if (mtime != 0 && mtime != w->mtime)
+      {
+        w->mtime = mtime;
+        changed[i] = true;
+      }
+    }
+  }
+
+  int num_reloaded = 0;
+  for (int i=0; i<watcher->num_watches; i++)
+  {
+    if (changed[i] && reload(watcher->watches + i))
+    {
+      num_reloaded++;
+    }
+  }
+  return num_reloaded;
+}
+
+void ParticleGroupWatcher_free(ParticleGroupWatcher* watcher)
+{
+  if (watcher == NULL)
+  {
+    return;
+  }
+
+#ifdef __linux__
+  // closing inotify instance removes all of its watches
+  if (watcher->fd >= 0)
+  {
+    close(watcher->fd);
+    watcher->fd = -1;
+  }
+#endif
+
+  free(watcher);
+}
@@ -0,0 +1,88 @@
+#ifndef ParticleGroupWatcher_h_
+#define ParticleGroupWatcher_h_
+
+#include "ParticleGroup.h"
+#include <stdbool.h>
+#include <time.h>
+
+/// maximum number of files a watcher can watch
+#define PARTICLEGROUPWATCHER_MAX_FILES 16
+
+/// maximum length of watched file's path including null-terminator
+#define PARTICLEGROUPWATCHER_PATH_MAX 256
+
+/// how often modification time is checked when inotify is not available, in milliseconds
+#define PARTICLEGROUPWATCHER_POLL_INTERVAL 500
+
+typedef struct {
+  /// path to text definition file
+  char path[PARTICLEGROUPWATCHER_PATH_MAX];
+
+  /// ParticleGroup to reload settings into
+  ParticleGroup* pg;
+
+  /// inotify watch descriptor of file's directory, -1 if not watched via inotify
+  int wd;
+
+  /// last seen modification time, used when polling
+  time_t mtime;
+} ParticleGroupWatch;
+
+///
+/// Watch text definition files of ParticleGroups, and reload their settings in place when
+/// files change. Emitters keep pointing to the same ParticleGroup, so nothing is reallocated,
+/// already spawned particles keep their attributes while new ones pick up new settings.
+///
+/// On Linux it's notified via inotify on directories of watched files, so it also catches
+/// editors that save by writing a new file then renaming it over the old one. Elsewhere, or if
+/// inotify is not available, it falls back to checking modification time of files periodically.
+///
+typedef struct {
+  /// (read-only) watched files
+  ParticleGroupWatch watches[PARTICLEGROUPWATCHER_MAX_FILES];
+
+  /// (read-only) number of watched files
+  int num_watches;
+
+  /// (read-only) inotify instance, -1 if falling back to polling
+  int fd;
+
+  /// (read-only) time in milliseconds of last polling
+  Uint32 last_poll_time;
+} ParticleGroupWatcher;
+
+///
+/// Create a new ParticleGroupWatcher.
+///
+/// \return Newly created ParticleGroupWatcher, or NULL if failed.
+///
+extern ParticleGroupWatcher* ParticleGroupWatcher_new(void);
+
+///
+/// Load settings of ParticleGroup from text definition file, then watch the file for changes.
+/// File is watched even if it fails to load, so it will be loaded once it's fixed.
+///
+/// \param watcher ParticleGroupWatcher
+/// \param path Path to text definition file
+/// \param pg ParticleGroup to load settings into, it must outlive the watch
+/// \return True if settings are loaded and file is watched, otherwise return false.
+///
+extern bool ParticleGroupWatcher_add(ParticleGroupWatcher* watcher, const char* path, ParticleGroup* pg);
+
+///
+/// Reload settings of ParticleGroups whose files have changed since last call.
+/// It never blocks, call it once per frame before updating emitters.
+///
+/// \param watcher ParticleGroupWatcher
+/// \return Number of ParticleGroups reloaded successfully.
+///
+extern int ParticleGroupWatcher_poll(ParticleGroupWatcher* watcher);
+
+///
+/// Free ParticleGroupWatcher. Watched ParticleGroups are not freed.
+///
+/// \param watcher ParticleGroupWatcher to be freed
+///
+extern void ParticleGroupWatcher_free(ParticleGroupWatcher* watcher);
+
+#endif
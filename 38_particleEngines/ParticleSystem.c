@@ -0,0 +1,309 @@
+#include "ParticleSystem.h"
+#include "LTexture.h"
+#include "LWindow.h"
+#include "common.h"
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#define DEG_TO_RAD 0.017453292519943295f
+
+// whether emitter a should be rendered before emitter b
+static bool render_before(const ParticleEmitter* a, const ParticleEmitter* b)
+{
+  const LTexture* ta = a->particlegroup->texture;
+  const LTexture* tb = b->particlegroup->texture;
+  if (ta != tb)
+  {
+    return (uintptr_t)ta < (uintptr_t)tb;
+  }
+  return a->particlegroup->blend_mode < b->particlegroup->blend_mode;
+}
+
+// sort render order by texture then blending mode
+// insertion sort keeps order of insertion within the same batch, and it's
+// cheap as order rarely changes from frame to frame
+static void sort_render_order(ParticleSystem* ps)
+{
+  for (int i=0; i<ps->num_emitters; i++)
+  {
+    ps->render_order[i] = i;
+  }
+
+  for (int i=1; i<ps->num_emitters; i++)
+  {
+    int idx = ps->render_order[i];
+    int j = i - 1;
+    while (j >= 0 && render_before(ps->emitters[idx], ps->emitters[ps->render_order[j]]))
+    {
+      ps->render_order[j+1] = ps->render_order[j];
+      j--;
+    }
+    ps->render_order[j+1] = idx;
+  }
+}
+
+// write quads of all live particles of emitter into vertices, offset by (-view_x, -view_y)
+// follows the same placement as LTexture_ClippedRenderEx()
+// return number of vertices written
+static int build_quads(const ParticleEmitter* emitter, int view_x, int view_y, SDL_Vertex* out)
+{
+  const ParticleGroup* pg = emitter->particlegroup;
+  const float inv_w = 1.0f / pg->texture->width;
+  const float inv_h = 1.0f / pg->texture->height;
+  int n = 0;
+
+  for (int i=0; i<emitter->num_particles; i++)
+  {
+    const Particle* p = emitter->particles + i;
+    if (p->is_dead)
+    {
+      continue;
+    }
+
+    // index into curves according to its current age
+    int c = (int)((p->original_lifetime - p->lifetime) * p->curve_step);
+    if (c >= PARTICLEGROUP_CURVE_SIZE)
+    {
+      c = PARTICLEGROUP_CURVE_SIZE - 1;
+    }
+
+    const SDL_Rect* clip = &pg->anim_rects[p->frame];
+    const float scale = p->scale * pg->scale_curve[c];
+    const float angle = (p->angle + pg->angle_curve[c]) * DEG_TO_RAD;
+
+    // rotate around center of destination rectangle
+    const float cx = emitter->x - view_x - p->x + clip->w/2;
+    const float cy = emitter->y - view_y - p->y + clip->h/2;
+    const float hw = clip->w * scale * 0.5f;
+    const float hh = clip->h * scale * 0.5f;
+    float ca = 1.0f;
+    float sa = 0.0f;
+    if (angle != 0.0f)
+    {
+      ca = cosf(angle);
+      sa = sinf(angle);
+    }
+    const float ax = hw * ca, ay = hw * sa;
+    const float bx = -hh * sa, by = hh * ca;
+
+    SDL_Color color = pg->color_curve[c];
+    color.a = pg->alpha_curve[c];
+
+    const float u0 = clip->x * inv_w;
+    const float v0 = clip->y * inv_h;
+    const float u1 = (clip->x + clip->w) * inv_w;
+    const float v1 = (clip->y + clip->h) * inv_h;
+
+    // top-left, top-right, bottom-left, bottom-right
+    out[n++] = (SDL_Vertex){ {cx - ax - bx, cy - ay - by}, color, {u0, v0} };
+    out[n++] = (SDL_Vertex){ {cx + ax - bx, cy + ay - by}, color, {u1, v0} };
+    out[n++] = (SDL_Vertex){ {cx - ax + bx, cy - ay + by}, color, {u0, v1} };
+    out[n++] = (SDL_Vertex){ {cx + ax + bx, cy + ay + by}, color, {u1, v1} };
+  }
+
+  return n;
+}
+
+ParticleSystem* ParticleSystem_new(int max_emitters, int max_particles)
+{
+  ParticleSystem* out = malloc(sizeof(ParticleSystem));
+  if (out == NULL)
+  {
+    return NULL;
+  }
+
+  out->emitters = malloc(sizeof(ParticleEmitter*) * max_emitters);
+  out->render_order = malloc(sizeof(int) * max_emitters);
+  out->arena = malloc(sizeof(Particle) * max_particles);
+  out->vertices = malloc(sizeof(SDL_Vertex) * 4 * max_particles);
+  out->indices = malloc(sizeof(int) * 6 * max_particles);
+  out->num_emitters = 0;
+  out->max_emitters = max_emitters;
+  out->arena_used = 0;
+  out->arena_capacity = max_particles;
+  out->camera = NULL;
+  out->num_batches = 0;
+  out->num_culled = 0;
+
+  if (out->emitters == NULL || out->render_order == NULL || out->arena == NULL ||
+      out->vertices == NULL || out->indices == NULL)
+  {
+    SDL_Log("Unable to allocate memory for ParticleSystem");
+    ParticleSystem_free(out);
+    return NULL;
+  }
+
+  // quad pattern never changes, fill it in once
+  for (int q=0; q<max_particles; q++)
+  {
+    int* idx = out->indices + q*6;
+    idx[0] = q*4 + 0;
+    idx[1] = q*4 + 1;
+    idx[2] = q*4 + 2;
+    idx[3] = q*4 + 2;
+    idx[4] = q*4 + 1;
+    idx[5] = q*4 + 3;
+  }
+
+  return out;
+}
+
+ParticleEmitter* ParticleSystem_add_emitter(ParticleSystem* ps, ParticleGroup* pg, int num_particles, int x, int y)
+{
+  if (ps->num_emitters >= ps->max_emitters || ps->arena_used + num_particles > ps->arena_capacity)
+  {
+    SDL_Log("Not enough room in ParticleSystem for %d more particles", num_particles);
+    return NULL;
+  }
+
+  ParticleEmitter* emitter = malloc(sizeof(ParticleEmitter));
+  if (emitter == NULL)
+  {
+    return NULL;
+  }
+
+  if (!ParticleEmitter_init_with_storage(emitter, pg, ps->arena + ps->arena_used, num_particles, x, y))
+  {
+    free(emitter);
+    return NULL;
+  }
+
+  ps->arena_used += num_particles;
+  ps->emitters[ps->num_emitters++] = emitter;
+
+  return emitter;
+}
+
+void ParticleSystem_remove_emitter(ParticleSystem* ps, ParticleEmitter* emitter)
+{
+  int index = -1;
+  for (int i=0; i<ps->num_emitters; i++)
+  {
+    if (ps->emitters[i] == emitter)
+    {
+      index = i;
+      break;
+    }
+  }
+  if (index < 0)
+  {
+    return;
+  }
+
+  // close the gap in arena, and point emitters after it to their moved particles
+  const int removed = emitter->num_particles;
+  Particle* gap = emitter->particles;
+  // free its particles while they're still in place, gap is overwritten by particles of next emitters
+  ParticleEmitter_free_internals(emitter);
+  const int tail = (int)(ps->arena + ps->arena_used - (gap + removed));
+  memmove(gap, gap + removed, sizeof(Particle) * tail);
+  ps->arena_used -= removed;
+
+  for (int i=index+1; i<ps->num_emitters; i++)
+  {
+    ps->emitters[i]->particles -= removed;
+    ps->emitters[i-1] = ps->emitters[i];
+  }
+  ps->num_emitters--;
+
+  ParticleEmitter_free(emitter);
+}
+
+void ParticleSystem_update(ParticleSystem* ps, float delta_time)
+{
+  // emitters are in arena order, so this walks arena from start to end
+  if (ps->camera != NULL)
+  {
+    for (int i=0; i<ps->num_emitters; i++)
+    {
+      ParticleEmitter_update_lod(ps->emitters[i], delta_time, &ps->camera->view_rect);
+    }
+  }
+  else
+  {
+    for (int i=0; i<ps->num_emitters; i++)
+    {
+      ParticleEmitter_update(ps->emitters[i], delta_time);
+    }
+  }
+}
+
+void ParticleSystem_render(ParticleSystem* ps)
+{
+  ps->num_batches = 0;
+  ps->num_culled = 0;
+  if (ps->num_emitters == 0)
+  {
+    return;
+  }
+
+  const SDL_Rect* view = ps->camera != NULL ? &ps->camera->view_rect : NULL;
+  const int view_x = view != NULL ? view->x : 0;
+  const int view_y = view != NULL ? view->y : 0;
+
+  sort_render_order(ps);
+
+  int first = 0;
+  while (first < ps->num_emitters)
+  {
+    // gather all emitters sharing texture and blending mode
+    const ParticleEmitter* head = ps->emitters[ps->render_order[first]];
+    int last = first + 1;
+    while (last < ps->num_emitters &&
+           !render_before(head, ps->emitters[ps->render_order[last]]))
+    {
+      last++;
+    }
+
+    int num_vertices = 0;
+    for (int i=first; i<last; i++)
+    {
+      const ParticleEmitter* emitter = ps->emitters[ps->render_order[i]];
+      if (view != NULL && !ParticleEmitter_in_view(emitter, view))
+      {
+        ps->num_culled++;
+        continue;
+      }
+      num_vertices += build_quads(emitter, view_x, view_y, ps->vertices + num_vertices);
+    }
+
+    if (num_vertices > 0)
+    {
+      // alpha and color are in vertices, make sure texture's modulation doesn't stack on top
+      LTexture* texture = head->particlegroup->texture;
+      LTexture_SetBlendMode(texture, head->particlegroup->blend_mode);
+      LTexture_SetColor(texture, 0xff, 0xff, 0xff);
+      LTexture_SetAlpha(texture, 0xff);
+      SDL_RenderGeometry(gWindow->renderer, texture->texture, ps->vertices, num_vertices, ps->indices, num_vertices / 4 * 6);
+      ps->num_batches++;
+    }
+
+    first = last;
+  }
+}
+
+void ParticleSystem_free(ParticleSystem* ps)
+{
+  if (ps == NULL)
+  {
+    return;
+  }
+
+  if (ps->emitters != NULL)
+  {
+    for (int i=0; i<ps->num_emitters; i++)
+    {
+      ParticleEmitter_free(ps->emitters[i]);
+    }
+    free(ps->emitters);
+    ps->emitters = NULL;
+  }
+
+  free(ps->render_order);
+  free(ps->arena);
+  free(ps->vertices);
+  free(ps->indices);
+  free(ps);
+}
@@ -0,0 +1,116 @@
+#ifndef ParticleSystem_h_
+#define ParticleSystem_h_
+
+#include "SDL.h"
+#include <stdbool.h>
+#include "ParticleEmitter.h"
+#include "Camera.h"
+
+///
+/// ParticleSystem owns many ParticleEmitters whose particles live in one shared arena.
+///
+/// Updating walks the arena from start to end in one pass.
+/// Rendering sorts emitters by their ParticleGroup's texture and blending mode, then submits all
+/// particles of emitters sharing the same texture and blending mode with one SDL_RenderGeometry() call.
+/// Per-particle alpha and color are carried in vertex colors, so texture's state is touched only
+/// once per batch instead of once per particle.
+///
+/// If camera is set, emitters are placed relative to its view, emitters out of view are skipped
+/// when rendering, and updated at reduced rate via ParticleEmitter_update_lod().
+///
+/// Requires SDL 2.0.18 or newer.
+///
+typedef struct {
+  /// (read-only) emitters in the same order as their particles in arena
+  ParticleEmitter** emitters;
+
+  /// (read-only) number of emitters
+  int num_emitters;
+
+  /// (read-only) maximum number of emitters
+  int max_emitters;
+
+  /// (read-only) shared storage for particles of all emitters
+  Particle* arena;
+
+  /// (read-only) number of particles used in arena
+  int arena_used;
+
+  /// (read-only) capacity of arena in number of particles
+  int arena_capacity;
+
+  /// (internally used) indices into emitters sorted for rendering
+  int* render_order;
+
+  /// (internally used) vertices for up to arena_capacity quads
+  SDL_Vertex* vertices;
+
+  /// (internally used) indices for arena_capacity quads, filled once
+  int* indices;
+
+  /// camera to cull emitters against, and render relative to.
+  /// Set to NULL (default) to treat screen as world, and update everything at full rate.
+  /// (not manage in freeing this attribute)
+  Camera* camera;
+
+  /// (read-only) number of SDL_RenderGeometry() calls made in last ParticleSystem_render()
+  int num_batches;
+
+  /// (read-only) number of emitters skipped as out of view in last ParticleSystem_render()
+  int num_culled;
+} ParticleSystem;
+
+///
+/// Create a new ParticleSystem.
+///
+/// \param max_emitters Maximum number of emitters at the same time
+/// \param max_particles Capacity of shared arena, in number of particles across all emitters
+/// \return Newly created ParticleSystem, or NULL if failed.
+///
+extern ParticleSystem* ParticleSystem_new(int max_emitters, int max_particles);
+
+///
+/// Create a new ParticleEmitter whose particles live in ParticleSystem's arena.
+/// ParticleSystem manages its memory, don't free it directly.
+///
+/// \param ps ParticleSystem
+/// \param pg ParticleGroup
+/// \param num_particles Number of particles to be managed in emitter
+/// \param x Position x for ParticleEmitter
+/// \param y Position y for ParticleEmitter
+/// \return Newly created ParticleEmitter, or NULL if there is not enough room left.
+///
+extern ParticleEmitter* ParticleSystem_add_emitter(ParticleSystem* ps, ParticleGroup* pg, int num_particles, int x, int y);
+
+///
+/// Remove and free ParticleEmitter from ParticleSystem.
+/// Particles of emitters added afterwards are moved down to keep arena compact.
+///
+/// \param ps ParticleSystem
+/// \param emitter ParticleEmitter previously returned from ParticleSystem_add_emitter()
+///
+extern void ParticleSystem_remove_emitter(ParticleSystem* ps, ParticleEmitter* emitter);
+
+///
+/// Update all emitters in one pass over arena.
+///
+/// \param ps ParticleSystem
+/// \param delta_time Elapsed time since last frame
+///
+extern void ParticleSystem_update(ParticleSystem* ps, float delta_time);
+
+///
+/// Render all emitters, one batch per texture and blending mode.
+///
+/// \param ps ParticleSystem
+///
+extern void ParticleSystem_render(ParticleSystem* ps);
+
+///
+/// Free ParticleSystem along with all of its emitters.
+///
+/// \param ps ParticleSystem to be freed
+///
+extern void ParticleSystem_free(ParticleSystem* ps);
+
+#endif
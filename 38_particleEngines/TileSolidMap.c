@@ -0,0 +1,151 @@
+#include "TileSolidMap.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+TileSolidMap* TileSolidMap_new(int num_columns, int num_rows, int tile_width, int tile_height)
+{
+  if (num_columns <= 0 || num_rows <= 0 || tile_width <= 0 || tile_height <= 0)
+  {
+    SDL_Log("Invalid dimension for TileSolidMap");
+    return NULL;
+  }
+
+  TileSolidMap* out = malloc(sizeof(TileSolidMap));
+  if (out == NULL)
+  {
+    return NULL;
+  }
+
+  const int num_words = (num_columns * num_rows + 31) / 32;
+  out->bits = calloc(num_words, sizeof(Uint32));
+  if (out->bits == NULL)
+  {
+    SDL_Log("Unable to allocate memory for TileSolidMap");
+    free(out);
+    return NULL;
+  }
+
+  out->num_columns = num_columns;
+  out->num_rows = num_rows;
+  out->tile_width = tile_width;
+  out->tile_height = tile_height;
+  out->width = num_columns * tile_width;
+  out->height = num_rows * tile_height;
+
+  return out;
+}
+
+TileSolidMap* TileSolidMap_load(const char* path, int tile_width, int tile_height, int solid_type_min, int solid_type_max)
+{
+  FILE* fp = fopen(path, "rb");
+  if (fp == NULL)
+  {
+    SDL_Log("Error attempting to read %s file", path);
+    return NULL;
+  }
+
+  fseek(fp, 0, SEEK_END);
+  long file_size = ftell(fp);
+  fseek(fp, 0, SEEK_SET);
+
+  char* buffer = malloc(file_size + 1);
+  if (buffer == NULL || (file_size > 0 && fread(buffer, file_size, 1, fp) != 1))
+  {
+    SDL_Log("Error reading %s file", path);
+    free(buffer);
+    fclose(fp);
+    return NULL;
+  }
+  buffer[file_size] = '\0';
+  fclose(fp);
+
+  // count columns from the first line, and rows from non-empty lines
+  int num_columns = 0;
+  int num_rows = 0;
+  bool in_number = false;
+  bool line_has_number = false;
+  for (const char* c = buffer; ; c++)
+  {
+    if (*c >= '0' && *c <= '9')
+    {
+      if (!in_number && num_rows == 0)
+      {
+        num_columns++;
+      }
+      in_number = true;
+      line_has_number = true;
+    }
+    else
+    {
+      in_number = false;
+      if (*c == '\n' || *c == '\0')
+      {
+        if (line_has_number)
+        {
+          num_rows++;
+        }
+        line_has_number = false;
+      }
+    }
+
+    if (*c == '\0')
+    {
+      break;
+    }
+  }
+
+  TileSolidMap* map = TileSolidMap_new(num_columns, num_rows, tile_width, tile_height);
+  if (map == NULL)
+  {
+    free(buffer);
+    return NULL;
+  }
+
+  // fill in solidity in row-major order
+  char* c = buffer;
+  for (int i=0; i<num_columns * num_rows; i++)
+  {
+    char* end = NULL;
+    const long type = strtol(c, &end, 10);
+    if (end == c)
+    {
+      SDL_Log("Map file %s has fewer tiles than expected", path);
+      break;
+    }
+    c = end;
+
+    if (type >= solid_type_min && type <= solid_type_max)
+    {
+      TileSolidMap_set_solid(map, i % num_columns, i / num_columns, true);
+    }
+  }
+
+  free(buffer);
+  return map;
+}
+
+void TileSolidMap_set_solid(TileSolidMap* map, int col, int row, bool solid)
+{
+  if ((unsigned)col >= (unsigned)map->num_columns || (unsigned)row >= (unsigned)map->num_rows)
+  {
+    return;
+  }
+
+  const unsigned bit = (unsigned)(row * map->num_columns + col);
+  if (solid)
+    map->bits[bit >> 5] |= 1u << (bit & 31);
+  else
+    map->bits[bit >> 5] &= ~(1u << (bit & 31));
+}
+
+void TileSolidMap_free(TileSolidMap* map)
+{
+  if (map == NULL)
+  {
+    return;
+  }
+
+  free(map->bits);
+  map->bits = NULL;
+  free(map);
+}
@@ -0,0 +1,112 @@
+#ifndef TileSolidMap_h_
+#define TileSolidMap_h_
+
+#include "SDL.h"
+#include <stdbool.h>
+
+///
+/// Solidity of tiles in a tile map, one bit per tile in row-major order.
+/// It answers whether a world position is inside a solid tile in O(1).
+///
+/// Map's top-left corner is at world origin. Anything outside of map is not solid.
+///
+typedef struct {
+  /// (read-only) solidity bits, bit (row * num_columns + col) is set for solid tile
+  Uint32* bits;
+
+  /// (read-only) number of columns
+  int num_columns;
+
+  /// (read-only) number of rows
+  int num_rows;
+
+  /// (read-only) tile width in pixels
+  int tile_width;
+
+  /// (read-only) tile height in pixels
+  int tile_height;
+
+  /// (read-only) map width in pixels
+  int width;
+
+  /// (read-only) map height in pixels
+  int height;
+} TileSolidMap;
+
+///
+/// Create a new TileSolidMap with all tiles not solid.
+///
+/// \param num_columns Number of columns
+/// \param num_rows Number of rows
+/// \param tile_width Tile width in pixels
+/// \param tile_height Tile height in pixels
+/// \return Newly created TileSolidMap, or NULL if failed.
+///
+extern TileSolidMap* TileSolidMap_new(int num_columns, int num_rows, int tile_width, int tile_height);
+
+///
+/// Create a new TileSolidMap from map file in the same format as 39 - Tiling's lazy.map
+/// i.e. tile types as integers separated by spaces, one row per line.
+///
+/// \param path Path to map file
+/// \param tile_width Tile width in pixels
+/// \param tile_height Tile height in pixels
+/// \param solid_type_min Minimum tile type to be treated as solid
+/// \param solid_type_max Maximum tile type to be treated as solid
+/// \return Newly created TileSolidMap, or NULL if failed.
+///
+extern TileSolidMap* TileSolidMap_load(const char* path, int tile_width, int tile_height, int solid_type_min, int solid_type_max);
+
+///
+/// Set solidity of a tile.
+///
+/// \param map TileSolidMap
+/// \param col Column of tile
+/// \param row Row of tile
+/// \param solid Whether tile is solid
+///
+extern void TileSolidMap_set_solid(TileSolidMap* map, int col, int row, bool solid);
+
+///
+/// Whether tile at column and row is solid.
+///
+/// \param map TileSolidMap
+/// \param col Column of tile
+/// \param row Row of tile
+/// \return True if solid, otherwise return false. Tiles outside of map are not solid.
+///
+static inline bool TileSolidMap_is_solid_tile(const TileSolidMap* map, int col, int row)
+{
+  if ((unsigned)col >= (unsigned)map->num_columns || (unsigned)row >= (unsigned)map->num_rows)
+  {
+    return false;
+  }
+  const unsigned bit = (unsigned)(row * map->num_columns + col);
+  return (map->bits[bit >> 5] >> (bit & 31)) & 1;
+}
+
+///
+/// Whether world position is inside a solid tile.
+///
+/// \param map TileSolidMap
+/// \param x Position x in world space
+/// \param y Position y in world space
+/// \return True if solid, otherwise return false. Positions outside of map are not solid.
+///
+static inline bool TileSolidMap_is_solid(const TileSolidMap* map, int x, int y)
+{
+  if ((unsigned)x >= (unsigned)map->width || (unsigned)y >= (unsigned)map->height)
+  {
+    return false;
+  }
+  return TileSolidMap_is_solid_tile(map, x / map->tile_width, y / map->tile_height);
+}
+
+///
+/// Free TileSolidMap.
+///
+/// \param map TileSolidMap to be freed
+///
+extern void TileSolidMap_free(TileSolidMap* map);
+
+#endif
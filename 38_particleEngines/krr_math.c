@@ -1,6 +1,142 @@
 #include "krr_math.h"
 #include <stdlib.h>
 #include <time.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// xoshiro128+ jump polynomials, see http://prng.di.unimi.it/xoshiro128plus.c
+// equivalent to 2^64 calls to krr_rng_next()
+static const Uint32 RNG_JUMP[4] = { 0x8764000b, 0xf542d2d3, 0x6fa035c3, 0x77f2db5b };
+// equivalent to 2^96 calls to krr_rng_next()
+static const Uint32 RNG_LONG_JUMP[4] = { 0xb523952e, 0x0b6f099f, 0xccf5a0ef, 0x1c580662 };
+
+// 2^-24, to convert upper 24 bits of random number into float in [0, 1)
+#define RNG_FLOAT_UNIT (1.0f / 16777216.0f)
+
+// number of raw numbers generated at once on stack by krr_rng_fill_float2(), multiple of 4
+#define RNG_FILL_CHUNK 256
+
+static inline Uint32 rotl(Uint32 x, int k)
+{
+  return (x << k) | (x >> (32 - k));
+}
+
+static inline Uint32 xoshiro_next(Uint32 s[4])
+{
+  const Uint32 result = s[0] + s[3];
+  const Uint32 t = s[1] << 9;
+
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = rotl(s[3], 11);
+
+  return result;
+}
+
+static void xoshiro_jump(Uint32 s[4], const Uint32 poly[4])
+{
+  Uint32 j[4] = {0, 0, 0, 0};
+
+  for (int i=0; i<4; i++)
+  {
+    for (int b=0; b<32; b++)
+    {
+      if (poly[i] & (1u << b))
+      {
+        j[0] ^= s[0];
+        j[1] ^= s[1];
+        j[2] ^= s[2];
+        j[3] ^= s[3];
+      }
+      xoshiro_next(s);
+    }
+  }
+
+  s[0] = j[0];
+  s[1] = j[1];
+  s[2] = j[2];
+  s[3] = j[3];
+}
+
+static Uint64 splitmix64(Uint64* x)
+{
+  Uint64 z = (*x += 0x9e3779b97f4a7c15ULL);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+// map 32-bit random number x into [0, range) via Lemire's multiply-shift,
+// rejecting with scalar state to get rid of bias
+static inline Uint32 rng_bounded(krr_rng* rng, Uint32 x, Uint32 range)
+{
+  Uint64 m = (Uint64)x * range;
+  Uint32 l = (Uint32)m;
+  if (l < range)
+  {
+    const Uint32 threshold = -range % range;
+    while (l < threshold)
+    {
+      m = (Uint64)xoshiro_next(rng->s) * range;
+      l = (Uint32)m;
+    }
+  }
+  return (Uint32)(m >> 32);
+}
+
+// fill with raw 32-bit numbers from 4 lanes, in order of lane 0, 1, 2, 3 then next step
+static void rng_fill_u32(krr_rng* rng, Uint32* out, int count)
+{
+  int i = 0;
+
+#ifdef __SSE2__
+  __m128i s0 = _mm_loadu_si128((const __m128i*)rng->lanes[0]);
+  __m128i s1 = _mm_loadu_si128((const __m128i*)rng->lanes[1]);
+  __m128i s2 = _mm_loadu_si128((const __m128i*)rng->lanes[2]);
+  __m128i s3 = _mm_loadu_si128((const __m128i*)rng->lanes[3]);
+
+  for (; i + 4 <= count; i += 4)
+  {
+    _mm_storeu_si128((__m128i*)(out + i), _mm_add_epi32(s0, s3));
+
+    const __m128i t = _mm_slli_epi32(s1, 9);
+    s2 = _mm_xor_si128(s2, s0);
+    s3 = _mm_xor_si128(s3, s1);
+    s1 = _mm_xor_si128(s1, s2);
+    s0 = _mm_xor_si128(s0, s3);
+    s2 = _mm_xor_si128(s2, t);
+    s3 = _mm_or_si128(_mm_slli_epi32(s3, 11), _mm_srli_epi32(s3, 21));
+  }
+
+  _mm_storeu_si128((__m128i*)rng->lanes[0], s0);
+  _mm_storeu_si128((__m128i*)rng->lanes[1], s1);
+  _mm_storeu_si128((__m128i*)rng->lanes[2], s2);
+  _mm_storeu_si128((__m128i*)rng->lanes[3], s3);
+#endif
+
+  // scalar path steps lanes exactly the same way as SIMD path, it also handles the tail
+  // by stepping all 4 lanes and dropping unused numbers
+  for (; i < count; i += 4)
+  {
+    for (int lane=0; lane<4; lane++)
+    {
+      Uint32 s[4] = { rng->lanes[0][lane], rng->lanes[1][lane], rng->lanes[2][lane], rng->lanes[3][lane] };
+      const Uint32 r = xoshiro_next(s);
+      if (i + lane < count)
+      {
+        out[i + lane] = r;
+      }
+      rng->lanes[0][lane] = s[0];
+      rng->lanes[1][lane] = s[1];
+      rng->lanes[2][lane] = s[2];
+      rng->lanes[3][lane] = s[3];
+    }
+  }
+}
 
 float krr_math_lerp(float a, float b, float t)
 {
@@ -41,6 +177,118 @@ float krr_math_rand_float2(float min, float max)
   return (float)((double)rand() / ((double)RAND_MAX + 1) * (max+1-min) + min);
 }
 
+void krr_rng_seed(krr_rng* rng, Uint64 seed)
+{
+  // expand seed into full state, splitmix64 never gives all-zero state from consecutive outputs
+  const Uint64 a = splitmix64(&seed);
+  const Uint64 b = splitmix64(&seed);
+  rng->s[0] = (Uint32)a;
+  rng->s[1] = (Uint32)(a >> 32);
+  rng->s[2] = (Uint32)b;
+  rng->s[3] = (Uint32)(b >> 32);
+
+  // lanes for bulk generation are 2^96 steps apart from scalar state and from each other,
+  // so they never overlap with streams derived via krr_rng_jump()
+  Uint32 s[4] = { rng->s[0], rng->s[1], rng->s[2], rng->s[3] };
+  for (int lane=0; lane<4; lane++)
+  {
+    xoshiro_jump(s, RNG_LONG_JUMP);
+    for (int w=0; w<4; w++)
+    {
+      rng->lanes[w][lane] = s[w];
+    }
+  }
+}
+
+void krr_rng_jump(krr_rng* rng)
+{
+  xoshiro_jump(rng->s, RNG_JUMP);
+
+  for (int lane=0; lane<4; lane++)
+  {
+    Uint32 s[4] = { rng->lanes[0][lane], rng->lanes[1][lane], rng->lanes[2][lane], rng->lanes[3][lane] };
+    xoshiro_jump(s, RNG_JUMP);
+    for (int w=0; w<4; w++)
+    {
+      rng->lanes[w][lane] = s[w];
+    }
+  }
+}
+
+Uint32 krr_rng_next(krr_rng* rng)
+{
+  return xoshiro_next(rng->s);
+}
+
+int krr_rng_int2(krr_rng* rng, int min, int max)
+{
+  const Uint32 range = (Uint32)max - (Uint32)min + 1;
+  // full 32-bit range
+  if (range == 0)
+  {
+    return (int)xoshiro_next(rng->s);
+  }
+  return (int)((Uint32)min + rng_bounded(rng, xoshiro_next(rng->s), range));
+}
+
+float krr_rng_float(krr_rng* rng)
+{
+  // lowest bits of xoshiro128+ are weak, so use upper 24 bits which fit exactly in float
+  return (xoshiro_next(rng->s) >> 8) * RNG_FLOAT_UNIT;
+}
+
+float krr_rng_float2(krr_rng* rng, float min, float max)
+{
+  return min + (max - min) * krr_rng_float(rng);
+}
+
+void krr_rng_fill_int2(krr_rng* rng, int* out, int count, int min, int max)
+{
+  rng_fill_u32(rng, (Uint32*)out, count);
+
+  const Uint32 range = (Uint32)max - (Uint32)min + 1;
+  if (range == 0)
+  {
+    return;
+  }
+  for (int i=0; i<count; i++)
+  {
+    out[i] = (int)((Uint32)min + rng_bounded(rng, (Uint32)out[i], range));
+  }
+}
+
+void krr_rng_fill_float2(krr_rng* rng, float* out, int count, float min, float max)
+{
+  const float scale = (max - min) * RNG_FLOAT_UNIT;
+  Uint32 raw[RNG_FILL_CHUNK];
+
+  // generate raw numbers chunk by chunk into stack buffer, then convert them
+  for (int base=0; base<count; base += RNG_FILL_CHUNK)
+  {
+    const int n = count - base < RNG_FILL_CHUNK ? count - base : RNG_FILL_CHUNK;
+    float* dst = out + base;
+    int i = 0;
+
+    rng_fill_u32(rng, raw, n);
+
+#ifdef __SSE2__
+    const __m128 vscale = _mm_set1_ps(scale);
+    const __m128 vmin = _mm_set1_ps(min);
+    for (; i + 4 <= n; i += 4)
+    {
+      // upper 24 bits are positive as signed integer, so signed conversion is exact
+      const __m128i r = _mm_srli_epi32(_mm_loadu_si128((const __m128i*)(raw + i)), 8);
+      _mm_storeu_ps(dst + i, _mm_add_ps(vmin, _mm_mul_ps(_mm_cvtepi32_ps(r), vscale)));
+    }
+#endif
+
+    for (; i < n; i++)
+    {
+      dst[i] = min + (float)(raw[i] >> 8) * scale;
+    }
+  }
+}
+
 bool krr_math_checkCollision(SDL_Rect a, SDL_Rect b, int* deltaCollisionX, int* deltaCollisionY)
 {
   if (a.x + a.w > b.x &&
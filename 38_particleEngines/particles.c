@@ -11,6 +11,11 @@
 #include "LTexture.h"
 #include "LTimer.h"
 #include "ParticleEmitter.h"
+#include "ParticleSystem.h"
+#include "Camera.h"
+#include "TileSolidMap.h"
+#include "ParticleGroupFile.h"
+#include "ParticleGroupWatcher.h"
 
 #define SCREEN_WIDTH 640
 #define SCREEN_HEIGHT 480
@@ -26,13 +31,42 @@
 #define TARGET_FPS 60
 #define FIXED_DELTATIME 1.0f / TARGET_FPS
 
+// capacity of particle system
+#define MAX_EMITTERS 128
+#define MAX_PARTICLES 8192
+
+// each click spawns explosion made out of multiple small emitters
+#define EXPLOSION_EMITTERS 20
+#define EXPLOSION_PARTICLES 20
+#define EXPLOSION_RADIUS 40
+
+// how far camera moves per key press
+#define CAMERA_STEP 200
+
+// force fields demo, toggled via F key
+#define NUM_FORCE_FIELDS 3
+
+// tile map from 39 - Tiling for particles to collide with, toggled via M key
+#define MAP_PATH "../39_tiling/lazy.map"
+#define MAP_TILE_WIDTH 80
+#define MAP_TILE_HEIGHT 80
+// tile types of walls as in 39 - Tiling
+#define MAP_SOLID_TYPE_MIN 3
+#define MAP_SOLID_TYPE_MAX 11
+#define MAP_RESTITUTION 0.6f
+
+// settings of particle group, tuned without recompiling
+// define PARTICLEGROUP_PACK to load them from packed file instead (see `make release`)
+#define PARTICLEGROUP_PATH "fire.pgroup"
+#define PARTICLEGROUP_PACK_PATH "particles.pgpack"
+
 // -- functions
 static bool init();
 static bool setup();
 static void update(float deltaTime);
 void handleEvent(SDL_Event *e, float deltaTime);
 void render(float deltaTime);
-void close();
+static void close();
 
 // -- variables
 bool quit = false;
@@ -49,7 +83,14 @@ char fpsText[FPS_BUFFER];
 SDL_Rect content_rect = { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT };
 LTexture* particles_texture = NULL;
 ParticleGroup* particle_group = NULL;
+ParticleGroupWatcher* particle_group_watcher = NULL;
 ParticleEmitter* particle_emitter = NULL;
+ParticleSystem* particle_system = NULL;
+Camera camera;
+ForceField force_fields[NUM_FORCE_FIELDS];
+bool force_fields_enabled = false;
+TileSolidMap* solid_map = NULL;
+bool collision_enabled = false;
 
 bool init() {
   // initialize sdl
@@ -120,32 +161,64 @@ bool setup()
 
   // particle group
   particle_group = ParticleGroup_new(particles_texture, particles_texture->width/4, particles_texture->height, 1, 3, 10);
+  if (particle_group == NULL)
+  {
+    SDL_Log("Failed to create particle_group");
+    return false;
+  }
 
-  particle_group->start_particle_mass = 5;
-  particle_group->end_particle_mass = 10;
-
-  particle_group->start_particle_offsetx = -30;
-  particle_group->end_particle_offsetx = 30;
-
-  particle_group->start_particle_offsety = 2;
-  particle_group->end_particle_offsety = 3;
+#ifdef PARTICLEGROUP_PACK
+  // settings of all groups are parsed at build time into packed file, see pgpack
+  ParticleGroupPack* pack = ParticleGroupPack_load(PARTICLEGROUP_PACK_PATH);
+  if (pack == NULL || !ParticleGroupPack_apply(pack, "fire", particle_group))
+  {
+    SDL_Log("Failed to load particle_group's settings from %s", PARTICLEGROUP_PACK_PATH);
+    ParticleGroupPack_free(pack);
+    return false;
+  }
+  ParticleGroupPack_free(pack);
+#else
+  // settings are loaded from text definition, and reloaded whenever it's saved
+  particle_group_watcher = ParticleGroupWatcher_new();
+  if (particle_group_watcher == NULL)
+  {
+    SDL_Log("Failed to create particle_group_watcher");
+    return false;
+  }
+  if (!ParticleGroupWatcher_add(particle_group_watcher, PARTICLEGROUP_PATH, particle_group))
+  {
+    SDL_Log("Failed to load particle_group's settings from %s", PARTICLEGROUP_PATH);
+    return false;
+  }
+#endif
 
-  particle_group->start_particle_accx = -5;
-  particle_group->end_particle_accx = 20;
+  // particle system owns all emitters
+  particle_system = ParticleSystem_new(MAX_EMITTERS, MAX_PARTICLES);
+  if (particle_system == NULL)
+  {
+    SDL_Log("Failed to create particle_system");
+    return false;
+  }
 
-  particle_group->start_particle_scale = 1.5;
-  particle_group->end_particle_scale = 3.0;
+  // swirl particles around a point above emitter while wind gently blows to the right,
+  // drag keeps them from speeding up endlessly
+  ForceField_init_vortex(&force_fields[0], SCREEN_WIDTH/2, SCREEN_HEIGHT/2, 4000, 250);
+  ForceField_init_wind(&force_fields[1], SCREEN_WIDTH/2, SCREEN_HEIGHT/2, 1, 0, 600, 0);
+  ForceField_init_drag(&force_fields[2], 2.0f);
 
-  particle_group->start_particle_lifetime = 0.5;
-  particle_group->end_particle_lifetime = 1;
-  if (particle_group == NULL)
+  // solid tiles to collide with, it's optional
+  solid_map = TileSolidMap_load(MAP_PATH, MAP_TILE_WIDTH, MAP_TILE_HEIGHT, MAP_SOLID_TYPE_MIN, MAP_SOLID_TYPE_MAX);
+  if (solid_map == NULL)
   {
-    SDL_Log("Failed to create particle_group");
-    return false;
+    SDL_Log("Warning: failed to load %s, collision will not be available", MAP_PATH);
   }
-  
+
+  // camera starts out covering the screen, emitters out of its view are culled
+  Camera_init(&camera, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+  particle_system->camera = &camera;
+
   // particle emitter
-  particle_emitter = ParticleEmitter_new(particle_group, 200, SCREEN_WIDTH/2, SCREEN_HEIGHT - 10);
+  particle_emitter = ParticleSystem_add_emitter(particle_system, particle_group, 200, SCREEN_WIDTH/2, SCREEN_HEIGHT - 10);
   if (particle_emitter == NULL)
   {
     SDL_Log("Failed to create particle_emitter");
@@ -157,7 +230,14 @@ bool setup()
 
 void update(float deltaTime)
 {
-  ParticleEmitter_update(particle_emitter, deltaTime);
+  // pick up changes of particle group's settings, emitters keep running on the same group
+  if (particle_group_watcher != NULL)
+  {
+    ParticleGroupWatcher_poll(particle_group_watcher);
+  }
+
+  Camera_update_lerpcenter(&camera);
+  ParticleSystem_update(particle_system, deltaTime);
 }
 
 void handleEvent(SDL_Event *e, float deltaTime)
@@ -197,6 +277,68 @@ void handleEvent(SDL_Event *e, float deltaTime)
   {
     ParticleEmitter_apply_force(particle_emitter, -30, -10);
   }
+  // spawn explosion at mouse position
+  else if (e->type == SDL_MOUSEBUTTONDOWN && e->button.button == SDL_BUTTON_LEFT)
+  {
+    for (int i=0; i<EXPLOSION_EMITTERS; i++)
+    {
+      // convert from screen to world space
+      int ex = camera.view_rect.x + e->button.x + krr_math_rand_int2(-EXPLOSION_RADIUS, EXPLOSION_RADIUS);
+      int ey = camera.view_rect.y + e->button.y + krr_math_rand_int2(-EXPLOSION_RADIUS, EXPLOSION_RADIUS);
+      ParticleEmitter* explosion = ParticleSystem_add_emitter(particle_system, particle_group, EXPLOSION_PARTICLES, ex, ey);
+      if (explosion == NULL)
+      {
+        break;
+      }
+      if (collision_enabled)
+      {
+        ParticleEmitter_set_collision_map(explosion, solid_map, MAP_RESTITUTION);
+      }
+    }
+  }
+  // toggle force fields on the first emitter
+  else if (e->type == SDL_KEYDOWN && e->key.keysym.sym == SDLK_f)
+  {
+    force_fields_enabled = !force_fields_enabled;
+    if (force_fields_enabled)
+      ParticleEmitter_set_force_fields(particle_emitter, force_fields, NUM_FORCE_FIELDS);
+    else
+      ParticleEmitter_set_force_fields(particle_emitter, NULL, 0);
+  }
+  // toggle collision with solid tiles for all emitters
+  else if (e->type == SDL_KEYDOWN && e->key.keysym.sym == SDLK_m && solid_map != NULL)
+  {
+    collision_enabled = !collision_enabled;
+    for (int i=0; i<particle_system->num_emitters; i++)
+    {
+      ParticleEmitter_set_collision_map(particle_system->emitters[i], collision_enabled ? solid_map : NULL, MAP_RESTITUTION);
+    }
+  }
+  // pan camera, emitters going out of view will be culled
+  else if (e->type == SDL_KEYDOWN && e->key.keysym.sym == SDLK_a)
+  {
+    camera.target_x -= CAMERA_STEP;
+  }
+  else if (e->type == SDL_KEYDOWN && e->key.keysym.sym == SDLK_d)
+  {
+    camera.target_x += CAMERA_STEP;
+  }
+  else if (e->type == SDL_KEYDOWN && e->key.keysym.sym == SDLK_w)
+  {
+    camera.target_y -= CAMERA_STEP;
+  }
+  else if (e->type == SDL_KEYDOWN && e->key.keysym.sym == SDLK_s)
+  {
+    camera.target_y += CAMERA_STEP;
+  }
+  // remove all explosions, keep only the first emitter
+  else if (e->type == SDL_KEYDOWN && e->key.keysym.sym == SDLK_BACKSPACE)
+  {
+    while (particle_system->num_emitters > 1)
+    {
+      ParticleSystem_remove_emitter(particle_system, particle_system->emitters[particle_system->num_emitters-1]);
+    }
+  }
 }
 
 void render(float deltaTime)
@@ -225,11 +367,33 @@ void render(float deltaTime)
     }
 #endif
 
-    ParticleEmitter_render(particle_emitter);
+    // solid tiles in view
+    if (collision_enabled)
+    {
+      SDL_SetRenderDrawColor(gWindow->renderer, 0x80, 0x80, 0x80, 0xff);
+      const SDL_Rect* view = &camera.view_rect;
+      const int first_col = SDL_max(0, view->x / MAP_TILE_WIDTH);
+      const int first_row = SDL_max(0, view->y / MAP_TILE_HEIGHT);
+      const int last_col = SDL_min(solid_map->num_columns - 1, (view->x + view->w) / MAP_TILE_WIDTH);
+      const int last_row = SDL_min(solid_map->num_rows - 1, (view->y + view->h) / MAP_TILE_HEIGHT);
+      for (int row=first_row; row<=last_row; row++)
+      {
+        for (int col=first_col; col<=last_col; col++)
+        {
+          if (TileSolidMap_is_solid_tile(solid_map, col, row))
+          {
+            SDL_Rect r = { col * MAP_TILE_WIDTH - view->x, row * MAP_TILE_HEIGHT - view->y, MAP_TILE_WIDTH, MAP_TILE_HEIGHT };
+            SDL_RenderFillRect(gWindow->renderer, &r);
+          }
+        }
+      }
+    }
+
+    ParticleSystem_render(particle_system);
   }
 }
 
-void close()
+static void close()
 {
   // free font
   if (gFont != NULL)
@@ -243,15 +407,29 @@ void close()
   {
     LTexture_Free(particles_texture);
   }
+  // watcher of particle group's settings
+  if (particle_group_watcher != NULL)
+  {
+    ParticleGroupWatcher_free(particle_group_watcher);
+    particle_group_watcher = NULL;
+  }
   // particle group
   if (particle_group != NULL)
   {
     ParticleGroup_free(particle_group);
   }
-  // particle emitter
-  if (particle_emitter != NULL)
+  // solid tiles
+  if (solid_map != NULL)
+  {
+    TileSolidMap_free(solid_map);
+    solid_map = NULL;
+  }
+
+  // particle system along with all of its emitters
+  if (particle_system != NULL)
   {
-    ParticleEmitter_free(particle_emitter);
+    ParticleSystem_free(particle_system);
+    particle_emitter = NULL;
   }
 
   // destroy window
@@ -0,0 +1,337 @@
+/**
+ * 38 - Particle Engine (benchmark)
+ *
+ * Headless benchmark of particle update and render submission.
+ * It runs under dummy video driver with software renderer, so it needs neither GPU nor display.
+ * Results are printed as CSV to stdout, logs go to stderr.
+ *
+ * Usage: particles_bench.out [max_particles] [seed]
+ */
+
+#include "SDL.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "common.h"
+#include "LWindow.h"
+#include "LTexture.h"
+#include "ParticleEmitter.h"
+#include "ParticleSystem.h"
+#include "ParticleGroupFile.h"
+
+#define SCREEN_WIDTH 640
+#define SCREEN_HEIGHT 480
+#define FIXED_DELTATIME 1.0f / 60
+
+// frames to run before measuring, so all particles go through spawning once
+#define WARMUP_FRAMES 5
+// number of particle-frames to measure for each particle count, frames are derived from it
+#define WORK_PER_RUN 20000000
+#define MIN_FRAMES 3
+#define MAX_FRAMES 300
+
+#define DEFAULT_MAX_PARTICLES 1000000
+#define DEFAULT_SEED 38
+
+// -- allocation counting
+// SDL's own allocations are counted via SDL_SetMemoryFunctions().
+// Direct malloc() family calls from sample code are counted too when linked with
+// -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc (BENCH_WRAP_MALLOC), see Makefile.
+static SDL_atomic_t num_allocations;
+
+static SDL_malloc_func sdl_malloc = NULL;
+static SDL_calloc_func sdl_calloc = NULL;
+static SDL_realloc_func sdl_realloc = NULL;
+static SDL_free_func sdl_free = NULL;
+
+static void* counting_malloc(size_t size)
+{
+  SDL_AtomicIncRef(&num_allocations);
+  return sdl_malloc(size);
+}
+
+static void* counting_calloc(size_t nmemb, size_t size)
+{
+  SDL_AtomicIncRef(&num_allocations);
+  return sdl_calloc(nmemb, size);
+}
+
+static void* counting_realloc(void* mem, size_t size)
+{
+  SDL_AtomicIncRef(&num_allocations);
+  return sdl_realloc(mem, size);
+}
+
+#ifdef BENCH_WRAP_MALLOC
+extern void* __real_malloc(size_t size);
+extern void* __real_calloc(size_t nmemb, size_t size);
+extern void* __real_realloc(void* mem, size_t size);
+
+void* __wrap_malloc(size_t size)
+{
+  SDL_AtomicIncRef(&num_allocations);
+  return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t nmemb, size_t size)
+{
+  SDL_AtomicIncRef(&num_allocations);
+  return __real_calloc(nmemb, size);
+}
+
+void* __wrap_realloc(void* mem, size_t size)
+{
+  SDL_AtomicIncRef(&num_allocations);
+  return __real_realloc(mem, size);
+}
+#endif
+
+// -- result of one run
+typedef struct {
+  int frames;
+  double update_ns;
+  double render_ns;
+  int allocations;
+} BenchResult;
+
+static LWindow bench_window;
+static LTexture* particles_texture = NULL;
+static ParticleGroup* particle_group = NULL;
+
+static double elapsed_ns(Uint64 start, Uint64 end)
+{
+  return (double)(end - start) * 1e9 / (double)SDL_GetPerformanceFrequency();
+}
+
+static int frames_for(int num_particles)
+{
+  int frames = WORK_PER_RUN / num_particles;
+  if (frames < MIN_FRAMES) frames = MIN_FRAMES;
+  if (frames > MAX_FRAMES) frames = MAX_FRAMES;
+  return frames;
+}
+
+static bool init()
+{
+  // headless by default, but let user pick another driver via environment
+  SDL_setenv("SDL_VIDEODRIVER", "dummy", 0);
+
+  // count allocations made by SDL from now on
+  SDL_GetMemoryFunctions(&sdl_malloc, &sdl_calloc, &sdl_realloc, &sdl_free);
+  SDL_SetMemoryFunctions(counting_malloc, counting_calloc, counting_realloc, sdl_free);
+
+  if (SDL_Init(SDL_INIT_VIDEO) < 0)
+  {
+    SDL_Log("SDL could not initialize! SDL_Error: %s", SDL_GetError());
+    return false;
+  }
+
+  // LWindow always asks for accelerated renderer, so set it up manually with software renderer
+  bench_window.window = SDL_CreateWindow("38 - Particle Engines (benchmark)", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_HIDDEN);
+  if (bench_window.window == NULL)
+  {
+    SDL_Log("Window could not be created! SDL_Error: %s", SDL_GetError());
+    return false;
+  }
+  bench_window.renderer = SDL_CreateRenderer(bench_window.window, -1, SDL_RENDERER_SOFTWARE);
+  if (bench_window.renderer == NULL)
+  {
+    SDL_Log("Software renderer could not be created! SDL_Error: %s", SDL_GetError());
+    return false;
+  }
+  bench_window.width = SCREEN_WIDTH;
+  bench_window.height = SCREEN_HEIGHT;
+  gWindow = &bench_window;
+
+  return true;
+}
+
+static bool setup()
+{
+  particles_texture = LTexture_LoadFromFileWithColorKey("particles.bmp", 0x00, 0xff, 0xff);
+  if (particles_texture == NULL)
+  {
+    SDL_Log("Failed to load particles.bmp");
+    return false;
+  }
+
+  // same configuration as in particles.c
+  particle_group = ParticleGroup_new(particles_texture, particles_texture->width/4, particles_texture->height, 1, 3, 10);
+  if (particle_group == NULL)
+  {
+    SDL_Log("Failed to create particle_group");
+    return false;
+  }
+  if (!ParticleGroup_load_settings(particle_group, "fire.pgroup"))
+  {
+    SDL_Log("Failed to load fire.pgroup");
+    return false;
+  }
+
+  return true;
+}
+
+// run frames on a single ParticleEmitter, rendered via ParticleEmitter_render()
+static bool bench_emitter(int num_particles, Uint64 seed, BenchResult* out)
+{
+  ParticleEmitter* emitter = ParticleEmitter_new(particle_group, num_particles, SCREEN_WIDTH/2, SCREEN_HEIGHT - 10);
+  if (emitter == NULL)
+  {
+    return false;
+  }
+  ParticleEmitter_set_seed(emitter, seed);
+
+  for (int i=0; i<WARMUP_FRAMES; i++)
+  {
+    ParticleEmitter_update(emitter, FIXED_DELTATIME);
+  }
+
+  out->frames = frames_for(num_particles);
+  out->update_ns = 0;
+  out->render_ns = 0;
+  const int allocations_before = SDL_AtomicGet(&num_allocations);
+
+  for (int i=0; i<out->frames; i++)
+  {
+    Uint64 t0 = SDL_GetPerformanceCounter();
+    ParticleEmitter_update(emitter, FIXED_DELTATIME);
+    Uint64 t1 = SDL_GetPerformanceCounter();
+    ParticleEmitter_render(emitter);
+    Uint64 t2 = SDL_GetPerformanceCounter();
+
+    // presenting is not part of submission
+    SDL_RenderPresent(gWindow->renderer);
+
+    out->update_ns += elapsed_ns(t0, t1);
+    out->render_ns += elapsed_ns(t1, t2);
+  }
+
+  out->allocations = SDL_AtomicGet(&num_allocations) - allocations_before;
+  ParticleEmitter_free(emitter);
+  return true;
+}
+
+// run frames on ParticleSystem holding a single emitter, rendered via ParticleSystem_render()
+static bool bench_system(int num_particles, Uint64 seed, BenchResult* out)
+{
+  ParticleSystem* ps = ParticleSystem_new(1, num_particles);
+  if (ps == NULL)
+  {
+    return false;
+  }
+  ParticleEmitter* emitter = ParticleSystem_add_emitter(ps, particle_group, num_particles, SCREEN_WIDTH/2, SCREEN_HEIGHT - 10);
+  if (emitter == NULL)
+  {
+    ParticleSystem_free(ps);
+    return false;
+  }
+  ParticleEmitter_set_seed(emitter, seed);
+
+  for (int i=0; i<WARMUP_FRAMES; i++)
+  {
+    ParticleSystem_update(ps, FIXED_DELTATIME);
+  }
+
+  out->frames = frames_for(num_particles);
+  out->update_ns = 0;
+  out->render_ns = 0;
+  const int allocations_before = SDL_AtomicGet(&num_allocations);
+
+  for (int i=0; i<out->frames; i++)
+  {
+    Uint64 t0 = SDL_GetPerformanceCounter();
+    ParticleSystem_update(ps, FIXED_DELTATIME);
+    Uint64 t1 = SDL_GetPerformanceCounter();
+    ParticleSystem_render(ps);
+    Uint64 t2 = SDL_GetPerformanceCounter();
+
+    SDL_RenderPresent(gWindow->renderer);
+
+    out->update_ns += elapsed_ns(t0, t1);
+    out->render_ns += elapsed_ns(t1, t2);
+  }
+
+  out->allocations = SDL_AtomicGet(&num_allocations) - allocations_before;
+  ParticleSystem_free(ps);
+  return true;
+}
+
+static void print_result(const char* path, int num_particles, const BenchResult* r)
+{
+  printf("%s,%d,%d,%.2f,%.3f,%.2f,%.2f\n",
+      path,
+      num_particles,
+      r->frames,
+      r->update_ns / r->frames / num_particles,
+      r->render_ns / r->frames / 1e6,
+      r->render_ns / r->frames / num_particles,
+      (double)r->allocations / r->frames);
+  fflush(stdout);
+}
+
+static void close()
+{
+  if (particle_group != NULL)
+  {
+    ParticleGroup_free(particle_group);
+    particle_group = NULL;
+  }
+  if (particles_texture != NULL)
+  {
+    LTexture_Free(particles_texture);
+    particles_texture = NULL;
+  }
+  if (bench_window.renderer != NULL)
+  {
+    SDL_DestroyRenderer(bench_window.renderer);
+    bench_window.renderer = NULL;
+  }
+  if (bench_window.window != NULL)
+  {
+    SDL_DestroyWindow(bench_window.window);
+    bench_window.window = NULL;
+  }
+  gWindow = NULL;
+
+  SDL_Quit();
+}
+
+int main(int argc, char* args[])
+{
+  int max_particles = argc > 1 ? atoi(args[1]) : DEFAULT_MAX_PARTICLES;
+  Uint64 seed = argc > 2 ? strtoull(args[2], NULL, 10) : DEFAULT_SEED;
+
+  if (!init() || !setup())
+  {
+    SDL_Log("Failed to set up benchmark");
+    close();
+    return 1;
+  }
+
+  printf("path,particles,frames,update_ns_per_particle,render_submit_ms_per_frame,render_submit_ns_per_particle,allocations_per_frame\n");
+
+  for (int n=1000; n<=max_particles; n*=10)
+  {
+    BenchResult r;
+    if (bench_emitter(n, seed, &r))
+    {
+      print_result("emitter", n, &r);
+    }
+    else
+    {
+      SDL_Log("Failed to run emitter benchmark with %d particles", n);
+    }
+
+    if (bench_system(n, seed, &r))
+    {
+      print_result("system", n, &r);
+    }
+    else
+    {
+      SDL_Log("Failed to run system benchmark with %d particles", n);
+    }
+  }
+
+  close();
+  return 0;
+}
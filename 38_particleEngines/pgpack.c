@@ -0,0 +1,77 @@
+/**
+ * Build step tool to pack text definitions of ParticleGroups into a single binary file
+ * for release builds, see ParticleGroupFile.h.
+ * Each group is named after its file name without extension.
+ *
+ * Usage: pgpack <output-path> <definition-path> ...
+ */
+
+#include "SDL.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ParticleGroupFile.h"
+
+int main(int argc, char* argv[])
+{
+  if (argc < 3)
+  {
+    fprintf(stderr, "Usage: %s <output-path> <definition-path> ...\n", argv[0]);
+    return 1;
+  }
+
+  const int num_groups = argc - 2;
+  ParticleGroup* groups = calloc(num_groups, sizeof(ParticleGroup));
+  char (*names)[PARTICLEGROUPPACK_NAME_MAX] = calloc(num_groups, sizeof(names[0]));
+  const char** name_ptrs = calloc(num_groups, sizeof(const char*));
+  if (groups == NULL || names == NULL || name_ptrs == NULL)
+  {
+    fprintf(stderr, "Unable to allocate memory\n");
+    free(groups);
+    free(names);
+    free(name_ptrs);
+    return 1;
+  }
+
+  int result = 0;
+  for (int i=0; i<num_groups && result == 0; i++)
+  {
+    const char* path = argv[i + 2];
+
+    // name is file name without directory and extension
+    const char* name = path;
+    for (const char* c = path; *c != '\0'; c++)
+    {
+      if (*c == '/' || *c == '\\')
+        name = c + 1;
+    }
+    const char* ext = strrchr(name, '.');
+    const size_t name_length = ext != NULL ? (size_t)(ext - name) : strlen(name);
+    if (name_length == 0 || name_length >= PARTICLEGROUPPACK_NAME_MAX)
+    {
+      fprintf(stderr, "Unable to derive group name from %s\n", path);
+      result = 1;
+      break;
+    }
+    memcpy(names[i], name, name_length);
+    names[i][name_length] = '\0';
+    name_ptrs[i] = names[i];
+
+    if (!ParticleGroup_load_settings(groups + i, path))
+    {
+      fprintf(stderr, "Failed to parse %s\n", path);
+      result = 1;
+    }
+  }
+
+  if (result == 0 && !ParticleGroupPack_write(argv[1], name_ptrs, groups, num_groups))
+  {
+    fprintf(stderr, "Failed to write %s\n", argv[1]);
+    result = 1;
+  }
+
+  free(groups);
+  free(names);
+  free(name_ptrs);
+  return result;
+}
@@ -9,5 +9,19 @@ int main(int argc, char* argv[])
   printf("krr_math_rand_float2(100,150) = %.2f\n", krr_math_rand_float2(100, 150));
   printf("krr_math_rand_float2(-100,200) = %.2f\n", krr_math_rand_float2(-100, 200));
   printf("krr_math_rand_float2(0,0) = %.2f\n", krr_math_rand_float2(0,0));
+
+  krr_rng rng;
+  krr_rng_seed(&rng, 1234);
+  printf("krr_rng_int2(&rng, 100, 150) = %d\n", krr_rng_int2(&rng, 100, 150));
+  printf("krr_rng_float2(&rng, -100, 200) = %.2f\n", krr_rng_float2(&rng, -100, 200));
+
+  float floats[6];
+  krr_rng_fill_float2(&rng, floats, 6, 0, 1);
+  printf("krr_rng_fill_float2(&rng, floats, 6, 0, 1) =");
+  for (int i=0; i<6; i++)
+  {
+    printf(" %.2f", floats[i]);
+  }
+  printf("\n");
   return 0;
 }
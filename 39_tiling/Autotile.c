@@ -0,0 +1,34 @@
+#include "Autotile.h"
+
+void Autotile_apply(const Autotile* rules, TileMap* map)
+{
+  Autotile_apply_range(rules, map, 0, 0, map->num_columns - 1, map->num_rows - 1);
+}
+
+void Autotile_apply_range(const Autotile* rules, TileMap* map, int first_col, int first_row, int last_col, int last_row)
+{
+  first_col = SDL_max(0, first_col);
+  first_row = SDL_max(0, first_row);
+  last_col = SDL_min(map->num_columns - 1, last_col);
+  last_row = SDL_min(map->num_rows - 1, last_row);
+
+  // solidity doesn't change while autotiling, so it's safe to update in place
+  for (int row=first_row; row<=last_row; row++)
+  {
+    for (int col=first_col; col<=last_col; col++)
+    {
+      if (Autotile_is_solid(rules, map, col, row))
+      {
+        TileMap_set(map, col, row, rules->types[Autotile_get_mask(rules, map, col, row)]);
+      }
+    }
+  }
+}
+
+void Autotile_set(const Autotile* rules, TileMap* map, int col, int row, TileMapType type)
+{
+  TileMap_set(map, col, row, type);
+
+  // only the tile itself and its neighbors can have their mask changed
+  Autotile_apply_range(rules, map, col - 1, row - 1, col + 1, row + 1);
+}
@@ -0,0 +1,105 @@
+#ifndef Autotile_h_
+#define Autotile_h_
+
+#include "SDL.h"
+#include "TileMap.h"
+
+/// bits of neighbor mask, set when neighbor in that direction is solid
+#define AUTOTILE_UP 1
+#define AUTOTILE_RIGHT 2
+#define AUTOTILE_DOWN 4
+#define AUTOTILE_LEFT 8
+
+/// number of possible neighbor masks
+#define AUTOTILE_NUM_MASKS 16
+
+///
+/// Rules to derive type of solid tiles from their neighbors, so map authors only need to
+/// mark which tiles are solid, and edges as well as corners are worked out automatically.
+///
+/// Solidity is decided by type alone, and autotiling only picks among solid types, so
+/// solidity of tiles never changes by autotiling. That's what makes it possible to recompute
+/// only 3x3 neighborhood of edited tile.
+///
+/// Neighbors outside of map are treated as solid, so solid tiles touching border of map
+/// don't get edges on that side.
+///
+typedef struct
+{
+  /// tiles with type within [solid_type_min, solid_type_max] are solid
+  int solid_type_min;
+  int solid_type_max;
+
+  /// type of solid tile for each neighbor mask, see AUTOTILE_UP and others
+  TileMapType types[AUTOTILE_NUM_MASKS];
+} Autotile;
+
+///
+/// Whether tile is solid.
+///
+/// \param rules Autotile rules
+/// \param map TileMap
+/// \param col Column of tile
+/// \param row Row of tile
+/// \return True if solid, otherwise return false. Tiles outside of map are solid.
+///
+static inline bool Autotile_is_solid(const Autotile* rules, const TileMap* map, int col, int row)
+{
+  if ((unsigned)col >= (unsigned)map->num_columns || (unsigned)row >= (unsigned)map->num_rows)
+  {
+    return true;
+  }
+  const int type = TileMap_get(map, col, row);
+  return type >= rules->solid_type_min && type <= rules->solid_type_max;
+}
+
+///
+/// Get neighbor mask of tile from its 4 direct neighbors.
+///
+/// \param rules Autotile rules
+/// \param map TileMap
+/// \param col Column of tile
+/// \param row Row of tile
+/// \return Neighbor mask as combination of AUTOTILE_UP, AUTOTILE_RIGHT, AUTOTILE_DOWN, and AUTOTILE_LEFT
+///
+static inline int Autotile_get_mask(const Autotile* rules, const TileMap* map, int col, int row)
+{
+  return (Autotile_is_solid(rules, map, col, row-1) ? AUTOTILE_UP : 0) |
+         (Autotile_is_solid(rules, map, col+1, row) ? AUTOTILE_RIGHT : 0) |
+         (Autotile_is_solid(rules, map, col, row+1) ? AUTOTILE_DOWN : 0) |
+         (Autotile_is_solid(rules, map, col-1, row) ? AUTOTILE_LEFT : 0);
+}
+
+///
+/// Autotile the whole map.
+///
+/// \param rules Autotile rules
+/// \param map TileMap
+///
+extern void Autotile_apply(const Autotile* rules, TileMap* map);
+
+///
+/// Autotile tiles within range of columns and rows, it's clamped to map.
+///
+/// \param rules Autotile rules
+/// \param map TileMap
+/// \param first_col First column
+/// \param first_row First row
+/// \param last_col Last column (inclusive)
+/// \param last_row Last row (inclusive)
+///
+extern void Autotile_apply_range(const Autotile* rules, TileMap* map, int first_col, int first_row, int last_col, int last_row);
+
+///
+/// Set type of tile, then autotile its 3x3 neighborhood.
+/// Solid type is replaced by the one derived from its neighbors.
+///
+/// \param rules Autotile rules
+/// \param map TileMap
+/// \param col Column of tile, must be within map
+/// \param row Row of tile, must be within map
+/// \param type Type of tile
+///
+extern void Autotile_set(const Autotile* rules, TileMap* map, int col, int row, TileMapType type);
+
+#endif
@@ -2,23 +2,148 @@
 #include "SDL.h"
 #include "common.h"
 #include <stdlib.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 // variables defined in common.h
 extern LWindow* gWindow;
 
-static LTexture* LTexture_LoadFromFileColorKeyFlag(const char* path, bool withColorKey, Uint8 colorKeyRed, Uint8 colorKeyGreen, Uint8 colorKeyBlue);
+static LTexture* LTexture_LoadFromFileColorKeyFlag(const char* path, bool withColorKey, Uint8 colorKeyRed, Uint8 colorKeyGreen, Uint8 colorKeyBlue, int max_mip_levels);
+
+/// downscale 32 bit per pixel image into half resolution by averaging each 2x2 block
+/// it works on each byte independently, thus it doesn't care about order of color components
+/// last row/column is dropped if dimension is odd
+static void downscale_half(const Uint8* src, int src_pitch, Uint8* dst, int dst_pitch, int dst_w, int dst_h)
+{
+  for (int y=0; y<dst_h; y++)
+  {
+    const Uint8* row0 = src + (y*2) * src_pitch;
+    const Uint8* row1 = row0 + src_pitch;
+    Uint8* out = dst + y * dst_pitch;
+    int x = 0;
+
+#ifdef __SSE2__
+    // 4 output pixels (8 source pixels from each row) at a time
+    for (; x + 4 <= dst_w; x += 4)
+    {
+      const Uint8* s0 = row0 + x * 8;
+      const Uint8* s1 = row1 + x * 8;
+
+      // average vertically
+      __m128i v_lo = _mm_avg_epu8(_mm_loadu_si128((const __m128i*)s0), _mm_loadu_si128((const __m128i*)s1));
+      __m128i v_hi = _mm_avg_epu8(_mm_loadu_si128((const __m128i*)(s0 + 16)), _mm_loadu_si128((const __m128i*)(s1 + 16)));
+
+      // separate even and odd pixels, then average them horizontally
+      __m128 lo = _mm_castsi128_ps(v_lo);
+      __m128 hi = _mm_castsi128_ps(v_hi);
+      __m128i even = _mm_castps_si128(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0)));
+      __m128i odd = _mm_castps_si128(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1)));
+
+      _mm_storeu_si128((__m128i*)(out + x * 4), _mm_avg_epu8(even, odd));
+    }
+#endif
+
+    // the rest, or all of them if no SIMD support
+    // average the same way as SIMD path (vertically then horizontally, rounding up) so result is identical
+    for (; x < dst_w; x++)
+    {
+      const Uint8* s0 = row0 + x * 8;
+      const Uint8* s1 = row1 + x * 8;
+      for (int c=0; c<4; c++)
+      {
+        int left = (s0[c] + s1[c] + 1) >> 1;
+        int right = (s0[c + 4] + s1[c + 4] + 1) >> 1;
+        out[x*4 + c] = (left + right + 1) >> 1;
+      }
+    }
+  }
+}
+
+/// generate downscaled levels for ltexture from its source surface
+/// return number of levels successfully generated
+static int generate_mipmaps(LTexture* ltexture, SDL_Surface* surface, int max_levels)
+{
+  if (max_levels > LTEXTURE_MAX_MIP_LEVELS)
+  {
+    max_levels = LTEXTURE_MAX_MIP_LEVELS;
+  }
+
+  // work on 32 bit per pixel format
+  // this also converts color key into alpha channel
+  SDL_Surface* level = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+  if (level == NULL)
+  {
+    SDL_Log("Unable to convert surface to generate mipmaps! SDL Error: %s", SDL_GetError());
+    return 0;
+  }
+
+  // downscaled levels should blend the same way as original texture
+  SDL_BlendMode blend_mode = SDL_BLENDMODE_NONE;
+  SDL_GetTextureBlendMode(ltexture->texture, &blend_mode);
+
+  int num_levels = 0;
+  while (num_levels < max_levels && level->w >= 2 && level->h >= 2)
+  {
+    SDL_Surface* next = SDL_CreateRGBSurfaceWithFormat(0, level->w / 2, level->h / 2, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (next == NULL)
+    {
+      SDL_Log("Unable to create surface for mipmap level %d! SDL Error: %s", num_levels + 1, SDL_GetError());
+      break;
+    }
+    downscale_half(level->pixels, level->pitch, next->pixels, next->pitch, next->w, next->h);
+
+    SDL_Texture* mip_texture = SDL_CreateTextureFromSurface(gWindow->renderer, next);
+    if (mip_texture == NULL)
+    {
+      SDL_Log("Unable to create texture for mipmap level %d! SDL Error: %s", num_levels + 1, SDL_GetError());
+      SDL_FreeSurface(next);
+      break;
+    }
+    SDL_SetTextureBlendMode(mip_texture, blend_mode);
+    ltexture->mip_textures[num_levels++] = mip_texture;
+
+    // next level is computed from this one
+    SDL_FreeSurface(level);
+    level = next;
+  }
+
+  SDL_FreeSurface(level);
+  return num_levels;
+}
+
+/// select texture to render according to scale
+/// out_level will be set with selected level, 0 means the original texture
+static SDL_Texture* select_mip_texture(LTexture* ltexture, float scale, int* out_level)
+{
+  int level = 0;
+  // only go down a level if it still has at least as many texels as pixels to render
+  while (level < ltexture->num_mip_levels && scale <= 0.5f)
+  {
+    scale *= 2.0f;
+    level++;
+  }
+
+  *out_level = level;
+  return level == 0 ? ltexture->texture : ltexture->mip_textures[level - 1];
+}
 
 LTexture* LTexture_LoadFromFile(const char* path)
 {
-  return LTexture_LoadFromFileColorKeyFlag(path, false, 0x00, 0xFF, 0xFF);
+  return LTexture_LoadFromFileColorKeyFlag(path, false, 0x00, 0xFF, 0xFF, 0);
 }
 
 LTexture* LTexture_LoadFromFileWithColorKey(const char* path, Uint8 colorKeyRed, Uint8 colorKeyGreen, Uint8 colorKeyBlue)
 {
-  return LTexture_LoadFromFileColorKeyFlag(path, true, colorKeyRed, colorKeyGreen, colorKeyBlue);
+  return LTexture_LoadFromFileColorKeyFlag(path, true, colorKeyRed, colorKeyGreen, colorKeyBlue, 0);
+}
+
+LTexture* LTexture_LoadFromFileWithMipmaps(const char* path, bool withColorKey, Uint8 colorKeyRed, Uint8 colorKeyGreen, Uint8 colorKeyBlue, int max_levels)
+{
+  return LTexture_LoadFromFileColorKeyFlag(path, withColorKey, colorKeyRed, colorKeyGreen, colorKeyBlue, max_levels);
 }
 
-LTexture* LTexture_LoadFromFileColorKeyFlag(const char* path, bool withColorKey, Uint8 colorKeyRed, Uint8 colorKeyGreen, Uint8 colorKeyBlue)
+LTexture* LTexture_LoadFromFileColorKeyFlag(const char* path, bool withColorKey, Uint8 colorKeyRed, Uint8 colorKeyGreen, Uint8 colorKeyBlue, int max_mip_levels)
 {
   // load image at specified path
   SDL_Surface* loadedSurface = IMG_Load(path);
@@ -51,6 +176,13 @@ LTexture* LTexture_LoadFromFileColorKeyFlag(const char* path, bool withColorKey,
   out->height = loadedSurface->h;
   // set texture to ltexture
   out->texture = newTexture;
+  out->num_mip_levels = 0;
+
+  // generate downscaled levels while we still have pixels data on CPU
+  if (max_mip_levels > 0)
+  {
+    out->num_mip_levels = generate_mipmaps(out, loadedSurface, max_mip_levels);
+  }
 
   // free surface, we don't need it anymore
   SDL_FreeSurface(loadedSurface);
@@ -100,6 +232,7 @@ LTexture* LTexture_LoadFromRenderedText_withFont(const char* textureText, TTF_Fo
   out->width = textSurface->w;
   out->height = textSurface->h;
   out->texture = newTexture;
+  out->num_mip_levels = 0;
 
   // free surface, we don't need it anymore
   SDL_FreeSurface(textSurface);
@@ -123,7 +256,10 @@ void LTexture_RenderEx(LTexture* ltexture, int x, int y, float scale, double ang
 
   SDL_Rect renderQuad = { new_x, new_y, ltexture->width * scale, ltexture->height * scale };
 
-  SDL_RenderCopyEx(gWindow->renderer, ltexture->texture, NULL, &renderQuad, angle, center, flip);
+  // whole texture, so no need to care about which level is selected
+  int level = 0;
+  SDL_Texture* texture = select_mip_texture(ltexture, scale, &level);
+  SDL_RenderCopyEx(gWindow->renderer, texture, NULL, &renderQuad, angle, center, flip);
 }
 
 void LTexture_ClippedRender(LTexture* ltexture, int x, int y, SDL_Rect* clip)
@@ -141,25 +277,49 @@ void LTexture_ClippedRenderEx(LTexture *ltexture, int x, int y, float scale, SDL
   int new_y = (y + clip->h/2) - (clip->h/2 * scale);
 
   SDL_Rect renderQuad = { new_x, new_y, clip->w * scale, clip->h * scale };
-  SDL_RenderCopyEx(gWindow->renderer, ltexture->texture, clip, &renderQuad, angle, center, flip);
+
+  int level = 0;
+  SDL_Texture* texture = select_mip_texture(ltexture, scale, &level);
+  if (level > 0)
+  {
+    // clipping rectangle needs to be in space of selected level
+    SDL_Rect level_clip = { clip->x >> level, clip->y >> level, clip->w >> level, clip->h >> level };
+    SDL_RenderCopyEx(gWindow->renderer, texture, &level_clip, &renderQuad, angle, center, flip);
+  }
+  else
+  {
+    SDL_RenderCopyEx(gWindow->renderer, texture, clip, &renderQuad, angle, center, flip);
+  }
 }
 
 void LTexture_SetColor(LTexture* ltexture, Uint8 red, Uint8 green, Uint8 blue)
 {
   // set color for modulation
   SDL_SetTextureColorMod(ltexture->texture, red, green, blue);
+  for (int i=0; i<ltexture->num_mip_levels; i++)
+  {
+    SDL_SetTextureColorMod(ltexture->mip_textures[i], red, green, blue);
+  }
 }
 
 void LTexture_SetBlendMode(LTexture* ltexture, SDL_BlendMode blending)
 {
   // set blending mode
   SDL_SetTextureBlendMode(ltexture->texture, blending);
+  for (int i=0; i<ltexture->num_mip_levels; i++)
+  {
+    SDL_SetTextureBlendMode(ltexture->mip_textures[i], blending);
+  }
 }
 
 void LTexture_SetAlpha(LTexture* ltexture, Uint8 alpha)
 {
   // modulate texture alpha
   SDL_SetTextureAlphaMod(ltexture->texture, alpha);
+  for (int i=0; i<ltexture->num_mip_levels; i++)
+  {
+    SDL_SetTextureAlphaMod(ltexture->mip_textures[i], alpha);
+  }
 }
 
 void LTexture_Free(LTexture* ltexture)
@@ -171,6 +331,14 @@ void LTexture_Free(LTexture* ltexture)
     ltexture->texture = NULL;
   }
 
+  // destroy downscaled levels
+  for (int i=0; i<ltexture->num_mip_levels; i++)
+  {
+    SDL_DestroyTexture(ltexture->mip_textures[i]);
+    ltexture->mip_textures[i] = NULL;
+  }
+  ltexture->num_mip_levels = 0;
+
   free(ltexture);
   ltexture = NULL; 
 }
@@ -14,11 +14,23 @@
 #include "SDL_ttf.h"
 #endif
 
+/// maximum number of downscaled levels (excluding the original one) a texture can have
+#define LTEXTURE_MAX_MIP_LEVELS 8
+
 // i know guys, we will care about byte alignment of struct later ;)
 struct LTexture {
 	SDL_Texture* texture;
 	int width;
 	int height;
+
+  /// downscaled textures, each one is half the resolution of previous level.
+  /// mip_textures[0] is half of texture, mip_textures[1] is a quarter and so on.
+  /// (read-only)
+  SDL_Texture* mip_textures[LTEXTURE_MAX_MIP_LEVELS];
+
+  /// number of valid textures in mip_textures, 0 if texture has no downscaled levels
+  /// (read-only)
+  int num_mip_levels;
 };
 typedef struct LTexture LTexture;
 
@@ -31,6 +43,22 @@ typedef struct LTexture LTexture;
 extern LTexture* LTexture_LoadFromFile(const char* path);
 extern LTexture* LTexture_LoadFromFileWithColorKey(const char* path, Uint8 colorKeyRed, Uint8 colorKeyGreen, Uint8 colorKeyBlue);
 
+/*
+ * Load texture at the specified path along with its downscaled levels.
+ * Each level is half the resolution of previous one, computed with 2x2 box filter on CPU at load time.
+ * Rendering with scale of 0.5 or less via LTexture_RenderEx() or LTexture_ClippedRenderEx() will automatically
+ * use the smallest level that still has enough resolution, thus sampling far fewer texels.
+ *
+ * Note: for sprite sheet, position and size of all clipping rectangles should be divisible by 2^levels
+ * so that each cell doesn't bleed into its neighbors when downscaled.
+ *
+ * withColorKey - true to also set color key, otherwise colorKey... will be ignored
+ * max_levels - maximum number of downscaled levels to generate, up to LTEXTURE_MAX_MIP_LEVELS.
+ *              Generating stops early if dimension cannot be halved anymore.
+ * Return newly created LTexture as loaded from file.
+ */
+extern LTexture* LTexture_LoadFromFileWithMipmaps(const char* path, bool withColorKey, Uint8 colorKeyRed, Uint8 colorKeyGreen, Uint8 colorKeyBlue, int max_levels);
+
 #ifndef DISABLE_SDL_TTF_LIB
 /*
  * Load texture from rendered text, and color.
@@ -55,6 +83,7 @@ extern void LTexture_Render(LTexture* texture, int x, int y);
 
 /*
  * Render LTexture at given point along with rotation angle, center point to rotate, and flipping type.
+ * If texture has downscaled levels, the appropriate one is selected according to scale.
  */
 extern void LTexture_RenderEx(LTexture* ltexture, int x, int y, float scale, double angle, SDL_Point* center, SDL_RendererFlip flip);
 
@@ -65,6 +94,7 @@ extern void LTexture_ClippedRender(LTexture* texture, int x, int y, SDL_Rect* cl
 
 /*
  * Render clipped LTexture at the given point along with rotation angle, center point to rotate, and flipping type.
+ * If texture has downscaled levels, the appropriate one is selected according to scale.
  */
 extern void LTexture_ClippedRenderEx(LTexture* ltexture, int x, int y, float scale, SDL_Rect* clip, double angle, SDL_Point* center, SDL_RendererFlip flip);
 
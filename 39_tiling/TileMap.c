@@ -0,0 +1,84 @@
+#include "TileMap.h"
+#include <stdlib.h>
+
+// floor division, as tiles at negative positions round towards negative infinity
+static int floor_div(int a, int b)
+{
+  return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+TileMap* TileMap_new(int num_columns, int num_rows, int tile_width, int tile_height)
+{
+  TileMap* out = malloc(sizeof(TileMap));
+  if (out == NULL)
+  {
+    return NULL;
+  }
+
+  // init attributes
+  if (!TileMap_init(out, num_columns, num_rows, tile_width, tile_height))
+  {
+    // free memory immediately
+    free(out);
+    out = NULL;
+  }
+
+  return out;
+}
+
+bool TileMap_init(TileMap* map, int num_columns, int num_rows, int tile_width, int tile_height)
+{
+  if (num_columns <= 0 || num_rows <= 0 || tile_width <= 0 || tile_height <= 0)
+  {
+    SDL_Log("Invalid dimension for TileMap");
+    return false;
+  }
+
+  map->types = calloc((size_t)num_columns * num_rows, sizeof(TileMapType));
+  if (map->types == NULL)
+  {
+    SDL_Log("Unable to allocate memory for TileMap");
+    return false;
+  }
+
+  map->num_columns = num_columns;
+  map->num_rows = num_rows;
+  map->tile_width = tile_width;
+  map->tile_height = tile_height;
+
+  return true;
+}
+
+void TileMap_get_range(const TileMap* map, const SDL_Rect* rect, int* out_first_col, int* out_first_row, int* out_last_col, int* out_last_row)
+{
+  // tiles overlapping [x, x+w) x [y, y+h)
+  *out_first_col = SDL_max(0, floor_div(rect->x, map->tile_width));
+  *out_first_row = SDL_max(0, floor_div(rect->y, map->tile_height));
+  *out_last_col = SDL_min(map->num_columns - 1, floor_div(rect->x + rect->w - 1, map->tile_width));
+  *out_last_row = SDL_min(map->num_rows - 1, floor_div(rect->y + rect->h - 1, map->tile_height));
+}
+
+void TileMap_free_internals(TileMap* map)
+{
+  if (map->types != NULL)
+  {
+    free(map->types);
+    map->types = NULL;
+  }
+
+  map->num_columns = 0;
+  map->num_rows = 0;
+}
+
+void TileMap_free(TileMap* map)
+{
+  if (map != NULL)
+  {
+    // free its internals first
+    TileMap_free_internals(map);
+
+    // free its own allocated memory
+    free(map);
+    map = NULL;
+  }
+}
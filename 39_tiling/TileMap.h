@@ -0,0 +1,132 @@
+#ifndef TileMap_h_
+#define TileMap_h_
+
+#include "SDL.h"
+#include <stdbool.h>
+
+///
+/// Type of tile stored per cell.
+/// Define TILEMAP_WIDE_TYPES to store 16-bit types for tile sets with more than 256 types.
+///
+#ifdef TILEMAP_WIDE_TYPES
+typedef Uint16 TileMapType;
+#else
+typedef Uint8 TileMapType;
+#endif
+
+///
+/// Grid of tiles, only tile type is stored per cell in row-major order.
+/// Position and bounding box of tile are derived from its column and row when needed,
+/// see TileMap_get_box().
+///
+/// Map's top-left corner is at world origin.
+///
+typedef struct
+{
+  /// (read-only) types of tiles, tile at (col, row) is at index row * num_columns + col
+  TileMapType* types;
+
+  /// (read-only) number of columns
+  int num_columns;
+
+  /// (read-only) number of rows
+  int num_rows;
+
+  /// (read-only) tile width in pixels
+  int tile_width;
+
+  /// (read-only) tile height in pixels
+  int tile_height;
+} TileMap;
+
+///
+/// Create a new TileMap on heap with all tiles of type 0.
+///
+/// \param num_columns Number of columns
+/// \param num_rows Number of rows
+/// \param tile_width Tile width in pixels
+/// \param tile_height Tile height in pixels
+/// \return Newly created TileMap on heap, or NULL if failed.
+///
+extern TileMap* TileMap_new(int num_columns, int num_rows, int tile_width, int tile_height);
+
+///
+/// Initialize TileMap with all tiles of type 0.
+///
+/// \param map TileMap to be initialized
+/// \param num_columns Number of columns
+/// \param num_rows Number of rows
+/// \param tile_width Tile width in pixels
+/// \param tile_height Tile height in pixels
+/// \return True if initialize successfully, otherwise return false.
+///
+extern bool TileMap_init(TileMap* map, int num_columns, int num_rows, int tile_width, int tile_height);
+
+///
+/// Get type of tile.
+///
+/// \param map TileMap
+/// \param col Column of tile, must be within map
+/// \param row Row of tile, must be within map
+/// \return Type of tile
+///
+static inline TileMapType TileMap_get(const TileMap* map, int col, int row)
+{
+  return map->types[row * map->num_columns + col];
+}
+
+///
+/// Set type of tile.
+///
+/// \param map TileMap
+/// \param col Column of tile, must be within map
+/// \param row Row of tile, must be within map
+/// \param type Type of tile
+///
+static inline void TileMap_set(TileMap* map, int col, int row, TileMapType type)
+{
+  map->types[row * map->num_columns + col] = type;
+}
+
+///
+/// Get bounding box of tile in world space.
+///
+/// \param map TileMap
+/// \param col Column of tile
+/// \param row Row of tile
+/// \return Bounding box of tile
+///
+static inline SDL_Rect TileMap_get_box(const TileMap* map, int col, int row)
+{
+  SDL_Rect box = { col * map->tile_width, row * map->tile_height, map->tile_width, map->tile_height };
+  return box;
+}
+
+///
+/// Get range of columns and rows of tiles overlapping with rectangle in world space.
+/// Range is clamped to map, it's empty (first > last) if rectangle doesn't overlap with map.
+///
+/// \param map TileMap
+/// \param rect Rectangle in world space
+/// \param out_first_col Returned first column
+/// \param out_first_row Returned first row
+/// \param out_last_col Returned last column (inclusive)
+/// \param out_last_row Returned last row (inclusive)
+///
+extern void TileMap_get_range(const TileMap* map, const SDL_Rect* rect, int* out_first_col, int* out_first_row, int* out_last_col, int* out_last_row);
+
+///
+/// Free internals of TileMap.
+///
+/// \param map TileMap to be free its internals.
+///
+extern void TileMap_free_internals(TileMap* map);
+
+///
+/// Free memory of TileMap.
+///
+/// \param map TileMap to be freed.
+///
+extern void TileMap_free(TileMap* map);
+
+#endif
@@ -0,0 +1,610 @@
+#include "TileMapFile.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define FILE_MAGIC 0x4B434D54 /* 'TMCK' */
+#define FILE_VERSION 1
+#define HEADER_SIZE (10 * 4)
+#define INDEX_ENTRY_SIZE (2 * 4)
+// maximum number of columns and rows of map
+#define MAX_DIMENSION 0xffff
+
+// shortest back-reference worth encoding, also the number of bytes hashed to find one
+#define LZ_MIN_MATCH 4
+#define LZ_HASH_BITS 12
+#define LZ_MAX_OFFSET 0xffff
+
+// largest chunk before compression
+#define MAX_RAW_SIZE (TILEMAPFILE_MAX_CHUNK_SIZE * TILEMAPFILE_MAX_CHUNK_SIZE * sizeof(TileMapType))
+// worst case of RLE is a varint of 1 byte for every tile, and of LZ is 6 bytes for every 4-byte match,
+// chunk can't be stored larger than this anyway as raw is used instead
+#define MAX_COMPRESSED_SIZE (1 + MAX_RAW_SIZE * 2 + 16)
+
+// -- varint (LEB128), used for lengths in RLE and LZ
+static size_t write_varint(Uint8* out, Uint32 v)
+{
+  size_t n = 0;
+  while (v >= 0x80)
+  {
+    out[n++] = (Uint8)(v | 0x80);
+    v >>= 7;
+  }
+  out[n++] = (Uint8)v;
+  return n;
+}
+
+// return false if input ends before varint does
+static bool read_varint(const Uint8** p, const Uint8* end, Uint32* out)
+{
+  Uint32 v = 0;
+  for (int shift=0; shift<35; shift+=7)
+  {
+    if (*p >= end)
+    {
+      return false;
+    }
+    const Uint8 b = *(*p)++;
+    v |= (Uint32)(b & 0x7f) << shift;
+    if ((b & 0x80) == 0)
+    {
+      *out = v;
+      return true;
+    }
+  }
+  return false;
+}
+
+// -- RLE over tile types of type_size bytes, as pairs of run length and type
+static size_t rle_compress(const Uint8* in, size_t size, int type_size, Uint8* out)
+{
+  size_t op = 0;
+  for (size_t i=0; i<size; )
+  {
+    size_t run = 1;
+    while (i + (run + 1) * type_size <= size && memcmp(in + i, in + i + run * type_size, type_size) == 0)
+    {
+      run++;
+    }
+    op += write_varint(out + op, (Uint32)run);
+    memcpy(out + op, in + i, type_size);
+    op += type_size;
+    i += run * type_size;
+  }
+  return op;
+}
+
+static bool rle_decompress(const Uint8* in, size_t in_size, int type_size, Uint8* out, size_t out_size)
+{
+  const Uint8* p = in;
+  const Uint8* end = in + in_size;
+  size_t op = 0;
+  while (op < out_size)
+  {
+    Uint32 run = 0;
+    if (!read_varint(&p, end, &run) || run == 0 || (size_t)(end - p) < (size_t)type_size ||
+        run > (out_size - op) / type_size)
+    {
+      return false;
+    }
+    for (Uint32 r=0; r<run; r++)
+    {
+      memcpy(out + op, p, type_size);
+      op += type_size;
+    }
+    p += type_size;
+  }
+  return p == end;
+}
+
+// -- LZ77-style codec over bytes
+// sequence is literal length, literals, then match length (minus LZ_MIN_MATCH) and 16-bit offset.
+// the last sequence has literals only, decompression stops as soon as output is full.
+static Uint32 read32(const Uint8* p)
+{
+  Uint32 v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static size_t lz_compress(const Uint8* in, size_t size, Uint8* out)
+{
+  // most recent position + 1 for each hash of LZ_MIN_MATCH bytes, 0 for none
+  Uint32 table[1 << LZ_HASH_BITS];
+  memset(table, 0, sizeof(table));
+
+  size_t ip = 0;
+  size_t anchor = 0;
+  size_t op = 0;
+  while (ip + LZ_MIN_MATCH <= size)
+  {
+    const Uint32 seq = read32(in + ip);
+    const Uint32 h = (seq * 2654435761u) >> (32 - LZ_HASH_BITS);
+    const size_t candidate = table[h];
+    table[h] = (Uint32)(ip + 1);
+
+    if (candidate == 0 || ip - (candidate - 1) > LZ_MAX_OFFSET || read32(in + candidate - 1) != seq)
+    {
+      ip++;
+      continue;
+    }
+
+    const size_t match = candidate - 1;
+    size_t len = LZ_MIN_MATCH;
+    while (ip + len < size && in[match + len] == in[ip + len])
+    {
+      len++;
+    }
+
+    // literals before match
+    op += write_varint(out + op, (Uint32)(ip - anchor));
+    memcpy(out + op, in + anchor, ip - anchor);
+    op += ip - anchor;
+
+    // match
+    const size_t offset = ip - match;
+    op += write_varint(out + op, (Uint32)(len - LZ_MIN_MATCH));
+    out[op++] = (Uint8)(offset & 0xff);
+    out[op++] = (Uint8)(offset >> 8);
+
+    ip += len;
+    anchor = ip;
+  }
+
+  // remaining literals, possibly none
+  op += write_varint(out + op, (Uint32)(size - anchor));
+  memcpy(out + op, in + anchor, size - anchor);
+  op += size - anchor;
+  return op;
+}
+
+static bool lz_decompress(const Uint8* in, size_t in_size, Uint8* out, size_t out_size)
+{
+  const Uint8* p = in;
+  const Uint8* end = in + in_size;
+  size_t op = 0;
+  while (true)
+  {
+    Uint32 literals = 0;
+    if (!read_varint(&p, end, &literals) || literals > out_size - op || literals > (size_t)(end - p))
+    {
+      return false;
+    }
+    memcpy(out + op, p, literals);
+    op += literals;
+    p += literals;
+
+    if (op == out_size)
+    {
+      return p == end;
+    }
+
+    Uint32 len = 0;
+    if (!read_varint(&p, end, &len) || end - p < 2)
+    {
+      return false;
+    }
+    const size_t offset = p[0] | (p[1] << 8);
+    p += 2;
+    len += LZ_MIN_MATCH;
+    if (offset == 0 || offset > op || len > out_size - op)
+    {
+      return false;
+    }
+
+    // byte by byte, as match can overlap with what it's producing
+    for (Uint32 i=0; i<len; i++)
+    {
+      out[op + i] = out[op - offset + i];
+    }
+    op += len;
+  }
+}
+
+// -- chunks
+// get range of tiles covered by chunk
+static void chunk_region(int num_columns, int num_rows, int chunk_size, int chunk_x, int chunk_y, int* out_col, int* out_row, int* out_w, int* out_h)
+{
+  *out_col = chunk_x * chunk_size;
+  *out_row = chunk_y * chunk_size;
+  *out_w = SDL_min(chunk_size, num_columns - *out_col);
+  *out_h = SDL_min(chunk_size, num_rows - *out_row);
+}
+
+// compress chunk into out, return its size including codec
+static size_t compress_chunk(const TileMap* map, int chunk_size, int chunk_x, int chunk_y, Uint8* raw, Uint8* scratch, Uint8* out)
+{
+  int col, row, w, h;
+  chunk_region(map->num_columns, map->num_rows, chunk_size, chunk_x, chunk_y, &col, &row, &w, &h);
+
+  // gather tiles of chunk as little-endian bytes
+  const int type_size = sizeof(TileMapType);
+  size_t raw_size = 0;
+  for (int r=0; r<h; r++)
+  {
+    for (int c=0; c<w; c++)
+    {
+      const TileMapType type = TileMap_get(map, col + c, row + r);
+      for (int b=0; b<type_size; b++)
+      {
+        raw[raw_size++] = (Uint8)(type >> (b * 8));
+      }
+    }
+  }
+
+  // keep whichever is the smallest
+  out[0] = TILEMAPFILE_CODEC_RAW;
+  memcpy(out + 1, raw, raw_size);
+  size_t best = raw_size;
+
+  size_t size = rle_compress(raw, raw_size, type_size, scratch);
+  if (size < best)
+  {
+    out[0] = TILEMAPFILE_CODEC_RLE;
+    memcpy(out + 1, scratch, size);
+    best = size;
+  }
+
+  size = lz_compress(raw, raw_size, scratch);
+  if (size < best)
+  {
+    out[0] = TILEMAPFILE_CODEC_LZ;
+    memcpy(out + 1, scratch, size);
+    best = size;
+  }
+
+  return 1 + best;
+}
+
+bool TileMapFile_save(const TileMap* map, const char* path, int chunk_size)
+{
+  if (chunk_size <= 0 || chunk_size > TILEMAPFILE_MAX_CHUNK_SIZE)
+  {
+    SDL_Log("Invalid chunk size %d, it should be from 1 to %d", chunk_size, TILEMAPFILE_MAX_CHUNK_SIZE);
+    return false;
+  }
+  // the same limit TileMapFile_open() checks, don't write file which can't be read back
+  if (map->num_columns > MAX_DIMENSION || map->num_rows > MAX_DIMENSION)
+  {
+    SDL_Log("Map of %dx%d tiles is too large, it should be at most %dx%d", map->num_columns, map->num_rows, MAX_DIMENSION, MAX_DIMENSION);
+    return false;
+  }
+
+  const int num_chunks_x = (map->num_columns + chunk_size - 1) / chunk_size;
+  const int num_chunks_y = (map->num_rows + chunk_size - 1) / chunk_size;
+  const size_t num_chunks = (size_t)num_chunks_x * num_chunks_y;
+
+  // compress all chunks first, index needs to know their sizes
+  // raw is always a candidate, so each chunk takes at most its raw size plus codec
+  const size_t data_capacity = (size_t)map->num_columns * map->num_rows * sizeof(TileMapType) + num_chunks;
+  Uint8* data = malloc(data_capacity);
+  Uint32* sizes = malloc(sizeof(Uint32) * num_chunks);
+  Uint8* raw = malloc(MAX_RAW_SIZE);
+  Uint8* scratch = malloc(MAX_COMPRESSED_SIZE);
+  if (data == NULL || sizes == NULL || raw == NULL || scratch == NULL)
+  {
+    SDL_Log("Unable to allocate memory to compress map");
+    free(data);
+    free(sizes);
+    free(raw);
+    free(scratch);
+    return false;
+  }
+
+  size_t data_size = 0;
+  for (int cy=0; cy<num_chunks_y; cy++)
+  {
+    for (int cx=0; cx<num_chunks_x; cx++)
+    {
+      const size_t size = compress_chunk(map, chunk_size, cx, cy, raw, scratch, data + data_size);
+      sizes[(size_t)cy * num_chunks_x + cx] = (Uint32)size;
+      data_size += size;
+    }
+  }
+  free(raw);
+  free(scratch);
+
+  const size_t total_size = HEADER_SIZE + num_chunks * INDEX_ENTRY_SIZE + data_size;
+  if (total_size > 0xffffffffu)
+  {
+    SDL_Log("Compressed map is too large for 32-bit offsets");
+    free(data);
+    free(sizes);
+    return false;
+  }
+
+  SDL_RWops* rw = SDL_RWFromFile(path, "wb");
+  if (rw == NULL)
+  {
+    SDL_Log("Unable to open %s for writing: %s", path, SDL_GetError());
+    free(data);
+    free(sizes);
+    return false;
+  }
+
+  // each write returns 1 on success
+  size_t written = 0;
+  written += SDL_WriteLE32(rw, FILE_MAGIC);
+  written += SDL_WriteLE32(rw, FILE_VERSION);
+  written += SDL_WriteLE32(rw, sizeof(TileMapType));
+  written += SDL_WriteLE32(rw, map->num_columns);
+  written += SDL_WriteLE32(rw, map->num_rows);
+  written += SDL_WriteLE32(rw, map->tile_width);
+  written += SDL_WriteLE32(rw, map->tile_height);
+  written += SDL_WriteLE32(rw, chunk_size);
+  written += SDL_WriteLE32(rw, num_chunks_x);
+  written += SDL_WriteLE32(rw, num_chunks_y);
+
+  Uint32 offset = (Uint32)(HEADER_SIZE + num_chunks * INDEX_ENTRY_SIZE);
+  for (size_t i=0; i<num_chunks; i++)
+  {
+    written += SDL_WriteLE32(rw, offset);
+    written += SDL_WriteLE32(rw, sizes[i]);
+    offset += sizes[i];
+  }
+
+  written += SDL_RWwrite(rw, data, data_size, 1);
+  SDL_RWclose(rw);
+  free(data);
+  free(sizes);
+
+  if (written != 10 + num_chunks * 2 + 1)
+  {
+    SDL_Log("Unable to write all of compressed map into %s", path);
+    return false;
+  }
+  return true;
+}
+
+static Uint32 decode_le32(const Uint8* p)
+{
+  return (Uint32)p[0] | ((Uint32)p[1] << 8) | ((Uint32)p[2] << 16) | ((Uint32)p[3] << 24);
+}
+
+TileMapFile* TileMapFile_open(const char* path)
+{
+  SDL_RWops* rw = SDL_RWFromFile(path, "rb");
+  if (rw == NULL)
+  {
+    SDL_Log("Unable to open %s: %s", path, SDL_GetError());
+    return NULL;
+  }
+
+  Uint8 header[HEADER_SIZE];
+  if (SDL_RWread(rw, header, sizeof(header), 1) != 1)
+  {
+    SDL_Log("Compressed map %s is truncated", path);
+    SDL_RWclose(rw);
+    return NULL;
+  }
+
+  Uint32 h[HEADER_SIZE / 4];
+  for (int i=0; i<HEADER_SIZE / 4; i++)
+  {
+    h[i] = decode_le32(header + i * 4);
+  }
+  if (h[0] != FILE_MAGIC || h[1] != FILE_VERSION)
+  {
+    SDL_Log("Compressed map %s has unknown format", path);
+    SDL_RWclose(rw);
+    return NULL;
+  }
+
+  const Uint32 type_size = h[2];
+  const Uint32 num_columns = h[3];
+  const Uint32 num_rows = h[4];
+  const Uint32 chunk_size = h[7];
+  const Uint32 num_chunks_x = h[8];
+  const Uint32 num_chunks_y = h[9];
+  if (type_size != sizeof(TileMapType))
+  {
+    SDL_Log("Compressed map %s has %u bytes per tile type, expected %u", path, type_size, (unsigned)sizeof(TileMapType));
+    SDL_RWclose(rw);
+    return NULL;
+  }
+  if (num_columns == 0 || num_rows == 0 || num_columns > MAX_DIMENSION || num_rows > MAX_DIMENSION ||
+      chunk_size == 0 || chunk_size > TILEMAPFILE_MAX_CHUNK_SIZE ||
+      num_chunks_x != (num_columns + chunk_size - 1) / chunk_size ||
+      num_chunks_y != (num_rows + chunk_size - 1) / chunk_size)
+  {
+    SDL_Log("Compressed map %s has invalid dimension", path);
+    SDL_RWclose(rw);
+    return NULL;
+  }
+
+  // index has to fit in file, before allocating anything for it
+  const size_t num_chunks = (size_t)num_chunks_x * num_chunks_y;
+  const Sint64 file_size = SDL_RWsize(rw);
+  if (file_size < 0 || (Uint64)HEADER_SIZE + (Uint64)num_chunks * INDEX_ENTRY_SIZE > (Uint64)file_size)
+  {
+    SDL_Log("Compressed map %s is truncated", path);
+    SDL_RWclose(rw);
+    return NULL;
+  }
+
+  TileMapFile* file = malloc(sizeof(TileMapFile));
+  if (file == NULL)
+  {
+    SDL_RWclose(rw);
+    return NULL;
+  }
+  file->rw = rw;
+  file->type_size = (int)type_size;
+  file->num_columns = (int)num_columns;
+  file->num_rows = (int)num_rows;
+  file->tile_width = (int)h[5];
+  file->tile_height = (int)h[6];
+  file->chunk_size = (int)chunk_size;
+  file->num_chunks_x = (int)num_chunks_x;
+  file->num_chunks_y = (int)num_chunks_y;
+  file->max_chunk_size = 0;
+
+  file->chunk_offsets = malloc(sizeof(Uint32) * num_chunks);
+  file->chunk_sizes = malloc(sizeof(Uint32) * num_chunks);
+  file->decompressed = malloc(chunk_size * chunk_size * type_size);
+  file->compressed = NULL;
+  Uint8* index = malloc(num_chunks * INDEX_ENTRY_SIZE);
+  if (file->chunk_offsets == NULL || file->chunk_sizes == NULL || file->decompressed == NULL || index == NULL)
+  {
+    SDL_Log("Unable to allocate memory for TileMapFile");
+    free(index);
+    TileMapFile_close(file);
+    return NULL;
+  }
+
+  if (SDL_RWread(rw, index, num_chunks * INDEX_ENTRY_SIZE, 1) != 1)
+  {
+    SDL_Log("Compressed map %s is truncated", path);
+    free(index);
+    TileMapFile_close(file);
+    return NULL;
+  }
+  for (size_t i=0; i<num_chunks; i++)
+  {
+    file->chunk_offsets[i] = decode_le32(index + i * INDEX_ENTRY_SIZE);
+    file->chunk_sizes[i] = decode_le32(index + i * INDEX_ENTRY_SIZE + 4);
+    if ((Uint64)file->chunk_offsets[i] + file->chunk_sizes[i] > (Uint64)file_size)
+    {
+      SDL_Log("Compressed map %s has chunk past the end of file", path);
+      free(index);
+      TileMapFile_close(file);
+      return NULL;
+    }
+    if (file->chunk_sizes[i] > file->max_chunk_size)
+    {
+      file->max_chunk_size = file->chunk_sizes[i];
+    }
+  }
+  free(index);
+
+  // reject sizes no codec could produce, before allocating for them
+  if (file->max_chunk_size > MAX_COMPRESSED_SIZE)
+  {
+    SDL_Log("Compressed map %s has invalid chunk size", path);
+    TileMapFile_close(file);
+    return NULL;
+  }
+  file->compressed = malloc(file->max_chunk_size > 0 ? file->max_chunk_size : 1);
+  if (file->compressed == NULL)
+  {
+    SDL_Log("Unable to allocate memory for TileMapFile");
+    TileMapFile_close(file);
+    return NULL;
+  }
+
+  return file;
+}
+
+bool TileMapFile_read_chunk(TileMapFile* file, int chunk_x, int chunk_y, TileMap* map)
+{
+  if ((unsigned)chunk_x >= (unsigned)file->num_chunks_x || (unsigned)chunk_y >= (unsigned)file->num_chunks_y ||
+      map->num_columns != file->num_columns || map->num_rows != file->num_rows)
+  {
+    SDL_Log("Chunk (%d, %d) is outside of compressed map, or map has different dimension", chunk_x, chunk_y);
+    return false;
+  }
+
+  const size_t i = (size_t)chunk_y * file->num_chunks_x + chunk_x;
+  const Uint32 size = file->chunk_sizes[i];
+  if (size == 0 ||
+      SDL_RWseek(file->rw, file->chunk_offsets[i], RW_SEEK_SET) < 0 ||
+      SDL_RWread(file->rw, file->compressed, size, 1) != 1)
+  {
+    SDL_Log("Unable to read chunk (%d, %d)", chunk_x, chunk_y);
+    return false;
+  }
+
+  int col, row, w, h;
+  chunk_region(file->num_columns, file->num_rows, file->chunk_size, chunk_x, chunk_y, &col, &row, &w, &h);
+  const size_t raw_size = (size_t)w * h * file->type_size;
+
+  bool ok = false;
+  switch (file->compressed[0])
+  {
+    case TILEMAPFILE_CODEC_RAW:
+      ok = size - 1 == raw_size;
+      if (ok)
+        memcpy(file->decompressed, file->compressed + 1, raw_size);
+      break;
+    case TILEMAPFILE_CODEC_RLE:
+      ok = rle_decompress(file->compressed + 1, size - 1, file->type_size, file->decompressed, raw_size);
+      break;
+    case TILEMAPFILE_CODEC_LZ:
+      ok = lz_decompress(file->compressed + 1, size - 1, file->decompressed, raw_size);
+      break;
+    default:
+      break;
+  }
+  if (!ok)
+  {
+    SDL_Log("Chunk (%d, %d) is corrupted", chunk_x, chunk_y);
+    return false;
+  }
+
+  // scatter little-endian types into rows of map
+  const Uint8* p = file->decompressed;
+  for (int r=0; r<h; r++)
+  {
+    for (int c=0; c<w; c++)
+    {
+      TileMapType type = 0;
+      for (int b=0; b<file->type_size; b++)
+      {
+        type |= (TileMapType)(*p++ << (b * 8));
+      }
+      TileMap_set(map, col + c, row + r, type);
+    }
+  }
+
+  return true;
+}
+
+TileMap* TileMapFile_load(const char* path)
+{
+  TileMapFile* file = TileMapFile_open(path);
+  if (file == NULL)
+  {
+    return NULL;
+  }
+
+  TileMap* map = TileMap_new(file->num_columns, file->num_rows, file->tile_width, file->tile_height);
+  if (map == NULL)
+  {
+    TileMapFile_close(file);
+    return NULL;
+  }
+
+  for (int cy=0; cy<file->num_chunks_y; cy++)
+  {
+    for (int cx=0; cx<file->num_chunks_x; cx++)
+    {
+      if (!TileMapFile_read_chunk(file, cx, cy, map))
+      {
+        TileMap_free(map);
+        TileMapFile_close(file);
+        return NULL;
+      }
+    }
+  }
+
+  TileMapFile_close(file);
+  return map;
+}
+
+void TileMapFile_close(TileMapFile* file)
+{
+  if (file == NULL)
+  {
+    return;
+  }
+
+  if (file->rw != NULL)
+  {
+    SDL_RWclose(file->rw);
+    file->rw = NULL;
+  }
+  free(file->chunk_offsets);
+  free(file->chunk_sizes);
+  free(file->compressed);
+  free(file->decompressed);
+  free(file);
+}
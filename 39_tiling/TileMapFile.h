@@ -0,0 +1,125 @@
+#ifndef TileMapFile_h_
+#define TileMapFile_h_
+
+#include "SDL.h"
+#include "TileMap.h"
+#include <stdbool.h>
+
+/// default number of tiles along each side of chunk
+#define TILEMAPFILE_DEFAULT_CHUNK_SIZE 32
+
+/// maximum number of tiles along each side of chunk
+#define TILEMAPFILE_MAX_CHUNK_SIZE 128
+
+///
+/// Codec of chunk
+///
+typedef enum {
+  /// tile types as is
+  TILEMAPFILE_CODEC_RAW,
+  /// runs of the same tile type, good for flat regions
+  TILEMAPFILE_CODEC_RLE,
+  /// LZ77-style literals and back-references, good for repeating patterns
+  TILEMAPFILE_CODEC_LZ
+} TileMapFileCodec;
+
+///
+/// Compressed tile map file opened for reading.
+///
+/// Map is divided into square chunks of tiles, each compressed independently with whichever
+/// codec makes it smallest. File starts with header then index of chunk offsets, so any chunk
+/// can be read and decompressed without touching the rest of file.
+///
+/// All values are little-endian.
+///
+///   header: magic, version, bytes per tile type, num_columns, num_rows, tile_width, tile_height,
+///           chunk_size, num_chunks_x, num_chunks_y (all 32-bit)
+///   index: for each chunk in row-major order, 32-bit offset from start of file and 32-bit size
+///   chunks: codec (8-bit) followed by compressed tiles of chunk in row-major order
+///
+typedef struct
+{
+  /// (read-only) opened file
+  SDL_RWops* rw;
+
+  /// (read-only) number of columns of map
+  int num_columns;
+
+  /// (read-only) number of rows of map
+  int num_rows;
+
+  /// (read-only) tile width in pixels
+  int tile_width;
+
+  /// (read-only) tile height in pixels
+  int tile_height;
+
+  /// (read-only) number of tiles along each side of chunk, chunks on right and bottom edges can be smaller
+  int chunk_size;
+
+  /// (read-only) number of chunks horizontally
+  int num_chunks_x;
+
+  /// (read-only) number of chunks vertically
+  int num_chunks_y;
+
+  /// (read-only) bytes per tile type in file
+  int type_size;
+
+  /// (read-only) offset of each chunk from start of file
+  Uint32* chunk_offsets;
+
+  /// (read-only) size of each chunk in bytes including its codec
+  Uint32* chunk_sizes;
+
+  /// (internal) buffers for reading compressed chunk, and decompressing it
+  Uint8* compressed;
+  Uint8* decompressed;
+  Uint32 max_chunk_size;
+} TileMapFile;
+
+///
+/// Save TileMap into compressed file.
+///
+/// \param map TileMap to save
+/// \param path Path to output file
+/// \param chunk_size Number of tiles along each side of chunk, up to TILEMAPFILE_MAX_CHUNK_SIZE
+/// \return True if saved successfully, otherwise return false.
+///
+extern bool TileMapFile_save(const TileMap* map, const char* path, int chunk_size);
+
+///
+/// Open compressed file for reading chunks. Only header and index are read.
+///
+/// \param path Path to compressed file
+/// \return Newly opened TileMapFile, or NULL if failed.
+///
+extern TileMapFile* TileMapFile_open(const char* path);
+
+///
+/// Read and decompress a single chunk into its region of TileMap.
+///
+/// \param file Opened TileMapFile
+/// \param chunk_x Column of chunk
+/// \param chunk_y Row of chunk
+/// \param map TileMap with the same number of columns and rows as file
+/// \return True if read successfully, otherwise return false.
+///
+extern bool TileMapFile_read_chunk(TileMapFile* file, int chunk_x, int chunk_y, TileMap* map);
+
+///
+/// Load the whole compressed file into a new TileMap.
+///
+/// \param path Path to compressed file
+/// \return Newly created TileMap, or NULL if failed.
+///
+extern TileMap* TileMapFile_load(const char* path);
+
+///
+/// Close TileMapFile.
+///
+/// \param file TileMapFile to be closed
+///
+extern void TileMapFile_close(TileMapFile* file);
+
+#endif
@@ -0,0 +1,304 @@
+#if defined(__unix__) || defined(__APPLE__)
+// for mmap()
+#define _POSIX_C_SOURCE 200112L
+#define TILEMAPPARSER_MMAP
+#endif
+
+#include "TileMapParser.h"
+#include "LParallel.h"
+#include <stdlib.h>
+#include <stdbool.h>
+#ifdef TILEMAPPARSER_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+typedef enum {
+  PARSE_OK,
+  PARSE_INVALID_CHARACTER,
+  PARSE_TYPE_TOO_LARGE,
+  PARSE_WRONG_NUM_TILES
+} ParseResult;
+
+// part of text starting and ending at line boundaries
+typedef struct {
+  const char* begin;
+  const char* end;
+
+  // number of non-empty lines, counted in first pass
+  int num_rows;
+  // row of map its first non-empty line goes to, known after first pass
+  int first_row;
+
+  // result of second pass, and row at which it failed
+  ParseResult result;
+  int error_row;
+} Chunk;
+
+typedef struct {
+  Chunk* chunks;
+  TileMap* map;
+} ParseContext;
+
+static bool is_space(char c)
+{
+  return c == ' ' || c == '\t' || c == '\r';
+}
+
+static const char* find_eol(const char* p, const char* end)
+{
+  while (p < end && *p != '\n') p++;
+  return p;
+}
+
+static bool is_empty_line(const char* p, const char* eol)
+{
+  while (p < eol && is_space(*p)) p++;
+  return p == eol;
+}
+
+// parse tiles in line [p, eol) into row
+// on success, return PARSE_OK with out_num_tiles set to number of tiles in line
+// out_row can be NULL to only count tiles
+static ParseResult parse_line(const char* p, const char* eol, TileMapType* out_row, int max_tiles, int* out_num_tiles)
+{
+  const unsigned max_type = (TileMapType)~0u;
+  int n = 0;
+  while (true)
+  {
+    while (p < eol && is_space(*p)) p++;
+    if (p == eol)
+    {
+      break;
+    }
+
+    // hand-written conversion, types are non-negative so there's no sign to handle
+    if (*p < '0' || *p > '9')
+    {
+      return PARSE_INVALID_CHARACTER;
+    }
+    unsigned value = 0;
+    while (p < eol && *p >= '0' && *p <= '9')
+    {
+      value = value * 10 + (unsigned)(*p - '0');
+      if (value > max_type)
+      {
+        return PARSE_TYPE_TOO_LARGE;
+      }
+      p++;
+    }
+    if (p < eol && !is_space(*p))
+    {
+      return PARSE_INVALID_CHARACTER;
+    }
+
+    if (out_row != NULL)
+    {
+      if (n >= max_tiles)
+      {
+        return PARSE_WRONG_NUM_TILES;
+      }
+      out_row[n] = (TileMapType)value;
+    }
+    n++;
+  }
+
+  *out_num_tiles = n;
+  return PARSE_OK;
+}
+
+// first pass: count rows in chunk
+static void count_rows_job(void* ctx, int job, int worker)
+{
+  Chunk* c = ((ParseContext*)ctx)->chunks + job;
+  c->num_rows = 0;
+  for (const char* p = c->begin; p < c->end; )
+  {
+    const char* eol = find_eol(p, c->end);
+    if (!is_empty_line(p, eol))
+    {
+      c->num_rows++;
+    }
+    p = eol + 1;
+  }
+}
+
+// second pass: tokenize rows of chunk directly into map
+static void parse_rows_job(void* ctx, int job, int worker)
+{
+  ParseContext* pc = ctx;
+  TileMap* map = pc->map;
+  Chunk* c = pc->chunks + job;
+  int row = c->first_row;
+
+  c->result = PARSE_OK;
+  for (const char* p = c->begin; p < c->end; )
+  {
+    const char* eol = find_eol(p, c->end);
+    if (!is_empty_line(p, eol))
+    {
+      int num_tiles = 0;
+      ParseResult result = parse_line(p, eol, map->types + (size_t)row * map->num_columns, map->num_columns, &num_tiles);
+      if (result == PARSE_OK && num_tiles != map->num_columns)
+      {
+        result = PARSE_WRONG_NUM_TILES;
+      }
+      if (result != PARSE_OK)
+      {
+        c->result = result;
+        c->error_row = row;
+        return;
+      }
+      row++;
+    }
+    p = eol + 1;
+  }
+}
+
+TileMap* TileMapParser_parse(const char* text, size_t size, int tile_width, int tile_height, int num_threads)
+{
+  const char* end = text + size;
+
+  // number of columns comes from the first non-empty line
+  int num_columns = 0;
+  for (const char* p = text; p < end && num_columns == 0; )
+  {
+    const char* eol = find_eol(p, end);
+    if (parse_line(p, eol, NULL, 0, &num_columns) != PARSE_OK)
+    {
+      SDL_Log("Map has invalid first row");
+      return NULL;
+    }
+    p = eol + 1;
+  }
+  if (num_columns == 0)
+  {
+    SDL_Log("Map has no tiles");
+    return NULL;
+  }
+
+  // split into chunks at line boundaries, small text goes into a single chunk
+  num_threads = LParallel_num_threads(num_threads);
+  int num_chunks = (int)SDL_min((size_t)(num_threads * 4), size / TILEMAPPARSER_MIN_CHUNK_SIZE);
+  num_chunks = SDL_max(1, SDL_min(num_chunks, TILEMAPPARSER_MAX_CHUNKS));
+
+  Chunk chunks[TILEMAPPARSER_MAX_CHUNKS];
+  const char* p = text;
+  int n = 0;
+  for (int i=0; i<num_chunks && p < end; i++)
+  {
+    const char* chunk_end = i == num_chunks - 1 ? end : text + size / num_chunks * (i + 1);
+    if (chunk_end < p)
+    {
+      chunk_end = p;
+    }
+    // extend to the end of line, newline itself included
+    chunk_end = find_eol(chunk_end, end);
+    if (chunk_end < end)
+    {
+      chunk_end++;
+    }
+
+    chunks[n].begin = p;
+    chunks[n].end = chunk_end;
+    n++;
+    p = chunk_end;
+  }
+  num_chunks = n;
+
+  ParseContext ctx = { chunks, NULL };
+  LParallel_run(num_chunks, num_threads, count_rows_job, &ctx);
+
+  int num_rows = 0;
+  for (int i=0; i<num_chunks; i++)
+  {
+    chunks[i].first_row = num_rows;
+    num_rows += chunks[i].num_rows;
+  }
+
+  ctx.map = TileMap_new(num_columns, num_rows, tile_width, tile_height);
+  if (ctx.map == NULL)
+  {
+    return NULL;
+  }
+
+  LParallel_run(num_chunks, num_threads, parse_rows_job, &ctx);
+
+  // report the first error, rows are in order of chunks
+  for (int i=0; i<num_chunks; i++)
+  {
+    if (chunks[i].result == PARSE_OK)
+    {
+      continue;
+    }
+
+    switch (chunks[i].result)
+    {
+      case PARSE_INVALID_CHARACTER:
+        SDL_Log("Map has invalid character at row %d", chunks[i].error_row);
+        break;
+      case PARSE_TYPE_TOO_LARGE:
+        SDL_Log("Map has tile type too large at row %d", chunks[i].error_row);
+        break;
+      default:
+        SDL_Log("Map has row %d with number of tiles other than %d", chunks[i].error_row, num_columns);
+        break;
+    }
+    TileMap_free(ctx.map);
+    return NULL;
+  }
+
+  return ctx.map;
+}
+
+TileMap* TileMapParser_load(const char* path, int tile_width, int tile_height, int num_threads)
+{
+#ifdef TILEMAPPARSER_MMAP
+  int fd = open(path, O_RDONLY);
+  if (fd < 0)
+  {
+    SDL_Log("Error attempting to read %s file", path);
+    return NULL;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0)
+  {
+    SDL_Log("Error reading %s file, it's empty or its size is unknown", path);
+    close(fd);
+    return NULL;
+  }
+
+  const size_t size = (size_t)st.st_size;
+  void* data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // mapping stays valid after closing file
+  close(fd);
+  if (data == MAP_FAILED)
+  {
+    SDL_Log("Error mapping %s file into memory", path);
+    return NULL;
+  }
+
+  TileMap* map = TileMapParser_parse(data, size, tile_width, tile_height, num_threads);
+  munmap(data, size);
+#else
+  size_t size = 0;
+  void* data = SDL_LoadFile(path, &size);
+  if (data == NULL)
+  {
+    SDL_Log("Error attempting to read %s file: %s", path, SDL_GetError());
+    return NULL;
+  }
+
+  TileMap* map = TileMapParser_parse(data, size, tile_width, tile_height, num_threads);
+  SDL_free(data);
+#endif
+
+  if (map == NULL)
+  {
+    SDL_Log("Failed to parse %s file", path);
+  }
+  return map;
+}
@@ -0,0 +1,42 @@
+#ifndef TileMapParser_h_
+#define TileMapParser_h_
+
+#include "SDL.h"
+#include "TileMap.h"
+
+/// smallest part of text in bytes to be parsed as a single job, small maps are parsed by calling thread alone
+#define TILEMAPPARSER_MIN_CHUNK_SIZE (64 * 1024)
+
+/// maximum number of parts text is split into
+#define TILEMAPPARSER_MAX_CHUNKS 256
+
+///
+/// Parse text map in the same format as lazy.map into TileMap.
+/// Tile types are non-negative integers separated by spaces, one row per line.
+/// Empty lines are skipped, and all rows must have the same number of tiles as the first one.
+///
+/// Text is split at line boundaries into chunks which are tokenized on worker threads,
+/// each writing directly into its rows of TileMap.
+///
+/// \param text Text to parse, it doesn't need to be null-terminated
+/// \param size Size of text in bytes
+/// \param tile_width Tile width in pixels
+/// \param tile_height Tile height in pixels
+/// \param num_threads Number of threads, 0 to use number of CPU cores
+/// \return Newly created TileMap, or NULL if failed.
+///
+extern TileMap* TileMapParser_parse(const char* text, size_t size, int tile_width, int tile_height, int num_threads);
+
+///
+/// Load text map file into TileMap, see TileMapParser_parse().
+/// File is memory-mapped where supported, otherwise it's read into memory at once.
+///
+/// \param path Path to map file
+/// \param tile_width Tile width in pixels
+/// \param tile_height Tile height in pixels
+/// \param num_threads Number of threads, 0 to use number of CPU cores
+/// \return Newly created TileMap, or NULL if failed.
+///
+extern TileMap* TileMapParser_load(const char* path, int tile_width, int tile_height, int num_threads);
+
+#endif
@@ -0,0 +1,46 @@
+/**
+ * Build step tool to convert text map (as lazy.map) into chunk-compressed map file, see TileMapFile.h.
+ *
+ * Usage: mapcompress <map-path> <output-path> [chunk-size]
+ */
+
+#include "SDL.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include "TileMap.h"
+#include "TileMapParser.h"
+#include "TileMapFile.h"
+
+// as from tiles.png texture
+#define TILE_WIDTH 80
+#define TILE_HEIGHT 80
+
+int main(int argc, char* argv[])
+{
+  if (argc < 3)
+  {
+    fprintf(stderr, "Usage: %s <map-path> <output-path> [chunk-size]\n", argv[0]);
+    return 1;
+  }
+
+  const char* map_path = argv[1];
+  const char* output_path = argv[2];
+  const int chunk_size = argc > 3 ? atoi(argv[3]) : TILEMAPFILE_DEFAULT_CHUNK_SIZE;
+
+  TileMap* map = TileMapParser_load(map_path, TILE_WIDTH, TILE_HEIGHT, 0);
+  if (map == NULL)
+  {
+    fprintf(stderr, "Unable to load %s\n", map_path);
+    return 1;
+  }
+
+  if (!TileMapFile_save(map, output_path, chunk_size))
+  {
+    fprintf(stderr, "Unable to save %s\n", output_path);
+    TileMap_free(map);
+    return 1;
+  }
+
+  TileMap_free(map);
+  return 0;
+}
@@ -10,7 +10,10 @@
 #include "LWindow.h"
 #include "LTexture.h"
 #include "LTimer.h"
-#include "Tile.h"
+#include "TileMap.h"
+#include "TileMapParser.h"
+#include "TileMapFile.h"
+#include "Autotile.h"
 #include "Dot.h"
 #include "krr_math.h"
 #include "bound_sys.h"
@@ -35,7 +38,7 @@ bool setup();
 void update(float deltaTime);
 void handleEvent(SDL_Event *e, float deltaTime);
 void render(float deltaTime);
-void close();
+static void close();
 
 // -- variables
 bool quit = false;
@@ -61,6 +64,13 @@ SDL_Rect content_rect = { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT };
 // number of tile type
 #define TOTAL_TILETYPE 12
 
+// minimap showing the whole map at heavily minified scale on top-left corner
+#define MINIMAP_SCALE 0.1f
+#define MINIMAP_X 10
+#define MINIMAP_Y 10
+// number of downscaled levels for tiles texture, tile's dimension (80) is still divisible by 2^4
+#define TILES_MIP_LEVELS 4
+
 // type of tile
 enum TileType {
   TILETYPE_RED,
@@ -91,6 +101,33 @@ SDL_Rect tiles_clipped_rects[TOTAL_TILETYPE] = {
   { TILE_WIDTH, TILE_HEIGHT, TILE_WIDTH, TILE_HEIGHT },
   { TILE_WIDTH, 0, TILE_WIDTH, TILE_HEIGHT }
 };
+// floor type at tile, same checkered pattern as in lazy.map
+#define FLOOR_TYPE(col, row) (((col) + (row)) % (TILETYPE_BLUE + 1))
+
+// walls are autotiled, so map only needs to mark where walls are with any wall type
+// tiles texture has no inner corners nor one-tile-thick pieces, so those cases fall back to the closest piece
+Autotile wall_autotile = {
+  TILETYPE_CENTER,
+  TILETYPE_TOPLEFT,
+  {
+    TILETYPE_CENTER,      // isolated
+    TILETYPE_BOTTOM,      // up
+    TILETYPE_TOPLEFT,     // right
+    TILETYPE_BOTTOMLEFT,  // up, right
+    TILETYPE_TOP,         // down
+    TILETYPE_LEFT,        // up, down
+    TILETYPE_TOPLEFT,     // right, down
+    TILETYPE_LEFT,        // up, right, down
+    TILETYPE_TOPRIGHT,    // left
+    TILETYPE_BOTTOMRIGHT, // up, left
+    TILETYPE_TOP,         // right, left
+    TILETYPE_BOTTOM,      // up, right, left
+    TILETYPE_TOPRIGHT,    // down, left
+    TILETYPE_RIGHT,       // up, down, left
+    TILETYPE_TOP,         // right, down, left
+    TILETYPE_CENTER       // all
+  }
+};
 
 // use dot as player, then camera follows it
 Camera cam;
@@ -99,33 +136,35 @@ LTexture* dot_texture = NULL;
 BoundSystem bound_system;
 
 // tiles related stuff
-// we will read from map file in run-time then allocate memory and initialize attributes
-// for all tiles as well as setting then number of tiles (num_tiles)
+// we will read from map file in run-time then allocate tile map holding type of all tiles
 LTexture* tiles_texture = NULL;
-Tile* tiles = NULL;
+TileMap* tilemap = NULL;
 // map attributes, will be set after reading from map file
-int num_tiles = 0;
-int map_num_rows;
-int map_num_columns;
 int level_width;
 int level_height;
 
 // check touching of walls (tiles) from circle
-bool touch_walls(Circle circle, Tile* tiles, int num_tiles, int* delta_collisionx, int* delta_collisiony)
+bool touch_walls(Circle circle, const TileMap* map, int* delta_collisionx, int* delta_collisiony)
 {
-  // go through the tiles
-  Tile* tile = NULL;
-  for (int i=0; i<num_tiles; i++)
-  {
-    // get tile
-    tile = tiles + i;
+  // only tiles overlapping with circle's bounding box can collide with it
+  SDL_Rect bounds = { circle.x - circle.r, circle.y - circle.r, circle.r * 2, circle.r * 2 };
+  int first_col, first_row, last_col, last_row;
+  TileMap_get_range(map, &bounds, &first_col, &first_row, &last_col, &last_row);
 
-    // if the tile is a wall
-    if (tile->type >= TILETYPE_CENTER && tile->type <= TILETYPE_TOPLEFT)
+  // go through the tiles in row-major order
+  for (int row=first_row; row<=last_row; row++)
+  {
+    for (int col=first_col; col<=last_col; col++)
     {
-      if (krr_math_checkCollision_cr(circle, tile->box, delta_collisionx, delta_collisiony))
+      const int type = TileMap_get(map, col, row);
+
+      // if the tile is a wall
+      if (type >= TILETYPE_CENTER && type <= TILETYPE_TOPLEFT)
       {
-        return true;
+        if (krr_math_checkCollision_cr(circle, TileMap_get_box(map, col, row), delta_collisionx, delta_collisiony))
+        {
+          return true;
+        }
       }
     }
   }
@@ -133,149 +172,6 @@ bool touch_walls(Circle circle, Tile* tiles, int num_tiles, int* delta_collision
   return false;
 }
 
-#define FILE_BUFFER 1024
-// read input mapfile
-// return via parameters number of map rows, and number of map columns as seen in parameters
-// and out_tiles is an array pointer dynamically created, user has to free it when done using it.
-// return true or false based on whether operation is successful.
-void read_mapfile(const char* path, Tile** out_tiles, int* out_num_map_rows, int* out_num_map_columns)
-{
-  FILE* fp = fopen(path, "r");
-  if (fp == NULL)
-  {
-    SDL_Log("error attempting to read  %s file", path);
-    return;
-  }
-
-  // determine the file size for reading
-  fseek(fp, 0, SEEK_END);
-  int file_size = ftell(fp);
-  // rewind back
-  fseek(fp, 0, SEEK_SET);
-
-  // check if file size is more than our buffer can hold
-  if (file_size > FILE_BUFFER)
-  {
-    SDL_Log("file read buffer cannot hold file size more than %d bytes.\nFile input has size %d bytes", FILE_BUFFER, file_size);
-    fclose(fp);
-    return;
-  }
-
-  // buffer to hold read string
-  char read_buff[FILE_BUFFER];
-  // clear content of read buffer preparing for reading
-  memset(read_buff, 0, FILE_BUFFER);
-
-  // read file for FILE_BUFFER bytes in one shot
-  int read_objs = fread(read_buff, file_size, 1, fp);
-  if (read_objs != 1)
-  {
-    SDL_Log("error reading file, cannot reading content");
-    fclose(fp);
-    fp = NULL;
-    return;
-  }
-  // check end of file
-  if (feof(fp) > 0)
-  {
-    const char* error_msg = NULL;
-    perror(error_msg);
-    SDL_Log("error reading file, end of file : %s", error_msg);
-    fclose(fp);
-    fp = NULL;
-    return;
-  }
-  // check for error
-  if (ferror(fp) > 0)
-  {
-    const char* error_msg = NULL;
-    // get error message
-    perror(error_msg);
-    SDL_Log("error reading %s file : %s", path, error_msg);
-    fclose(fp);
-    fp = NULL;
-    return;
-  }
-
-  // close file
-  fclose(fp);
-  fp = NULL;
-
-  // get number of lines and number of columns in file from read buffer
-  int numlines = 0;
-  int numcolumns = 0;
-  int str_len = strlen(read_buff);
-  bool counting_done = false;
-
-  for (int i=0; i<str_len; i++)
-  {
-    if (read_buff[i] == '\n')
-    {
-      numlines++;
-      counting_done = true;
-    }
-    else if (read_buff[i] == ' ' && !counting_done)
-    {
-      numcolumns++;
-    }
-  }
-  numcolumns++;
-
-
-  // set to result variables if user inputs it
-  if (out_num_map_rows != NULL)
-  {
-    *out_num_map_rows = numlines;
-  }
-  if (out_num_map_columns != NULL)
-  {
-    *out_num_map_columns = numcolumns;
-  }
-
-  SDL_Log("num rows: %d", numlines);
-  SDL_Log("num cols: %d", numcolumns);
-
-  // dynamically created tile array
-  Tile* tiles = malloc(sizeof(Tile) * numlines * numcolumns);
-  // delimit both newline and space character
-  char delims[] = "\n ";
-
-  char *token_ptr = strtok(read_buff, delims);
-  int col_counter = -1;
-  int row_counter = 0;
-  while (token_ptr != NULL)
-  {
-    col_counter++;
-    if (col_counter >= numcolumns)
-    {
-      // increment row counter
-      row_counter++;
-      // reset column counter to new row
-      col_counter = 0;
-    }
-
-    // calculate byte offset from tiles
-    int offset = row_counter * numcolumns + col_counter;
-    // convert to type of tile
-    int type = atoi(token_ptr);
-
-    // initialize tile individually
-    Tile_init(tiles + offset, col_counter * TILE_WIDTH, row_counter * TILE_HEIGHT, TILE_WIDTH, TILE_HEIGHT, type);
-
-    // proceed next
-    token_ptr = strtok(NULL, delims);
-  }
-  
-  // set result tiles to output pointer
-  // note: now out_tiles points to memory allocated which pointed to by tiles
-  // later tiles (pointer) will be free as it's out of scope but
-  // our out_tiles will still be there and points to actual allocated memory
-  // see https://www.eskimo.com/~scs/cclass/int/sx8.html and https://stackoverflow.com/a/4339219/571227
-  // for more info to understand double pointer
-  // and modifying value of pointer passed to function
-  *out_tiles = tiles;
-}
-
 bool init() {
   // initialize sdl
   if (SDL_Init(SDL_INIT_VIDEO) < 0) {
@@ -333,25 +229,34 @@ bool setup()
   }
 
   // load tiles texture
-  tiles_texture = LTexture_LoadFromFile("tiles.png");
+  // with downscaled levels as minimap renders it at small scale
+  tiles_texture = LTexture_LoadFromFileWithMipmaps("tiles.png", false, 0x00, 0x00, 0x00, TILES_MIP_LEVELS);
   if (tiles_texture == NULL)
   {
     SDL_Log("Failed to create texture from tiles.png");
     return false;
   }
 
-  // read map file (lazy.map) then initialize all tiles instance, and other attributes
-  read_mapfile("lazy.map", &tiles, &map_num_rows , &map_num_columns);
-  if (tiles == NULL)
+  // read compressed map (lazy.tmc, generated by mapcompress at build time) into tile map
+  // otherwise fall back to text map (lazy.map) which is parsed in parallel, then set other attributes
+  tilemap = TileMapFile_load("lazy.tmc");
+  if (tilemap == NULL)
   {
-    SDL_Log("tiles pointer is null");
+    SDL_Log("No valid lazy.tmc, reading lazy.map instead");
+    tilemap = TileMapParser_load("lazy.map", TILE_WIDTH, TILE_HEIGHT, 0);
   }
+  if (tilemap == NULL)
+  {
+    SDL_Log("Failed to read lazy.map");
+    return false;
+  }
+
+  // derive edges and corners of walls
+  Autotile_apply(&wall_autotile, tilemap);
 
   // calculate level width/height
-  level_width = TILE_WIDTH * map_num_columns;
-  level_height = TILE_HEIGHT * map_num_rows;
-  // set total number of tiles
-  num_tiles = map_num_rows * map_num_columns;
+  level_width = TILE_WIDTH * tilemap->num_columns;
+  level_height = TILE_HEIGHT * tilemap->num_rows;
 
   // load dot texture
   dot_texture = LTexture_LoadFromFileWithColorKey("dot.bmp", 0xFF, 0xFF, 0xFF);
@@ -382,7 +287,7 @@ void update(float deltaTime)
   // check dot against tiles
   int delta_collisionx = 0;
   int delta_collisiony = 0;
-  if (touch_walls(dot.collider, tiles, num_tiles, &delta_collisionx, &delta_collisiony))
+  if (touch_walls(dot.collider, tilemap, &delta_collisionx, &delta_collisiony))
   {
     // dot touch with walls, then move dot back
     dot.posX -= delta_collisionx;
@@ -429,6 +334,23 @@ void handleEvent(SDL_Event *e, float deltaTime)
     }
   }
 
+  // toggle wall at clicked tile, only its neighborhood is autotiled again
+  if (e->type == SDL_MOUSEBUTTONDOWN && e->button.button == SDL_BUTTON_LEFT)
+  {
+    // convert from screen to world space
+    const int x = e->button.x + cam.view_rect.x;
+    const int y = e->button.y + cam.view_rect.y;
+    if (x >= 0 && x < level_width && y >= 0 && y < level_height)
+    {
+      const int col = x / TILE_WIDTH;
+      const int row = y / TILE_HEIGHT;
+      if (Autotile_is_solid(&wall_autotile, tilemap, col, row))
+        Autotile_set(&wall_autotile, tilemap, col, row, FLOOR_TYPE(col, row));
+      else
+        Autotile_set(&wall_autotile, tilemap, col, row, TILETYPE_CENTER);
+    }
+  }
+
   // dot control
   if (e->type == SDL_KEYDOWN && e->key.repeat == 0)
   {
@@ -480,25 +402,38 @@ void render(float deltaTime)
     SDL_SetRenderDrawColor(gWindow->renderer, 0xff, 0xff, 0xff, 0xff);
     SDL_RenderFillRect(gWindow->renderer, &content_rect);
 
-    // check if tile is visible within sight of camera then render it
-    int temp_collision_deltax = 0;
-    int temp_collision_deltay = 0;
-
-    Tile* temp_tile = NULL;
-
-    for (int i=0; i<num_tiles; i++)
+    // render only tiles visible within sight of camera
+    int first_col, first_row, last_col, last_row;
+    TileMap_get_range(tilemap, &cam.view_rect, &first_col, &first_row, &last_col, &last_row);
+    for (int row=first_row; row<=last_row; row++)
     {
-      // get tile
-      temp_tile = tiles + i;
-
-      if (krr_math_checkCollision(cam.view_rect, temp_tile->box, &temp_collision_deltax, &temp_collision_deltay))
+      for (int col=first_col; col<=last_col; col++)
       {
-        LTexture_ClippedRender(tiles_texture, temp_tile->x - cam.view_rect.x, temp_tile->y - cam.view_rect.y, &tiles_clipped_rects[temp_tile->type]);
+        LTexture_ClippedRender(tiles_texture, col * TILE_WIDTH - cam.view_rect.x, row * TILE_HEIGHT - cam.view_rect.y, &tiles_clipped_rects[TileMap_get(tilemap, col, row)]);
       }
     }
 
     Dot_Render_w_camera(&dot, cam.view_rect.x, cam.view_rect.y);
 
+    // render minimap
+    // LTexture_ClippedRenderEx() scales around center of clip, so offset position back to top-left corner
+    // downscaled level of tiles texture will be automatically selected according to scale
+    int minimap_tile_w = TILE_WIDTH * MINIMAP_SCALE;
+    int minimap_tile_h = TILE_HEIGHT * MINIMAP_SCALE;
+    int minimap_offset_x = TILE_WIDTH/2 - (int)(TILE_WIDTH/2 * MINIMAP_SCALE);
+    int minimap_offset_y = TILE_HEIGHT/2 - (int)(TILE_HEIGHT/2 * MINIMAP_SCALE);
+    for (int row=0; row<tilemap->num_rows; row++)
+    {
+      for (int col=0; col<tilemap->num_columns; col++)
+      {
+        LTexture_ClippedRenderEx(tiles_texture, MINIMAP_X + col * minimap_tile_w - minimap_offset_x, MINIMAP_Y + row * minimap_tile_h - minimap_offset_y, MINIMAP_SCALE, &tiles_clipped_rects[TileMap_get(tilemap, col, row)], 0, NULL, SDL_FLIP_NONE);
+      }
+    }
+    // outline camera's view on minimap
+    SDL_Rect minimap_view = { MINIMAP_X + cam.view_rect.x * MINIMAP_SCALE, MINIMAP_Y + cam.view_rect.y * MINIMAP_SCALE, cam.view_rect.w * MINIMAP_SCALE, cam.view_rect.h * MINIMAP_SCALE };
+    SDL_SetRenderDrawColor(gWindow->renderer, 0xff, 0xff, 0xff, 0xff);
+    SDL_RenderDrawRect(gWindow->renderer, &minimap_view);
+
 #ifndef DISABLE_FPS_CALC
     // render fps on the top right corner
     snprintf(fpsText, FPS_BUFFER-1, "%d", (int)common_avgFPS);
@@ -515,7 +450,7 @@ void render(float deltaTime)
   }
 }
 
-void close()
+static void close()
 {
   // free font
   if (gFont != NULL)
@@ -532,23 +467,11 @@ void close()
   if (dot_texture != NULL)
     LTexture_Free(dot_texture);
 
-  // tiles
-  if (tiles != NULL)
+  // tile map
+  if (tilemap != NULL)
   {
-    // free internals for all individual tiles
-    for (int i=0; i<num_tiles; i++)
-    {
-      // free internals, not free it memory space yet
-      Tile_free_internals(tiles + i);
-    }
-
-    // free allocated memory space
-    // note: as allocated space is for all of tiles, free it once for all
-    free(tiles);
-    tiles = NULL;
-
-    // for safety (but not necessary)
-    num_tiles = 0;
+    TileMap_free(tilemap);
+    tilemap = NULL;
   }
 
   // destroy window
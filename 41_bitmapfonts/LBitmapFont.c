@@ -1,5 +1,10 @@
 #include "LBitmapFont.h"
 #include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 static void init_defaults(LBitmapFont* bfont)
 {
@@ -31,36 +36,172 @@ bool LBitmapFont_init(LBitmapFont* bfont)
   return true; 
 }
 
-bool LBitmapFont_buildfont(LBitmapFont* bfont, LTexture* bitmap, int num_rows, int num_columns)
+#define METRICS_MAGIC 0x4D46424C /* 'LBFM' */
+#define METRICS_VERSION 1
+
+///
+/// Set bit of non-background pixels of a single row into out_words.
+/// out_words has to be zero-initialized before calling this function.
+///
+static void build_row_mask(const Uint32* row, int width, Uint32 bg_color, Uint64* out_words)
 {
-  // go through the bitmap font and define all the clip rectangles for all the sprites.
-  
-  // lock texture to access its pixel data
-  if (!LTexture_LockTexture(bitmap))
+  int x = 0;
+#ifdef __SSE2__
+  // compare 8 pixels at a time, 8 bits never straddle 64-bit word as x is multiple of 8
+  const __m128i bg = _mm_set1_epi32((int)bg_color);
+  for (; x + 8 <= width; x += 8)
   {
-    SDL_Log("Cannot lock texture to access its pixel data: %s", SDL_GetError());
-    return false;
+    __m128i p0 = _mm_loadu_si128((const __m128i*)(row + x));
+    __m128i p1 = _mm_loadu_si128((const __m128i*)(row + x + 4));
+    int eq = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(p0, bg))) |
+      (_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(p1, bg))) << 4);
+    out_words[x >> 6] |= (Uint64)(~eq & 0xff) << (x & 63);
   }
+#endif
+  for (; x < width; x++)
+  {
+    if (row[x] != bg_color)
+    {
+      out_words[x >> 6] |= (Uint64)1 << (x & 63);
+    }
+  }
+}
+
+static int lowest_bit(Uint64 v)
+{
+#if defined(__GNUC__)
+  return __builtin_ctzll(v);
+#else
+  int i = 0;
+  while ((v & 1) == 0) { v >>= 1; i++; }
+  return i;
+#endif
+}
+
+static int highest_bit(Uint64 v)
+{
+#if defined(__GNUC__)
+  return 63 - __builtin_clzll(v);
+#else
+  int i = 63;
+  while ((v & ((Uint64)1 << 63)) == 0) { v <<= 1; i--; }
+  return i;
+#endif
+}
+
+///
+/// Mask of bits in word index w that fall into range [start, start+count).
+///
+static Uint64 range_mask(int w, int start, int count)
+{
+  int lo = start - w*64;
+  int hi = start + count - w*64;
+  Uint64 mask = ~(Uint64)0;
+  if (lo > 0) mask &= ~(Uint64)0 << lo;
+  if (hi < 64) mask &= ((Uint64)1 << hi) - 1;
+  return mask;
+}
+
+///
+/// Find first set bit within range [start, start+count) of bitmask.
+/// Return index relative to start, or -1 if not found.
+///
+static int find_first_bit(const Uint64* words, int start, int count)
+{
+  for (int w = start >> 6; w <= (start + count - 1) >> 6; w++)
+  {
+    Uint64 bits = words[w] & range_mask(w, start, count);
+    if (bits != 0)
+    {
+      return w*64 + lowest_bit(bits) - start;
+    }
+  }
+  return -1;
+}
+
+///
+/// Find last set bit within range [start, start+count) of bitmask.
+/// Return index relative to start, or -1 if not found.
+///
+static int find_last_bit(const Uint64* words, int start, int count)
+{
+  for (int w = (start + count - 1) >> 6; w >= start >> 6; w--)
+  {
+    Uint64 bits = words[w] & range_mask(w, start, count);
+    if (bits != 0)
+    {
+      return w*64 + highest_bit(bits) - start;
+    }
+  }
+  return -1;
+}
+
+void LBitmapFont_buildfont_from_pixels(LBitmapFont* bfont, const Uint32* pixels, int pitch, int width, int height, int num_rows, int num_columns)
+{
+  // go through the bitmap font and define all the clip rectangles for all the sprites.
+  // pixels are visited in row-major order once; each row is turned into bitmask of non-background pixels
+  // then projected into per-cell column and row occupancy, bounds are found with bit scans.
+  int pitch_pixels = pitch / 4;
 
   // set background color
   // note: position 0,0 needs to be no character bitmap, that area is empty
   // see bitmap file
-  Uint32 bgColor = LTexture_GetPixel32(bitmap, 0, 0);
+  Uint32 bgColor = pixels[0];
 
   // set the cell dimensions
-  int cell_w = bitmap->width / num_columns;
-  int cell_h = bitmap->height / num_rows;
+  int cell_w = width / num_columns;
+  int cell_h = height / num_rows;
 
   // new line variable
   int top = cell_h;
   int baseA = cell_h;
 
+  // bitmask of a single image row, and OR of all row masks across a cell row (column occupancy)
+  int num_words = (width + 63) / 64;
+  Uint64* row_bits = malloc(sizeof(Uint64) * num_words);
+  Uint64* column_bits = malloc(sizeof(Uint64) * num_words);
+  // first and last occupied pixel row of each cell in the current cell row (row occupancy)
+  int* first_row = malloc(sizeof(int) * num_columns);
+  int* last_row = malloc(sizeof(int) * num_columns);
+
   // the current character we're setting
   int current_char = 0;
 
   // go through the cell rows
   for (int rows = 0; rows < num_rows; rows++)
   {
+    memset(column_bits, 0, sizeof(Uint64) * num_words);
+    for (int cols = 0; cols < num_columns; cols++)
+    {
+      first_row[cols] = -1;
+      last_row[cols] = -1;
+    }
+
+    // project each pixel row of this cell row
+    for (int prow = 0; prow < cell_h; prow++)
+    {
+      const Uint32* row = pixels + (rows * cell_h + prow) * pitch_pixels;
+      memset(row_bits, 0, sizeof(Uint64) * num_words);
+      build_row_mask(row, width, bgColor, row_bits);
+
+      for (int w = 0; w < num_words; w++)
+      {
+        column_bits[w] |= row_bits[w];
+      }
+
+      for (int cols = 0; cols < num_columns; cols++)
+      {
+        if (find_first_bit(row_bits, cols * cell_w, cell_w) != -1)
+        {
+          if (first_row[cols] == -1)
+          {
+            first_row[cols] = prow;
+          }
+          last_row[cols] = prow;
+        }
+      }
+    }
+
     // go through the cell columns
     for (int cols = 0; cols < num_columns; cols++)
     {
@@ -72,101 +213,40 @@ bool LBitmapFont_buildfont(LBitmapFont* bfont, LTexture* bitmap, int num_rows, i
       bfont->chars[current_char].w = cell_w;
       bfont->chars[current_char].h = cell_h;
 
-      // find left side
-      // go through pixel column to find the first non-bg pixel then we mark x position
-      for (int pcol=0; pcol<cell_w; pcol++)
+      // find left and right side from column occupancy
+      int left = find_first_bit(column_bits, cols * cell_w, cell_w);
+      if (left != -1)
       {
-        // go through pixel row
-        for (int prow=0; prow<cell_h; prow++)
-        {
-          // find offset to get pixel data
-          int x = (cols * cell_w) + pcol;
-          int y = (rows * cell_h) + prow;
+        int right = find_last_bit(column_bits, cols * cell_w, cell_w);
 
-          if (LTexture_GetPixel32(bitmap, x, y) != bgColor)
-          {
-            // set x offset
-            bfont->chars[current_char].x = x;
-
-            // use goto to break inner and outer loop
-            // use 'break' will only break the inner loop
-            goto BREAK_THE_LOOP;
-          }
-        }
+        // set x offset and width
+        bfont->chars[current_char].x = (cols * cell_w) + left;
+        bfont->chars[current_char].w = right - left + 1;
       }
-BREAK_THE_LOOP:
-      // find right side
-      for (int pcol = cell_w-1; pcol >= 0; pcol--)
-      {
-        for (int prow = 0; prow < cell_h; prow++)
-        {
-          // find offset to get pixel data
-          int x = (cols * cell_w) + pcol;
-          int y = (rows * cell_h) + prow;
 
-          if (LTexture_GetPixel32(bitmap, x, y) != bgColor)
-          {
-            // set width
-            bfont->chars[current_char].w = (x - bfont->chars[current_char].x) + 1;
-
-            // break the loop
-            goto BREAK_THE_LOOP2;
-          }
-        }
-      }
-BREAK_THE_LOOP2:
       // find top
-      for (int prow=0; prow<cell_h; prow++)
+      // for height, we want all bitmap chars to have same height
+      if (first_row[cols] != -1 && first_row[cols] < top)
       {
-        for (int pcol=0; pcol<cell_w; pcol++)
-        {
-          // find offset to get pixel data
-          int x = (cols * cell_w) + pcol;
-          int y = (rows * cell_h) + prow;
-
-          if (LTexture_GetPixel32(bitmap, x, y) != bgColor)
-          {
-            // if new top if found
-            // for height, we want all bitmap chars to have same height
-            if (prow < top)
-            {
-              top = prow;
-            }
-
-            // break the loop
-            goto BREAK_THE_LOOP3;
-          }
-        }
+        top = first_row[cols];
       }
-BREAK_THE_LOOP3:
+
       // find bottom
       // only use A as baseline
-      if (current_char == 'A')
+      if (current_char == 'A' && last_row[cols] != -1)
       {
-        for (int prow=cell_h-1; prow>=0; prow--)
-        {
-          for (int pcol=0; pcol<cell_w; pcol++)
-          {
-            // find offset to get pixel data
-            int x = (cols * cell_w) + pcol;
-            int y = (rows * cell_h) + prow;
-
-            if (LTexture_GetPixel32(bitmap, x, y) != bgColor)
-            {
-              // bottom of A is found
-              baseA = prow;
-
-              // break the loop
-              goto BREAK_THE_LOOP4;
-            }
-          }
-        }
+        baseA = last_row[cols];
       }
-BREAK_THE_LOOP4:
+
       // go to next character
       current_char++;
     }
   }
+
+  free(row_bits);
+  free(column_bits);
+  free(first_row);
+  free(last_row);
   
   // calculate space
   bfont->space = cell_w / 2;
@@ -180,10 +260,163 @@ BREAK_THE_LOOP4:
     bfont->chars[i].y += top;
     bfont->chars[i].h -= top;
   }
+}
+
+bool LBitmapFont_buildfont(LBitmapFont* bfont, LTexture* bitmap, int num_rows, int num_columns)
+{
+  // prefer reading from shadow pixels as locked pixels are write-only,
+  // otherwise lock texture to access its pixel data
+  if (bitmap->shadow_pixels != NULL)
+  {
+    LBitmapFont_buildfont_from_pixels(bfont, bitmap->shadow_pixels, bitmap->shadow_pitch, bitmap->width, bitmap->height, num_rows, num_columns);
+  }
+  else
+  {
+    if (!LTexture_LockTexture(bitmap))
+    {
+      SDL_Log("Cannot lock texture to access its pixel data: %s", SDL_GetError());
+      return false;
+    }
+
+    LBitmapFont_buildfont_from_pixels(bfont, bitmap->pixels, bitmap->pitch, bitmap->width, bitmap->height, num_rows, num_columns);
+
+    // unlock texture
+    LTexture_UnlockTexture(bitmap);
+  }
 
-  // unlock texture
-  LTexture_UnlockTexture(bitmap);
   bfont->bitmap = bitmap;
+  return true;
+}
+
+bool LBitmapFont_buildfont_with_metrics(LBitmapFont* bfont, LTexture* bitmap, const char* image_path, int num_rows, int num_columns)
+{
+  char metrics_path[256];
+  snprintf(metrics_path, sizeof(metrics_path), "%s%s", image_path, LBITMAPFONT_METRICS_EXT);
+
+  Uint64 image_hash = 0;
+  if (LBitmapFont_hash_file(image_path, &image_hash) &&
+      LBitmapFont_load_metrics(bfont, metrics_path, image_hash, num_rows, num_columns))
+  {
+    bfont->bitmap = bitmap;
+    return true;
+  }
+
+  SDL_Log("No valid metrics file %s, scanning bitmap instead", metrics_path);
+  return LBitmapFont_buildfont(bfont, bitmap, num_rows, num_columns);
+}
+
+bool LBitmapFont_hash_file(const char* path, Uint64* out_hash)
+{
+  SDL_RWops* file = SDL_RWFromFile(path, "rb");
+  if (file == NULL)
+  {
+    SDL_Log("Unable to open %s: %s", path, SDL_GetError());
+    return false;
+  }
+
+  // 64-bit FNV-1a
+  Uint64 hash = 0xcbf29ce484222325ULL;
+  Uint8 buffer[4096];
+  size_t read_bytes = 0;
+  while ((read_bytes = SDL_RWread(file, buffer, 1, sizeof(buffer))) > 0)
+  {
+    for (size_t i=0; i<read_bytes; i++)
+    {
+      hash ^= buffer[i];
+      hash *= 0x100000001b3ULL;
+    }
+  }
+  SDL_RWclose(file);
+
+  *out_hash = hash;
+  return true;
+}
+
+bool LBitmapFont_save_metrics(const LBitmapFont* bfont, const char* metrics_path, Uint64 image_hash, int num_rows, int num_columns)
+{
+  SDL_RWops* file = SDL_RWFromFile(metrics_path, "wb");
+  if (file == NULL)
+  {
+    SDL_Log("Unable to open %s for writing: %s", metrics_path, SDL_GetError());
+    return false;
+  }
+
+  // write in little-endian regardless of platform
+  size_t written = 0;
+  written += SDL_WriteLE32(file, METRICS_MAGIC);
+  written += SDL_WriteLE32(file, METRICS_VERSION);
+  written += SDL_WriteLE64(file, image_hash);
+  written += SDL_WriteLE32(file, num_rows);
+  written += SDL_WriteLE32(file, num_columns);
+  written += SDL_WriteLE32(file, bfont->space);
+  written += SDL_WriteLE32(file, bfont->newline);
+  for (int i=0; i<256; i++)
+  {
+    written += SDL_WriteLE32(file, bfont->chars[i].x);
+    written += SDL_WriteLE32(file, bfont->chars[i].y);
+    written += SDL_WriteLE32(file, bfont->chars[i].w);
+    written += SDL_WriteLE32(file, bfont->chars[i].h);
+  }
+  SDL_RWclose(file);
+
+  // each write returns 1 on success
+  if (written != 7 + 256*4)
+  {
+    SDL_Log("Unable to write all metrics into %s", metrics_path);
+    return false;
+  }
+  return true;
+}
+
+bool LBitmapFont_load_metrics(LBitmapFont* bfont, const char* metrics_path, Uint64 image_hash, int num_rows, int num_columns)
+{
+  SDL_RWops* file = SDL_RWFromFile(metrics_path, "rb");
+  if (file == NULL)
+  {
+    return false;
+  }
+
+  // read the whole file at once, then decode
+  // magic, version, hash, rows, columns, space, newline, then 256 rects
+  Uint8 buffer[4*2 + 8 + 4*4 + 256*4*4];
+  size_t read_bytes = SDL_RWread(file, buffer, 1, sizeof(buffer));
+  SDL_RWclose(file);
+  if (read_bytes != sizeof(buffer))
+  {
+    SDL_Log("Metrics file %s is truncated", metrics_path);
+    return false;
+  }
+
+  const Uint8* p = buffer;
+#define READ_LE32(p) ((Uint32)(p)[0] | ((Uint32)(p)[1] << 8) | ((Uint32)(p)[2] << 16) | ((Uint32)(p)[3] << 24))
+  Uint32 magic = READ_LE32(p); p += 4;
+  Uint32 version = READ_LE32(p); p += 4;
+  Uint64 hash = READ_LE32(p) | ((Uint64)READ_LE32(p + 4) << 32); p += 8;
+  Sint32 rows = READ_LE32(p); p += 4;
+  Sint32 columns = READ_LE32(p); p += 4;
+
+  if (magic != METRICS_MAGIC || version != METRICS_VERSION)
+  {
+    SDL_Log("Metrics file %s has unknown format", metrics_path);
+    return false;
+  }
+  if (hash != image_hash || rows != num_rows || columns != num_columns)
+  {
+    SDL_Log("Metrics file %s is outdated", metrics_path);
+    return false;
+  }
+
+  bfont->space = (Sint32)READ_LE32(p); p += 4;
+  bfont->newline = (Sint32)READ_LE32(p); p += 4;
+  for (int i=0; i<256; i++)
+  {
+    bfont->chars[i].x = (Sint32)READ_LE32(p);
+    bfont->chars[i].y = (Sint32)READ_LE32(p + 4);
+    bfont->chars[i].w = (Sint32)READ_LE32(p + 8);
+    bfont->chars[i].h = (Sint32)READ_LE32(p + 12);
+    p += 16;
+  }
+#undef READ_LE32
 
   return true;
 }
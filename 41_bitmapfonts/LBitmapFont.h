@@ -3,6 +3,9 @@
 
 #include "LTexture.h"
 
+/// extension appended to path of font image to get path of its metrics file
+#define LBITMAPFONT_METRICS_EXT ".metrics"
+
 typedef struct {
   /// font texture
   /// (not manage in freeing this attribute)
@@ -43,6 +46,70 @@ extern bool LBitmapFont_init(LBitmapFont* bfont);
 ///
 extern bool LBitmapFont_buildfont(LBitmapFont* bfont, LTexture* bitmap, int num_rows, int num_columns);
 
+///
+/// Build font from metrics file persisted next to font image (image_path + LBITMAPFONT_METRICS_EXT).
+/// Metrics file is valid only if it was generated from the same image content, checked via its hash.
+/// If metrics file is missing or invalid, it falls back to scan bitmap via LBitmapFont_buildfont().
+///
+/// Use buildfontmetrics tool (see Makefile) to generate metrics file as part of build step.
+///
+/// \param bfont LBitmapFont
+/// \param bitmap LTexture to build font from
+/// \param image_path Path to image file that bitmap is loaded from
+/// \param num_rows Number of rows for input bitmap
+/// \param num_columns Number of column for input bitmap
+/// \return True if build font successfully, otherwise return false
+///
+extern bool LBitmapFont_buildfont_with_metrics(LBitmapFont* bfont, LTexture* bitmap, const char* image_path, int num_rows, int num_columns);
+
+///
+/// Compute glyph metrics by scanning pixels data directly.
+/// This doesn't set bitmap to bfont, it's intended for offline tool to generate metrics file.
+///
+/// \param bfont LBitmapFont
+/// \param pixels Pixels data in 32 bit per pixel format
+/// \param pitch Pitch in bytes of pixels data
+/// \param width Width of image
+/// \param height Height of image
+/// \param num_rows Number of rows for input bitmap
+/// \param num_columns Number of column for input bitmap
+///
+extern void LBitmapFont_buildfont_from_pixels(LBitmapFont* bfont, const Uint32* pixels, int pitch, int width, int height, int num_rows, int num_columns);
+
+///
+/// Compute hash of file content.
+///
+/// \param path Path to file
+/// \param out_hash Result hash
+/// \return True if file can be read, otherwise return false.
+///
+extern bool LBitmapFont_hash_file(const char* path, Uint64* out_hash);
+
+///
+/// Save glyph metrics of bfont into file.
+///
+/// \param bfont LBitmapFont that has been built
+/// \param metrics_path Path to metrics file to write
+/// \param image_hash Hash of font image, see LBitmapFont_hash_file()
+/// \param num_rows Number of rows of font image
+/// \param num_columns Number of columns of font image
+/// \return True if save successfully, otherwise return false.
+///
+extern bool LBitmapFont_save_metrics(const LBitmapFont* bfont, const char* metrics_path, Uint64 image_hash, int num_rows, int num_columns);
+
+///
+/// Load glyph metrics from file into bfont.
+/// This doesn't set bitmap to bfont.
+///
+/// \param bfont LBitmapFont
+/// \param metrics_path Path to metrics file to read
+/// \param image_hash Expected hash of font image. It fails if not match with the one in file.
+/// \param num_rows Expected number of rows of font image
+/// \param num_columns Expected number of columns of font image
+/// \return True if load successfully, otherwise return false.
+///
+extern bool LBitmapFont_load_metrics(LBitmapFont* bfont, const char* metrics_path, Uint64 image_hash, int num_rows, int num_columns);
+
 ///
 /// Render text
 ///
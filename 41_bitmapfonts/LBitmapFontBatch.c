@@ -0,0 +1,275 @@
+#include "LBitmapFontBatch.h"
+#include "common.h"
+#include <stdlib.h>
+#include <string.h>
+
+/// grow vertices array to hold at least required vertices
+/// return false if fail to allocate
+static bool grow_vertices(SDL_Vertex** vertices, int* capacity, int required)
+{
+  if (required <= *capacity)
+  {
+    return true;
+  }
+
+  int new_capacity = *capacity == 0 ? 256 : *capacity;
+  while (new_capacity < required)
+  {
+    new_capacity *= 2;
+  }
+
+  SDL_Vertex* new_vertices = realloc(*vertices, sizeof(SDL_Vertex) * new_capacity);
+  if (new_vertices == NULL)
+  {
+    SDL_Log("Unable to allocate memory for text vertices");
+    return false;
+  }
+  *vertices = new_vertices;
+  *capacity = new_capacity;
+  return true;
+}
+
+/// count number of characters that produce a quad
+static int count_quads(const char* text)
+{
+  int n = 0;
+  for (const char* c = text; *c != '\0'; c++)
+  {
+    if (*c != ' ' && *c != '\n')
+    {
+      n++;
+    }
+  }
+  return n;
+}
+
+/// lay out text into vertices starting at (x, y) with color
+/// follows the same rules as LBitmapFont_rendertext(), vertices must have enough room
+/// return number of vertices written
+static int layout_text(const LBitmapFont* bfont, float x, float y, const char* text, SDL_Color color, SDL_Vertex* out, int* out_width, int* out_height)
+{
+  float inv_w = 1.0f / bfont->bitmap->width;
+  float inv_h = 1.0f / bfont->bitmap->height;
+
+  int curX = 0;
+  int curY = 0;
+  int longest_width = 0;
+  int n = 0;
+
+  for (const char* c = text; *c != '\0'; c++)
+  {
+    if (*c == ' ')
+    {
+      curX += bfont->space;
+    }
+    else if (*c == '\n')
+    {
+      curY += bfont->newline;
+      if (curX > longest_width)
+        longest_width = curX;
+      curX = 0;
+    }
+    else
+    {
+      const SDL_Rect* clip = &bfont->chars[(unsigned char)*c];
+      float x0 = x + curX;
+      float y0 = y + curY;
+      float x1 = x0 + clip->w;
+      float y1 = y0 + clip->h;
+      float u0 = clip->x * inv_w;
+      float v0 = clip->y * inv_h;
+      float u1 = (clip->x + clip->w) * inv_w;
+      float v1 = (clip->y + clip->h) * inv_h;
+
+      // top-left, top-right, bottom-left, bottom-right
+      out[n++] = (SDL_Vertex){ {x0, y0}, color, {u0, v0} };
+      out[n++] = (SDL_Vertex){ {x1, y0}, color, {u1, v0} };
+      out[n++] = (SDL_Vertex){ {x0, y1}, color, {u0, v1} };
+      out[n++] = (SDL_Vertex){ {x1, y1}, color, {u1, v1} };
+
+      // move over the width of the character with one pixel of padding
+      curX += clip->w + 1;
+    }
+  }
+
+  if (out_width != NULL)
+    *out_width = curX > longest_width ? curX : longest_width;
+  if (out_height != NULL)
+    *out_height = curY;
+
+  return n;
+}
+
+/// make sure batch has room for additional quads
+static bool reserve_quads(LBitmapFontBatch* batch, int num_quads)
+{
+  int old_capacity = batch->capacity_vertices;
+  if (!grow_vertices(&batch->vertices, &batch->capacity_vertices, batch->num_vertices + num_quads*4))
+  {
+    return false;
+  }
+
+  // indices only depend on capacity, fill in new part once
+  if (batch->capacity_vertices != old_capacity)
+  {
+    int* new_indices = realloc(batch->indices, sizeof(int) * (batch->capacity_vertices / 4) * 6);
+    if (new_indices == NULL)
+    {
+      SDL_Log("Unable to allocate memory for text indices");
+      // indices still cover only old capacity, larger vertex buffer is fine to keep
+      batch->capacity_vertices = old_capacity;
+      return false;
+    }
+    batch->indices = new_indices;
+
+    for (int q = old_capacity / 4; q < batch->capacity_vertices / 4; q++)
+    {
+      int* idx = batch->indices + q*6;
+      int v = q*4;
+      idx[0] = v; idx[1] = v + 1; idx[2] = v + 2;
+      idx[3] = v + 2; idx[4] = v + 1; idx[5] = v + 3;
+    }
+  }
+  return true;
+}
+
+LBitmapFontBatch* LBitmapFontBatch_new(LBitmapFont* bfont)
+{
+  LBitmapFontBatch* out = malloc(sizeof(LBitmapFontBatch));
+  out->bfont = bfont;
+  out->vertices = NULL;
+  out->num_vertices = 0;
+  out->capacity_vertices = 0;
+  out->indices = NULL;
+  out->color = (SDL_Color){255, 255, 255, 255};
+  return out;
+}
+
+void LBitmapFontBatch_begin(LBitmapFontBatch* batch)
+{
+  batch->num_vertices = 0;
+}
+
+void LBitmapFontBatch_setcolor(LBitmapFontBatch* batch, SDL_Color color)
+{
+  batch->color = color;
+}
+
+bool LBitmapFontBatch_addtext(LBitmapFontBatch* batch, int x, int y, const char* text)
+{
+  if (batch->bfont->bitmap == NULL)
+  {
+    SDL_Log("Bitmap font has not built its font yet. Build first before rendering text.");
+    return false;
+  }
+
+  if (!reserve_quads(batch, count_quads(text)))
+  {
+    return false;
+  }
+
+  batch->num_vertices += layout_text(batch->bfont, x, y, text, batch->color, batch->vertices + batch->num_vertices, NULL, NULL);
+  return true;
+}
+
+bool LBitmapFontBatch_addcached(LBitmapFontBatch* batch, const LBitmapFontText* ctext, int x, int y)
+{
+  if (!reserve_quads(batch, ctext->num_vertices / 4))
+  {
+    return false;
+  }
+
+  SDL_Vertex* out = batch->vertices + batch->num_vertices;
+  for (int i=0; i<ctext->num_vertices; i++)
+  {
+    out[i].position.x = ctext->vertices[i].position.x + x;
+    out[i].position.y = ctext->vertices[i].position.y + y;
+    out[i].color = batch->color;
+    out[i].tex_coord = ctext->vertices[i].tex_coord;
+  }
+  batch->num_vertices += ctext->num_vertices;
+  return true;
+}
+
+bool LBitmapFontBatch_flush(LBitmapFontBatch* batch)
+{
+  if (batch->num_vertices == 0)
+  {
+    return true;
+  }
+
+  int result = SDL_RenderGeometry(gWindow->renderer, batch->bfont->bitmap->texture, batch->vertices, batch->num_vertices, batch->indices, (batch->num_vertices / 4) * 6);
+  batch->num_vertices = 0;
+
+  if (result != 0)
+  {
+    SDL_Log("Unable to render text batch: %s", SDL_GetError());
+    return false;
+  }
+  return true;
+}
+
+void LBitmapFontBatch_free(LBitmapFontBatch* batch)
+{
+  free(batch->vertices);
+  free(batch->indices);
+  free(batch);
+}
+
+LBitmapFontText* LBitmapFontText_new()
+{
+  LBitmapFontText* out = malloc(sizeof(LBitmapFontText));
+  out->text = NULL;
+  out->text_capacity = 0;
+  out->vertices = NULL;
+  out->num_vertices = 0;
+  out->capacity_vertices = 0;
+  out->width = 0;
+  out->height = 0;
+  return out;
+}
+
+bool LBitmapFontText_set(LBitmapFontText* ctext, LBitmapFont* bfont, const char* text)
+{
+  // nothing changed, keep current layout
+  if (ctext->text != NULL && strcmp(ctext->text, text) == 0)
+  {
+    return true;
+  }
+
+  if (bfont->bitmap == NULL)
+  {
+    SDL_Log("Bitmap font has not built its font yet.");
+    return false;
+  }
+
+  // keep copy of text for comparison next time
+  int len = strlen(text);
+  if (len + 1 > ctext->text_capacity)
+  {
+    char* new_text = realloc(ctext->text, len + 1);
+    if (new_text == NULL)
+    {
+      SDL_Log("Unable to allocate memory for text");
+      return false;
+    }
+    ctext->text = new_text;
+    ctext->text_capacity = len + 1;
+  }
+
+  if (!grow_vertices(&ctext->vertices, &ctext->capacity_vertices, count_quads(text) * 4))
+  {
+    return false;
+  }
+
+  memcpy(ctext->text, text, len + 1);
+  ctext->num_vertices = layout_text(bfont, 0.0f, 0.0f, text, (SDL_Color){255, 255, 255, 255}, ctext->vertices, &ctext->width, &ctext->height);
+  return true;
+}
+
+void LBitmapFontText_free(LBitmapFontText* ctext)
+{
+  free(ctext->text);
+  free(ctext->vertices);
+  free(ctext);
+}
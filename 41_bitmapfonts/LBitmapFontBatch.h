@@ -0,0 +1,140 @@
+#ifndef LBitmapFontBatch_h_
+#define LBitmapFontBatch_h_
+
+#include "SDL.h"
+#include <stdbool.h>
+#include "LBitmapFont.h"
+
+///
+/// Batch of text quads of a single LBitmapFont to be drawn with one SDL_RenderGeometry() call.
+///
+/// Usage per frame
+///   LBitmapFontBatch_begin()
+///   LBitmapFontBatch_addtext() / LBitmapFontBatch_addcached() as many as needed
+///   LBitmapFontBatch_flush()
+///
+/// Note: SDL_RenderGeometry() doesn't apply texture's color modulation, use LBitmapFontBatch_setcolor() instead.
+/// Requires SDL 2.0.18 or newer.
+///
+typedef struct {
+  /// font to render with
+  /// (not manage in freeing this attribute)
+  LBitmapFont* bfont;
+
+  /// vertices of all quads in the batch, 4 vertices per quad
+  SDL_Vertex* vertices;
+  int num_vertices;
+  int capacity_vertices;
+
+  /// indices for all quads, always filled up to capacity as the pattern doesn't change
+  int* indices;
+
+  /// color of vertices for subsequently added text
+  SDL_Color color;
+} LBitmapFontBatch;
+
+///
+/// Laid-out quads of a string relative to its origin.
+/// Layout is re-done only when string changes, thus text that stays the same across frames
+/// only has to be translated into the batch.
+///
+typedef struct {
+  /// copy of laid-out string
+  char* text;
+  int text_capacity;
+
+  /// vertices of quads relative to origin, 4 vertices per quad
+  SDL_Vertex* vertices;
+  int num_vertices;
+  int capacity_vertices;
+
+  /// dimension of laid-out text, same as result from LBitmapFont_measuretext()
+  int width;
+  int height;
+} LBitmapFontText;
+
+///
+/// Create a new LBitmapFontBatch
+///
+/// \param bfont LBitmapFont to render with, it should have been built already
+/// \return Newly created LBitmapFontBatch allocated memory space on heap.
+///
+extern LBitmapFontBatch* LBitmapFontBatch_new(LBitmapFont* bfont);
+
+///
+/// Clear all quads in the batch.
+///
+/// \param batch LBitmapFontBatch
+///
+extern void LBitmapFontBatch_begin(LBitmapFontBatch* batch);
+
+///
+/// Set color of subsequently added text.
+///
+/// \param batch LBitmapFontBatch
+/// \param color Color of text
+///
+extern void LBitmapFontBatch_setcolor(LBitmapFontBatch* batch, SDL_Color color);
+
+///
+/// Lay out text and add its quads into the batch.
+///
+/// \param batch LBitmapFontBatch
+/// \param x Position x to render
+/// \param y Position y to render
+/// \param text Text to render
+/// \return True if added successfully, otherwise return false.
+///
+extern bool LBitmapFontBatch_addtext(LBitmapFontBatch* batch, int x, int y, const char* text);
+
+///
+/// Add quads of cached text into the batch, only translating them to x, y.
+///
+/// \param batch LBitmapFontBatch
+/// \param ctext LBitmapFontText laid out by LBitmapFontText_set()
+/// \param x Position x to render
+/// \param y Position y to render
+/// \return True if added successfully, otherwise return false.
+///
+extern bool LBitmapFontBatch_addcached(LBitmapFontBatch* batch, const LBitmapFontText* ctext, int x, int y);
+
+///
+/// Draw all quads in the batch with a single SDL_RenderGeometry() call then clear the batch.
+///
+/// \param batch LBitmapFontBatch
+/// \return True if render successfully, otherwise return false.
+///
+extern bool LBitmapFontBatch_flush(LBitmapFontBatch* batch);
+
+///
+/// Free LBitmapFontBatch
+///
+/// \param batch LBitmapFontBatch to free its allocated memory
+///
+extern void LBitmapFontBatch_free(LBitmapFontBatch* batch);
+
+///
+/// Create a new LBitmapFontText with empty text.
+///
+/// \return Newly created LBitmapFontText allocated memory space on heap.
+///
+extern LBitmapFontText* LBitmapFontText_new();
+
+///
+/// Set text to lay out. If text is the same as current one, nothing is done.
+///
+/// \param ctext LBitmapFontText
+/// \param bfont LBitmapFont to lay out text with
+/// \param text Text to lay out
+/// \return True if set successfully, otherwise return false.
+///
+extern bool LBitmapFontText_set(LBitmapFontText* ctext, LBitmapFont* bfont, const char* text);
+
+///
+/// Free LBitmapFontText
+///
+/// \param ctext LBitmapFontText to free its allocated memory
+///
+extern void LBitmapFontText_free(LBitmapFontText* ctext);
+
+#endif
@@ -0,0 +1,225 @@
+#include "LGlyphAtlas.h"
+#include "LParallel.h"
+#include <stdlib.h>
+#include <string.h>
+
+/// context of rasterizing jobs
+typedef struct {
+  const char* charset;
+  int num_chars;
+  int num_specs;
+
+  /// font handles, num_specs per worker
+  TTF_Font** fonts;
+
+  /// rasterized surface, num_chars per spec
+  SDL_Surface** surfaces;
+  int* advances;
+} RasterContext;
+
+/// rasterize a single character of a single font
+static void raster_job(void* data, int job, int worker)
+{
+  RasterContext* ctx = data;
+  int spec = job / ctx->num_chars;
+  Uint16 ch = (unsigned char)ctx->charset[job % ctx->num_chars];
+  TTF_Font* font = ctx->fonts[worker * ctx->num_specs + spec];
+
+  int advance = 0;
+  TTF_GlyphMetrics(font, ch, NULL, NULL, NULL, NULL, &advance);
+  ctx->advances[job] = advance;
+
+  // space has nothing to draw
+  ctx->surfaces[job] = NULL;
+  if (ch == ' ')
+    return;
+
+  SDL_Color white = {0xff, 0xff, 0xff, 0xff};
+  SDL_Surface* surface = TTF_RenderGlyph_Blended(font, ch, white);
+  if (surface != NULL)
+  {
+    // the same format as atlas, so packing is only copying rows
+    ctx->surfaces[job] = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+    SDL_FreeSurface(surface);
+  }
+}
+
+/// pack rasterized glyphs of a single font into atlas then upload it
+static bool pack_atlas(LGlyphAtlas* atlas, const char* charset, int num_chars, SDL_Surface** surfaces, const int* advances)
+{
+  // shelf packing in charset order, find positions first then fill pixels
+  int pen_x = 0;
+  int pen_y = 0;
+  int row_h = 0;
+  for (int i=0; i<num_chars; i++)
+  {
+    LGlyphAtlas_glyph* glyph = &atlas->glyphs[(unsigned char)charset[i]];
+    glyph->advance = advances[i];
+    glyph->present = true;
+    glyph->rect.x = 0;
+    glyph->rect.y = 0;
+    glyph->rect.w = 0;
+    glyph->rect.h = 0;
+
+    SDL_Surface* s = surfaces[i];
+    if (s == NULL)
+      continue;
+
+    if (pen_x + s->w > LGLYPHATLAS_WIDTH)
+    {
+      pen_x = 0;
+      pen_y += row_h + LGLYPHATLAS_PADDING;
+      row_h = 0;
+    }
+    glyph->rect.x = pen_x;
+    glyph->rect.y = pen_y;
+    glyph->rect.w = s->w;
+    glyph->rect.h = s->h;
+    pen_x += s->w + LGLYPHATLAS_PADDING;
+    if (s->h > row_h)
+      row_h = s->h;
+  }
+  int height = pen_y + row_h;
+  if (height == 0)
+    height = 1;
+
+  Uint32* pixels = calloc(LGLYPHATLAS_WIDTH * height, sizeof(Uint32));
+  if (pixels == NULL)
+  {
+    SDL_Log("Unable to allocate memory for glyph atlas");
+    return false;
+  }
+
+  for (int i=0; i<num_chars; i++)
+  {
+    SDL_Surface* s = surfaces[i];
+    if (s == NULL)
+      continue;
+
+    const SDL_Rect* rect = &atlas->glyphs[(unsigned char)charset[i]].rect;
+    SDL_LockSurface(s);
+    for (int y=0; y<s->h; y++)
+    {
+      memcpy(pixels + (rect->y + y) * LGLYPHATLAS_WIDTH + rect->x, (const Uint8*)s->pixels + y * s->pitch, s->w * 4);
+    }
+    SDL_UnlockSurface(s);
+  }
+
+  atlas->texture = LTexture_LoadFromPixels(pixels, LGLYPHATLAS_WIDTH * 4, LGLYPHATLAS_WIDTH, height, SDL_PIXELFORMAT_ARGB8888);
+  free(pixels);
+  if (atlas->texture == NULL)
+  {
+    return false;
+  }
+  LTexture_SetBlendMode(atlas->texture, SDL_BLENDMODE_BLEND);
+  return true;
+}
+
+LGlyphAtlas* LGlyphAtlas_prewarm(const char* charset, const LGlyphAtlas_fontspec* specs, int num_specs, int num_threads)
+{
+  int num_chars = strlen(charset);
+  int num_jobs = num_chars * num_specs;
+  num_threads = LParallel_num_threads(num_threads);
+  if (num_threads > num_jobs)
+    num_threads = num_jobs > 0 ? num_jobs : 1;
+
+  RasterContext ctx;
+  ctx.charset = charset;
+  ctx.num_chars = num_chars;
+  ctx.num_specs = num_specs;
+  ctx.fonts = calloc(num_threads * num_specs, sizeof(TTF_Font*));
+  ctx.surfaces = calloc(num_jobs, sizeof(SDL_Surface*));
+  ctx.advances = calloc(num_jobs, sizeof(int));
+
+  LGlyphAtlas* atlases = calloc(num_specs, sizeof(LGlyphAtlas));
+  bool ok = ctx.fonts != NULL && ctx.surfaces != NULL && ctx.advances != NULL && atlases != NULL;
+
+  // open font handles for each worker on this thread, loading font is not thread-safe either
+  for (int w=0; w<num_threads && ok; w++)
+  {
+    for (int i=0; i<num_specs && ok; i++)
+    {
+      TTF_Font* font = TTF_OpenFont(specs[i].path, specs[i].size);
+      if (font == NULL)
+      {
+        SDL_Log("Unable to open font %s: %s", specs[i].path, TTF_GetError());
+        ok = false;
+      }
+      ctx.fonts[w * num_specs + i] = font;
+    }
+  }
+
+  if (ok)
+  {
+    LParallel_run(num_jobs, num_threads, raster_job, &ctx);
+
+    for (int i=0; i<num_specs && ok; i++)
+    {
+      atlases[i].spec = specs[i];
+      atlases[i].line_height = TTF_FontLineSkip(ctx.fonts[i]);
+      ok = pack_atlas(&atlases[i], charset, num_chars, ctx.surfaces + i * num_chars, ctx.advances + i * num_chars);
+    }
+  }
+
+  if (ctx.fonts != NULL)
+  {
+    for (int i=0; i<num_threads * num_specs; i++)
+    {
+      if (ctx.fonts[i] != NULL)
+        TTF_CloseFont(ctx.fonts[i]);
+    }
+  }
+  if (ctx.surfaces != NULL)
+  {
+    for (int i=0; i<num_jobs; i++)
+    {
+      if (ctx.surfaces[i] != NULL)
+        SDL_FreeSurface(ctx.surfaces[i]);
+    }
+  }
+  free(ctx.fonts);
+  free(ctx.surfaces);
+  free(ctx.advances);
+
+  if (!ok)
+  {
+    if (atlases != NULL)
+      LGlyphAtlas_free(atlases, num_specs);
+    return NULL;
+  }
+  return atlases;
+}
+
+void LGlyphAtlas_rendertext(LGlyphAtlas* atlas, int x, int y, const char* text)
+{
+  int pen_x = x;
+  int pen_y = y;
+
+  for (const char* c = text; *c != '\0'; c++)
+  {
+    if (*c == '\n')
+    {
+      pen_x = x;
+      pen_y += atlas->line_height;
+      continue;
+    }
+
+    LGlyphAtlas_glyph* glyph = &atlas->glyphs[(unsigned char)*c];
+    if (!glyph->present)
+      continue;
+
+    if (glyph->rect.w > 0)
+      LTexture_ClippedRender(atlas->texture, pen_x, pen_y, &glyph->rect);
+    pen_x += glyph->advance;
+  }
+}
+
+void LGlyphAtlas_free(LGlyphAtlas* atlases, int num_atlases)
+{
+  for (int i=0; i<num_atlases; i++)
+  {
+    if (atlases[i].texture != NULL)
+      LTexture_Free(atlases[i].texture);
+  }
+  free(atlases);
+}
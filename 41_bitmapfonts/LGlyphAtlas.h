@@ -0,0 +1,91 @@
+#ifndef LGlyphAtlas_h_
+#define LGlyphAtlas_h_
+
+#include "SDL.h"
+#include "SDL_ttf.h"
+#include <stdbool.h>
+#include "LTexture.h"
+
+/// width of atlas texture, height grows as needed
+#define LGLYPHATLAS_WIDTH 512
+
+/// padding between glyphs in atlas
+#define LGLYPHATLAS_PADDING 1
+
+///
+/// Font and size to prewarm glyphs for.
+///
+typedef struct {
+  /// path to ttf font file
+  const char* path;
+
+  /// point size to open font with
+  int size;
+} LGlyphAtlas_fontspec;
+
+///
+/// Glyph in atlas.
+///
+typedef struct {
+  /// cell of glyph in atlas texture
+  SDL_Rect rect;
+
+  /// horizontal advance to the next glyph
+  int advance;
+
+  /// whether glyph is in atlas
+  bool present;
+} LGlyphAtlas_glyph;
+
+///
+/// Atlas of pre-rendered glyphs for a single font and size, rendered in white.
+/// Use LTexture_SetColor() on its texture to change text color.
+///
+typedef struct {
+  /// font and size of this atlas
+  LGlyphAtlas_fontspec spec;
+
+  /// atlas texture
+  LTexture* texture;
+
+  /// glyphs indexed by character
+  LGlyphAtlas_glyph glyphs[256];
+
+  /// height of a line in pixels
+  int line_height;
+} LGlyphAtlas;
+
+///
+/// Rasterize characters for all fonts and sizes on worker threads up front, then pack and upload
+/// them into one atlas texture per font and size.
+///
+/// TTF_Font is not thread-safe thus each worker thread uses its own font handles,
+/// opened on calling thread before rasterizing.
+///
+/// \param charset Characters to rasterize, each byte is a character
+/// \param specs Fonts and sizes
+/// \param num_specs Number of fonts and sizes
+/// \param num_threads Number of worker threads, 0 to use number of CPU cores
+/// \return Array of num_specs LGlyphAtlas in the same order as specs, or NULL if failed. Free with LGlyphAtlas_free().
+///
+extern LGlyphAtlas* LGlyphAtlas_prewarm(const char* charset, const LGlyphAtlas_fontspec* specs, int num_specs, int num_threads);
+
+///
+/// Render text with atlas. Characters not in atlas are skipped.
+///
+/// \param atlas LGlyphAtlas
+/// \param x Position x to render
+/// \param y Position y to render
+/// \param text Text to render
+///
+extern void LGlyphAtlas_rendertext(LGlyphAtlas* atlas, int x, int y, const char* text);
+
+///
+/// Free array of LGlyphAtlas returned from LGlyphAtlas_prewarm().
+///
+/// \param atlases Array of LGlyphAtlas
+/// \param num_atlases Number of atlases in array
+///
+extern void LGlyphAtlas_free(LGlyphAtlas* atlases, int num_atlases);
+
+#endif
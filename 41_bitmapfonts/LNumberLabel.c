@@ -0,0 +1,245 @@
+#include "LNumberLabel.h"
+#include "common.h"
+#include <stdlib.h>
+#include <string.h>
+
+/// index of character in digit strip, space for unknown character
+static int glyph_index(char c)
+{
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  else if (c == '-')
+    return 10;
+  else if (c == '.')
+    return 11;
+  else
+    return 12;
+}
+
+/// write digits of value into end of buffer, return pointer to the first digit
+static char* write_digits(char* end, unsigned long long value, int min_digits)
+{
+  char* p = end;
+  do
+  {
+    *--p = '0' + (value % 10);
+    value /= 10;
+    min_digits--;
+  } while (value != 0 || min_digits > 0);
+  return p;
+}
+
+/// set text of label, return false if it doesn't fit
+static bool set_text(LNumberLabel* label, const char* text, int len)
+{
+  if (len > label->max_chars)
+  {
+    return false;
+  }
+
+  memcpy(label->text, text, len);
+  label->text[len] = '\0';
+  label->num_chars = len;
+  label->width = len * label->strip->cell_w;
+  return true;
+}
+
+LDigitStrip* LDigitStrip_new(TTF_Font* font)
+{
+  SDL_Color white = {0xff, 0xff, 0xff, 0xff};
+  LTexture* texture = LTexture_LoadFromRenderedText_withFont(LDIGITSTRIP_GLYPHS, font, white, 0);
+  if (texture == NULL)
+  {
+    return NULL;
+  }
+
+  LDigitStrip* out = malloc(sizeof(LDigitStrip));
+  out->texture = texture;
+  out->cell_w = 0;
+  out->cell_h = texture->height;
+
+  // find offset of each glyph from width of text preceding it, so kerning is taken into account
+  char prefix[LDIGITSTRIP_NUM_GLYPHS+1];
+  int prev_x = 0;
+  for (int i=0; i<LDIGITSTRIP_NUM_GLYPHS; i++)
+  {
+    memcpy(prefix, LDIGITSTRIP_GLYPHS, i+1);
+    prefix[i+1] = '\0';
+
+    int x = 0;
+    TTF_SizeText(font, prefix, &x, NULL);
+
+    out->glyphs[i].x = prev_x;
+    out->glyphs[i].y = 0;
+    out->glyphs[i].w = x - prev_x;
+    out->glyphs[i].h = texture->height;
+    if (out->glyphs[i].w > out->cell_w)
+      out->cell_w = out->glyphs[i].w;
+
+    prev_x = x;
+  }
+
+  // glyphs are copied as-is into label's render target
+  LTexture_SetBlendMode(texture, SDL_BLENDMODE_NONE);
+  return out;
+}
+
+void LDigitStrip_free(LDigitStrip* strip)
+{
+  LTexture_Free(strip->texture);
+  free(strip);
+}
+
+LNumberLabel* LNumberLabel_new(LDigitStrip* strip, int max_chars)
+{
+  if (max_chars > LNUMBERLABEL_MAX_CHARS)
+  {
+    max_chars = LNUMBERLABEL_MAX_CHARS;
+  }
+
+  SDL_Texture* target = SDL_CreateTexture(gWindow->renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, max_chars * strip->cell_w, strip->cell_h);
+  if (target == NULL)
+  {
+    SDL_Log("Unable to create render target for number label: %s", SDL_GetError());
+    return NULL;
+  }
+  SDL_SetTextureBlendMode(target, SDL_BLENDMODE_BLEND);
+
+  LNumberLabel* out = malloc(sizeof(LNumberLabel));
+  out->strip = strip;
+  out->target = target;
+  out->max_chars = max_chars;
+  out->text[0] = '\0';
+  out->num_chars = 0;
+  out->composed[0] = '\0';
+  out->invalidated = true;
+  out->width = 0;
+  out->height = strip->cell_h;
+  return out;
+}
+
+bool LNumberLabel_set_int(LNumberLabel* label, int value)
+{
+  char buffer[LNUMBERLABEL_MAX_CHARS+2];
+  char* end = buffer + sizeof(buffer);
+
+  unsigned long long magnitude = value < 0 ? -(long long)value : value;
+  char* p = write_digits(end, magnitude, 1);
+  if (value < 0)
+    *--p = '-';
+
+  return set_text(label, p, end - p);
+}
+
+bool LNumberLabel_set_fixed(LNumberLabel* label, float value, int decimals)
+{
+  static const unsigned long long scales[] = { 1, 10, 100, 1000, 10000, 100000, 1000000 };
+  if (decimals < 0)
+    decimals = 0;
+  else if (decimals > 6)
+    decimals = 6;
+
+  bool negative = value < 0.0f;
+  double magnitude = negative ? -(double)value : value;
+  // round to nearest at specified decimal places
+  double scaled = magnitude * scales[decimals] + 0.5;
+  // doesn't fit in any label anyway, or can't be converted to integer (2^64 and above)
+  // written as negated comparisons so NaN is rejected as well
+  if (!(magnitude < 1e15) || !(scaled < 18446744073709551616.0))
+  {
+    return false;
+  }
+
+  unsigned long long fixed = (unsigned long long)scaled;
+  unsigned long long int_part = fixed / scales[decimals];
+  unsigned long long frac_part = fixed % scales[decimals];
+
+  char buffer[LNUMBERLABEL_MAX_CHARS+16];
+  char* end = buffer + sizeof(buffer);
+  char* p = end;
+  if (decimals > 0)
+  {
+    p = write_digits(p, frac_part, decimals);
+    *--p = '.';
+  }
+  p = write_digits(p, int_part, 1);
+  if (negative && fixed != 0)
+    *--p = '-';
+
+  return set_text(label, p, end - p);
+}
+
+void LNumberLabel_setcolor(LNumberLabel* label, Uint8 red, Uint8 green, Uint8 blue)
+{
+  SDL_SetTextureColorMod(label->target, red, green, blue);
+}
+
+void LNumberLabel_invalidate(LNumberLabel* label)
+{
+  label->invalidated = true;
+}
+
+void LNumberLabel_render(LNumberLabel* label, int x, int y)
+{
+  // find whether any cell has changed before touching render target
+  bool changed = label->invalidated || strcmp(label->text, label->composed) != 0;
+  if (changed)
+  {
+    SDL_Renderer* renderer = gWindow->renderer;
+    LDigitStrip* strip = label->strip;
+
+    // save render states to restore later
+    SDL_Texture* prev_target = SDL_GetRenderTarget(renderer);
+    SDL_BlendMode prev_blend;
+    Uint8 prev_r, prev_g, prev_b, prev_a;
+    SDL_GetRenderDrawBlendMode(renderer, &prev_blend);
+    SDL_GetRenderDrawColor(renderer, &prev_r, &prev_g, &prev_b, &prev_a);
+
+    SDL_SetRenderTarget(renderer, label->target);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+
+    // only cells up to the longer of old and new text can differ
+    int composed_len = label->invalidated ? label->max_chars : (int)strlen(label->composed);
+    int num_cells = label->num_chars > composed_len ? label->num_chars : composed_len;
+    for (int i=0; i<num_cells; i++)
+    {
+      char new_c = i < label->num_chars ? label->text[i] : ' ';
+      char old_c = i < composed_len ? label->composed[i] : ' ';
+      if (!label->invalidated && new_c == old_c)
+      {
+        continue;
+      }
+
+      // clear cell then copy glyph into it
+      SDL_Rect cell = { i * strip->cell_w, 0, strip->cell_w, strip->cell_h };
+      SDL_RenderFillRect(renderer, &cell);
+      if (new_c != ' ')
+      {
+        SDL_Rect* clip = &strip->glyphs[glyph_index(new_c)];
+        SDL_Rect dst = { cell.x, 0, clip->w, clip->h };
+        SDL_RenderCopy(renderer, strip->texture->texture, clip, &dst);
+      }
+    }
+
+    SDL_SetRenderTarget(renderer, prev_target);
+    SDL_SetRenderDrawBlendMode(renderer, prev_blend);
+    SDL_SetRenderDrawColor(renderer, prev_r, prev_g, prev_b, prev_a);
+
+    memcpy(label->composed, label->text, label->num_chars + 1);
+    label->invalidated = false;
+  }
+
+  if (label->num_chars > 0)
+  {
+    SDL_Rect src = { 0, 0, label->width, label->height };
+    SDL_Rect dst = { x, y, label->width, label->height };
+    SDL_RenderCopy(gWindow->renderer, label->target, &src, &dst);
+  }
+}
+
+void LNumberLabel_free(LNumberLabel* label)
+{
+  SDL_DestroyTexture(label->target);
+  free(label);
+}
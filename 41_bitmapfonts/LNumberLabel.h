@@ -0,0 +1,146 @@
+#ifndef LNumberLabel_h_
+#define LNumberLabel_h_
+
+#include "SDL.h"
+#include "SDL_ttf.h"
+#include <stdbool.h>
+#include "LTexture.h"
+
+/// glyphs available in digit strip, in order
+#define LDIGITSTRIP_GLYPHS "0123456789-. "
+
+/// number of glyphs in digit strip
+#define LDIGITSTRIP_NUM_GLYPHS 13
+
+/// maximum number of characters a label can show
+#define LNUMBERLABEL_MAX_CHARS 24
+
+///
+/// Pre-rendered strip of digit glyphs in white, shared by many LNumberLabel.
+///
+typedef struct {
+  /// texture of all glyphs rendered in one line
+  LTexture* texture;
+
+  /// clipping rect of each glyph in texture, ordered as LDIGITSTRIP_GLYPHS
+  SDL_Rect glyphs[LDIGITSTRIP_NUM_GLYPHS];
+
+  /// width of a single character cell, widest glyph
+  int cell_w;
+
+  /// height of a single character cell
+  int cell_h;
+} LDigitStrip;
+
+///
+/// Label showing a number with no memory allocation nor text rasterization per frame.
+///
+/// Characters are composed from LDigitStrip into label's own render target,
+/// only cells whose character changed since last render are redrawn.
+/// Rendering the label itself is a single texture copy.
+///
+typedef struct {
+  /// digit strip to compose from
+  /// (not manage in freeing this attribute)
+  LDigitStrip* strip;
+
+  /// composed characters
+  SDL_Texture* target;
+
+  /// maximum number of characters, determine size of target
+  int max_chars;
+
+  /// text to show
+  char text[LNUMBERLABEL_MAX_CHARS+1];
+  int num_chars;
+
+  /// text currently composed in target
+  char composed[LNUMBERLABEL_MAX_CHARS+1];
+
+  /// whether all cells need to be redrawn
+  bool invalidated;
+
+  /// dimension of current text
+  int width;
+  int height;
+} LNumberLabel;
+
+///
+/// Create a new digit strip by rendering its glyphs with font.
+///
+/// \param font Font to render glyphs with
+/// \return Newly created LDigitStrip allocated memory space on heap, or NULL if failed.
+///
+extern LDigitStrip* LDigitStrip_new(TTF_Font* font);
+
+///
+/// Free LDigitStrip
+///
+/// \param strip LDigitStrip to free its allocated memory
+///
+extern void LDigitStrip_free(LDigitStrip* strip);
+
+///
+/// Create a new LNumberLabel
+///
+/// \param strip Digit strip to compose characters from
+/// \param max_chars Maximum number of characters to show, at most LNUMBERLABEL_MAX_CHARS
+/// \return Newly created LNumberLabel allocated memory space on heap, or NULL if failed.
+///
+extern LNumberLabel* LNumberLabel_new(LDigitStrip* strip, int max_chars);
+
+///
+/// Set integer value to show.
+///
+/// \param label LNumberLabel
+/// \param value Value to show
+/// \return True if value fits into label, otherwise return false and label is not changed.
+///
+extern bool LNumberLabel_set_int(LNumberLabel* label, int value);
+
+///
+/// Set value to show as fixed-point with specified number of decimal places.
+///
+/// \param label LNumberLabel
+/// \param value Value to show
+/// \param decimals Number of decimal places, between 0 and 6
+/// \return True if value fits into label, otherwise return false and label is not changed.
+/// NaN and infinite values always return false.
+///
+extern bool LNumberLabel_set_fixed(LNumberLabel* label, float value, int decimals);
+
+///
+/// Set color of label.
+///
+/// \param label LNumberLabel
+/// \param red Red color component
+/// \param green Green color component
+/// \param blue Blue color component
+///
+extern void LNumberLabel_setcolor(LNumberLabel* label, Uint8 red, Uint8 green, Uint8 blue);
+
+///
+/// Force all cells to be redrawn next time it renders.
+/// Call this when receiving SDL_RENDER_TARGETS_RESET as content of render target is lost.
+///
+/// \param label LNumberLabel
+///
+extern void LNumberLabel_invalidate(LNumberLabel* label);
+
+///
+/// Render label at position, composing changed cells first.
+///
+/// \param label LNumberLabel
+/// \param x Position x to render
+/// \param y Position y to render
+///
+extern void LNumberLabel_render(LNumberLabel* label, int x, int y);
+
+///
+/// Free LNumberLabel
+///
+/// \param label LNumberLabel to free its allocated memory
+///
+extern void LNumberLabel_free(LNumberLabel* label);
+
+#endif
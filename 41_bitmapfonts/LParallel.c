@@ -0,0 +1,72 @@
+#include "LParallel.h"
+
+typedef struct {
+  SDL_atomic_t next_job;
+  int num_jobs;
+  LParallel_job_fn fn;
+  void* ctx;
+} JobQueue;
+
+typedef struct {
+  JobQueue* queue;
+  int index;
+} Worker;
+
+static int worker_main(void* data)
+{
+  Worker* w = data;
+  JobQueue* q = w->queue;
+  int job;
+  while ((job = SDL_AtomicAdd(&q->next_job, 1)) < q->num_jobs)
+  {
+    q->fn(q->ctx, job, w->index);
+  }
+  return 0;
+}
+
+int LParallel_num_threads(int num_threads)
+{
+  if (num_threads <= 0)
+    num_threads = SDL_GetCPUCount();
+  if (num_threads > LPARALLEL_MAX_THREADS)
+    num_threads = LPARALLEL_MAX_THREADS;
+  if (num_threads < 1)
+    num_threads = 1;
+  return num_threads;
+}
+
+void LParallel_run(int num_jobs, int num_threads, LParallel_job_fn fn, void* ctx)
+{
+  JobQueue q;
+  SDL_AtomicSet(&q.next_job, 0);
+  q.num_jobs = num_jobs;
+  q.fn = fn;
+  q.ctx = ctx;
+
+  num_threads = LParallel_num_threads(num_threads);
+  if (num_threads > num_jobs)
+    num_threads = num_jobs > 0 ? num_jobs : 1;
+
+  Worker workers[LPARALLEL_MAX_THREADS];
+  SDL_Thread* threads[LPARALLEL_MAX_THREADS];
+  int num_created = 0;
+  for (int i=1; i<num_threads; i++)
+  {
+    // worker index stays the same as its slot even if some threads fail to be created
+    workers[i].queue = &q;
+    workers[i].index = i;
+    SDL_Thread* t = SDL_CreateThread(worker_main, "LParallel worker", &workers[i]);
+    if (t != NULL)
+      threads[num_created++] = t;
+  }
+
+  // calling thread works too
+  workers[0].queue = &q;
+  workers[0].index = 0;
+  worker_main(&workers[0]);
+
+  for (int i=0; i<num_created; i++)
+  {
+    SDL_WaitThread(threads[i], NULL);
+  }
+}
@@ -0,0 +1,38 @@
+#ifndef LParallel_h_
+#define LParallel_h_
+
+#include "SDL.h"
+
+/// maximum number of threads to run jobs on, including calling thread
+#define LPARALLEL_MAX_THREADS 64
+
+///
+/// Job function
+///
+/// \param ctx User's context
+/// \param job Index of job
+/// \param worker Index of worker running this job, from 0 to number of threads - 1. 0 is calling thread.
+///
+typedef void (*LParallel_job_fn)(void* ctx, int job, int worker);
+
+///
+/// Get number of threads that LParallel_run() will use.
+///
+/// \param num_threads Requested number of threads, 0 to use number of CPU cores
+/// \return Number of threads including calling thread
+///
+extern int LParallel_num_threads(int num_threads);
+
+///
+/// Run jobs on worker threads plus calling thread, return when all jobs are done.
+/// Jobs are picked up dynamically, thus uneven jobs are balanced across threads.
+/// If creating thread fails, remaining threads still finish all jobs.
+///
+/// \param num_jobs Number of jobs
+/// \param num_threads Number of threads, 0 to use number of CPU cores
+/// \param fn Job function
+/// \param ctx User's context passed to job function
+///
+extern void LParallel_run(int num_jobs, int num_threads, LParallel_job_fn fn, void* ctx);
+
+#endif
@@ -0,0 +1,429 @@
+#include "LSDFFont.h"
+#include "common.h"
+#include "LParallel.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/// squared distance used for pixels with no seed
+#define EDT_INF 1e20f
+
+/// number of atlas rows baked per job
+#define BAKE_ROWS_PER_JOB 16
+
+/// rasterized glyph at high resolution, internally used
+typedef struct {
+  /// 1 for inside pixel, 0 otherwise, including padding
+  Uint8* mask;
+  int w;
+  int h;
+} GlyphRaster;
+
+///
+/// 1D squared euclidean distance transform of sampled function (Felzenszwalb & Huttenlocher).
+/// f, d have n elements, v has n elements, z has n+1 elements.
+///
+static void edt_1d(const float* f, float* d, int* v, float* z, int n)
+{
+  int k = 0;
+  v[0] = 0;
+  z[0] = -EDT_INF;
+  z[1] = EDT_INF;
+
+  for (int q=1; q<n; q++)
+  {
+    float s = ((f[q] + q*q) - (f[v[k]] + v[k]*v[k])) / (2*q - 2*v[k]);
+    while (s <= z[k])
+    {
+      k--;
+      s = ((f[q] + q*q) - (f[v[k]] + v[k]*v[k])) / (2*q - 2*v[k]);
+    }
+    k++;
+    v[k] = q;
+    z[k] = s;
+    z[k+1] = EDT_INF;
+  }
+
+  k = 0;
+  for (int q=0; q<n; q++)
+  {
+    while (z[k+1] < q)
+      k++;
+    d[q] = (q - v[k])*(q - v[k]) + f[v[k]];
+  }
+}
+
+///
+/// 2D squared euclidean distance transform in-place, pass over columns then rows.
+/// grid holds 0 for seed pixels, and EDT_INF otherwise.
+///
+static void edt_2d(float* grid, int w, int h, float* f, float* d, int* v, float* z)
+{
+  // columns
+  for (int x=0; x<w; x++)
+  {
+    for (int y=0; y<h; y++)
+      f[y] = grid[y*w + x];
+    edt_1d(f, d, v, z, h);
+    for (int y=0; y<h; y++)
+      grid[y*w + x] = d[y];
+  }
+
+  // rows
+  for (int y=0; y<h; y++)
+  {
+    memcpy(f, grid + y*w, sizeof(float) * w);
+    edt_1d(f, grid + y*w, v, z, w);
+  }
+}
+
+/// context of distance field jobs
+typedef struct {
+  LSDFFont* font;
+  GlyphRaster* rasters;
+  int downscale;
+  /// set to 1 by any job which failed to allocate its buffers
+  SDL_atomic_t failed;
+} DistanceContext;
+
+/// compute distance field of a single glyph into atlas
+static void distance_job(void* data, int job, int worker)
+{
+  DistanceContext* ctx = data;
+  LSDFFont* font = ctx->font;
+  GlyphRaster* raster = &ctx->rasters[job];
+  const SDL_Rect* rect = &font->glyphs[job].rect;
+  int w = raster->w;
+  int h = raster->h;
+  int n = w > h ? w : h;
+
+  float* to_inside = malloc(sizeof(float) * w * h);
+  float* to_outside = malloc(sizeof(float) * w * h);
+  float* f = malloc(sizeof(float) * n);
+  float* d = malloc(sizeof(float) * n);
+  int* v = malloc(sizeof(int) * n);
+  float* z = malloc(sizeof(float) * (n+1));
+  if (to_inside == NULL || to_outside == NULL || f == NULL || d == NULL || v == NULL || z == NULL)
+  {
+    free(to_inside);
+    free(to_outside);
+    free(f);
+    free(d);
+    free(v);
+    free(z);
+    SDL_AtomicSet(&ctx->failed, 1);
+    return;
+  }
+
+  for (int i=0; i<w*h; i++)
+  {
+    to_inside[i] = raster->mask[i] ? 0.0f : EDT_INF;
+    to_outside[i] = raster->mask[i] ? EDT_INF : 0.0f;
+  }
+  edt_2d(to_inside, w, h, f, d, v, z);
+  edt_2d(to_outside, w, h, f, d, v, z);
+
+  // signed distance to edge which lies half a pixel away from pixel center, positive inside
+  // then average each downscale block into a base pixel
+  int ds = ctx->downscale;
+  float scale = 127.0f / (font->spread * ds * ds * ds);
+  for (int by=0; by<rect->h; by++)
+  {
+    for (int bx=0; bx<rect->w; bx++)
+    {
+      float sum = 0.0f;
+      for (int y=by*ds; y<(by+1)*ds; y++)
+      {
+        for (int x=bx*ds; x<(bx+1)*ds; x++)
+        {
+          int i = y*w + x;
+          sum += raster->mask[i] ? sqrtf(to_outside[i]) - 0.5f : 0.5f - sqrtf(to_inside[i]);
+        }
+      }
+
+      float value = 128.0f + sum * scale;
+      if (value < 0.0f)
+        value = 0.0f;
+      else if (value > 255.0f)
+        value = 255.0f;
+      font->distances[(rect->y + by) * font->atlas_w + rect->x + bx] = (Uint8)(value + 0.5f);
+    }
+  }
+
+  free(to_inside);
+  free(to_outside);
+  free(f);
+  free(d);
+  free(v);
+  free(z);
+}
+
+/// rasterize glyph into mask with padding, return false if failed to allocate
+static bool rasterize_glyph(TTF_Font* ttf, Uint16 ch, int pad, int downscale, GlyphRaster* out)
+{
+  SDL_Color white = {0xff, 0xff, 0xff, 0xff};
+  SDL_Surface* surface = NULL;
+  SDL_Surface* glyph_surface = TTF_RenderGlyph_Blended(ttf, ch, white);
+  if (glyph_surface != NULL)
+  {
+    surface = SDL_ConvertSurfaceFormat(glyph_surface, SDL_PIXELFORMAT_ARGB8888, 0);
+    SDL_FreeSurface(glyph_surface);
+  }
+
+  int gw = surface != NULL ? surface->w : 0;
+  int gh = surface != NULL ? surface->h : 0;
+
+  // round up to multiple of downscale so blocks cover it exactly
+  out->w = ((gw + 2*pad + downscale - 1) / downscale) * downscale;
+  out->h = ((gh + 2*pad + downscale - 1) / downscale) * downscale;
+  out->mask = calloc(out->w * out->h, 1);
+  if (out->mask == NULL)
+  {
+    if (surface != NULL)
+      SDL_FreeSurface(surface);
+    return false;
+  }
+
+  if (surface != NULL)
+  {
+    SDL_LockSurface(surface);
+    for (int y=0; y<gh; y++)
+    {
+      const Uint32* row = (const Uint32*)((const Uint8*)surface->pixels + y * surface->pitch);
+      for (int x=0; x<gw; x++)
+      {
+        out->mask[(y + pad) * out->w + x + pad] = (row[x] >> 24) >= 128;
+      }
+    }
+    SDL_UnlockSurface(surface);
+    SDL_FreeSurface(surface);
+  }
+  return true;
+}
+
+LSDFFont* LSDFFont_new(const char* path, int raster_size, int downscale, int spread, int num_threads)
+{
+  TTF_Font* ttf = TTF_OpenFont(path, raster_size);
+  if (ttf == NULL)
+  {
+    SDL_Log("Unable to open font %s: %s", path, TTF_GetError());
+    return NULL;
+  }
+
+  LSDFFont* out = malloc(sizeof(LSDFFont));
+  out->distances = NULL;
+  out->base_size = raster_size / downscale;
+  out->spread = spread;
+  out->line_height = (TTF_FontLineSkip(ttf) + downscale - 1) / downscale;
+
+  // rasterize all glyphs first, ttf font is not thread-safe
+  GlyphRaster* rasters = calloc(LSDFFONT_NUM_CHARS, sizeof(GlyphRaster));
+  bool ok = true;
+  for (int i=0; i<LSDFFONT_NUM_CHARS && ok; i++)
+  {
+    int advance = 0;
+    TTF_GlyphMetrics(ttf, LSDFFONT_FIRST_CHAR + i, NULL, NULL, NULL, NULL, &advance);
+    out->glyphs[i].advance = (float)advance / downscale;
+
+    ok = rasterize_glyph(ttf, LSDFFONT_FIRST_CHAR + i, spread * downscale, downscale, &rasters[i]);
+  }
+  TTF_CloseFont(ttf);
+
+  if (ok)
+  {
+    // pack glyph cells into rows of 16 glyphs wide
+    int max_cell_w = 0;
+    for (int i=0; i<LSDFFONT_NUM_CHARS; i++)
+    {
+      if (rasters[i].w / downscale > max_cell_w)
+        max_cell_w = rasters[i].w / downscale;
+    }
+    out->atlas_w = max_cell_w * 16;
+
+    int pen_x = 0;
+    int pen_y = 0;
+    int row_h = 0;
+    for (int i=0; i<LSDFFONT_NUM_CHARS; i++)
+    {
+      SDL_Rect* rect = &out->glyphs[i].rect;
+      rect->w = rasters[i].w / downscale;
+      rect->h = rasters[i].h / downscale;
+      if (pen_x + rect->w > out->atlas_w)
+      {
+        pen_x = 0;
+        pen_y += row_h;
+        row_h = 0;
+      }
+      rect->x = pen_x;
+      rect->y = pen_y;
+      pen_x += rect->w;
+      if (rect->h > row_h)
+        row_h = rect->h;
+    }
+    out->atlas_h = pen_y + row_h;
+
+    out->distances = calloc(out->atlas_w * out->atlas_h, 1);
+    ok = out->distances != NULL;
+  }
+
+  if (ok)
+  {
+    DistanceContext ctx = { out, rasters, downscale };
+    SDL_AtomicSet(&ctx.failed, 0);
+    LParallel_run(LSDFFONT_NUM_CHARS, num_threads, distance_job, &ctx);
+    ok = SDL_AtomicGet(&ctx.failed) == 0;
+  }
+
+  for (int i=0; i<LSDFFONT_NUM_CHARS; i++)
+  {
+    free(rasters[i].mask);
+  }
+  free(rasters);
+
+  if (!ok)
+  {
+    SDL_Log("Unable to allocate memory for distance field atlas");
+    LSDFFont_free(out);
+    return NULL;
+  }
+  return out;
+}
+
+/// context of bake jobs
+typedef struct {
+  const LSDFFont* font;
+  Uint32* pixels;
+  int width;
+  int height;
+  float scale;
+} BakeContext;
+
+/// bake a band of rows from distance atlas
+static void bake_job(void* data, int job, int worker)
+{
+  BakeContext* ctx = data;
+  const LSDFFont* font = ctx->font;
+  // convert stored value into distance in output pixels
+  float to_pixels = font->spread * ctx->scale / 127.0f;
+
+  int y_end = (job+1) * BAKE_ROWS_PER_JOB;
+  if (y_end > ctx->height)
+    y_end = ctx->height;
+
+  for (int y=job * BAKE_ROWS_PER_JOB; y<y_end; y++)
+  {
+    float sy = (y + 0.5f) / ctx->scale - 0.5f;
+    if (sy < 0.0f) sy = 0.0f;
+    int y0 = (int)sy;
+    int y1 = y0 + 1 < font->atlas_h ? y0 + 1 : y0;
+    float fy = sy - y0;
+
+    for (int x=0; x<ctx->width; x++)
+    {
+      float sx = (x + 0.5f) / ctx->scale - 0.5f;
+      if (sx < 0.0f) sx = 0.0f;
+      int x0 = (int)sx;
+      int x1 = x0 + 1 < font->atlas_w ? x0 + 1 : x0;
+      float fx = sx - x0;
+
+      // bilinear sample of distance
+      const Uint8* r0 = font->distances + y0 * font->atlas_w;
+      const Uint8* r1 = font->distances + y1 * font->atlas_w;
+      float top = r0[x0] + (r0[x1] - r0[x0]) * fx;
+      float bottom = r1[x0] + (r1[x1] - r1[x0]) * fx;
+      float value = top + (bottom - top) * fy;
+
+      // coverage of pixel from its distance to edge
+      float coverage = (value - 128.0f) * to_pixels + 0.5f;
+      if (coverage < 0.0f)
+        coverage = 0.0f;
+      else if (coverage > 1.0f)
+        coverage = 1.0f;
+
+      ctx->pixels[y * ctx->width + x] = ((Uint32)(coverage * 255.0f + 0.5f) << 24) | 0x00ffffff;
+    }
+  }
+}
+
+LSDFFont_baked* LSDFFont_bake(const LSDFFont* font, int pixel_size)
+{
+  float scale = (float)pixel_size / font->base_size;
+  int width = (int)ceilf(font->atlas_w * scale);
+  int height = (int)ceilf(font->atlas_h * scale);
+
+  Uint32* pixels = malloc(sizeof(Uint32) * width * height);
+  if (pixels == NULL)
+  {
+    SDL_Log("Unable to allocate memory to bake atlas");
+    return NULL;
+  }
+
+  BakeContext ctx = { font, pixels, width, height, scale };
+  LParallel_run((height + BAKE_ROWS_PER_JOB - 1) / BAKE_ROWS_PER_JOB, 0, bake_job, &ctx);
+
+  LTexture* texture = LTexture_LoadFromPixels(pixels, width * 4, width, height, SDL_PIXELFORMAT_ARGB8888);
+  free(pixels);
+  if (texture == NULL)
+  {
+    return NULL;
+  }
+  LTexture_SetBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+  LSDFFont_baked* out = malloc(sizeof(LSDFFont_baked));
+  out->font = font;
+  out->texture = texture;
+  out->scale = scale;
+  out->line_height = (int)ceilf(font->line_height * scale);
+  for (int i=0; i<LSDFFONT_NUM_CHARS; i++)
+  {
+    const SDL_Rect* r = &font->glyphs[i].rect;
+    int x0 = (int)floorf(r->x * scale);
+    int y0 = (int)floorf(r->y * scale);
+    out->rects[i].x = x0;
+    out->rects[i].y = y0;
+    out->rects[i].w = (int)ceilf((r->x + r->w) * scale) - x0;
+    out->rects[i].h = (int)ceilf((r->y + r->h) * scale) - y0;
+  }
+  return out;
+}
+
+void LSDFFont_rendertext(LSDFFont_baked* baked, int x, int y, const char* text)
+{
+  const LSDFFont* font = baked->font;
+  // glyph cell starts with spread padding before the pen position
+  float pad = font->spread * baked->scale;
+  float pen_x = x;
+  int pen_y = y;
+
+  for (const char* c = text; *c != '\0'; c++)
+  {
+    if (*c == '\n')
+    {
+      pen_x = x;
+      pen_y += baked->line_height;
+      continue;
+    }
+
+    int i = (unsigned char)*c - LSDFFONT_FIRST_CHAR;
+    if (i < 0 || i >= LSDFFONT_NUM_CHARS)
+      continue;
+
+    if (*c != ' ')
+    {
+      LTexture_ClippedRender(baked->texture, (int)(pen_x - pad + 0.5f), (int)(pen_y - pad + 0.5f), &baked->rects[i]);
+    }
+    pen_x += font->glyphs[i].advance * baked->scale;
+  }
+}
+
+void LSDFFont_baked_free(LSDFFont_baked* baked)
+{
+  LTexture_Free(baked->texture);
+  free(baked);
+}
+
+void LSDFFont_free(LSDFFont* font)
+{
+  free(font->distances);
+  free(font);
+}
@@ -0,0 +1,124 @@
+#ifndef LSDFFont_h_
+#define LSDFFont_h_
+
+#include "SDL.h"
+#include "SDL_ttf.h"
+#include <stdbool.h>
+#include "LTexture.h"
+
+/// first character in atlas
+#define LSDFFONT_FIRST_CHAR 32
+
+/// number of characters in atlas, printable ASCII
+#define LSDFFONT_NUM_CHARS 95
+
+///
+/// Signed distance field font atlas generated from a ttf font.
+///
+/// Glyphs are rasterized once at high resolution, then distance of every pixel to the nearest
+/// glyph's edge is computed with two-pass (column then row) exact euclidean distance transform
+/// on worker threads. Result is downscaled into a single atlas in "base" resolution.
+///
+/// SDL_Renderer has no custom shader, so thresholding distance into coverage is done on CPU
+/// when baking atlas for a specific pixel size (see LSDFFont_bake()). Baking is only sampling
+/// and thresholding the distance atlas, no ttf font or rasterization is involved, thus any
+/// number of sizes can be created from the same atlas cheaply with crisp anti-aliased edges.
+///
+
+///
+/// Glyph in distance atlas. All values are in base resolution.
+///
+typedef struct {
+  /// cell of glyph in atlas, including spread padding around it
+  SDL_Rect rect;
+
+  /// horizontal advance to the next glyph
+  float advance;
+} LSDFFont_glyph;
+
+typedef struct {
+  /// distance atlas, 128 is at glyph's edge, higher value is inside
+  Uint8* distances;
+  int atlas_w;
+  int atlas_h;
+
+  /// glyph information, indexed by (character - LSDFFONT_FIRST_CHAR)
+  LSDFFont_glyph glyphs[LSDFFONT_NUM_CHARS];
+
+  /// pixel size that base resolution corresponds to
+  int base_size;
+
+  /// maximum distance in base pixels stored in atlas, as well as padding around each glyph
+  int spread;
+
+  /// height of a line in base pixels
+  int line_height;
+} LSDFFont;
+
+///
+/// Atlas baked from LSDFFont for a specific pixel size.
+///
+typedef struct {
+  /// font baked from
+  /// (not manage in freeing this attribute)
+  const LSDFFont* font;
+
+  /// baked atlas texture, white with coverage as alpha
+  LTexture* texture;
+
+  /// scale from base resolution
+  float scale;
+
+  /// cell of each glyph in texture
+  SDL_Rect rects[LSDFFONT_NUM_CHARS];
+
+  /// height of a line in pixels
+  int line_height;
+} LSDFFont_baked;
+
+///
+/// Create a new LSDFFont from ttf font.
+///
+/// \param path Path to ttf font file
+/// \param raster_size Pixel size to rasterize glyphs at
+/// \param downscale Factor to downscale from raster size into base resolution of atlas
+/// \param spread Maximum distance in base pixels to store
+/// \param num_threads Number of worker threads, 0 to use number of CPU cores
+/// \return Newly created LSDFFont allocated memory space on heap, or NULL if failed.
+///
+extern LSDFFont* LSDFFont_new(const char* path, int raster_size, int downscale, int spread, int num_threads);
+
+///
+/// Bake atlas texture for pixel size.
+///
+/// \param font LSDFFont
+/// \param pixel_size Pixel size of text to render
+/// \return Newly created LSDFFont_baked allocated memory space on heap, or NULL if failed.
+///
+extern LSDFFont_baked* LSDFFont_bake(const LSDFFont* font, int pixel_size);
+
+///
+/// Render text with baked atlas.
+///
+/// \param baked LSDFFont_baked
+/// \param x Position x to render
+/// \param y Position y to render
+/// \param text Text to render
+///
+extern void LSDFFont_rendertext(LSDFFont_baked* baked, int x, int y, const char* text);
+
+///
+/// Free LSDFFont_baked
+///
+/// \param baked LSDFFont_baked to free its allocated memory
+///
+extern void LSDFFont_baked_free(LSDFFont_baked* baked);
+
+///
+/// Free LSDFFont
+///
+/// \param font LSDFFont to free its allocated memory
+///
+extern void LSDFFont_free(LSDFFont* font);
+
+#endif
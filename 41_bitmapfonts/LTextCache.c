@@ -0,0 +1,260 @@
+#include "LTextCache.h"
+#include <stdlib.h>
+#include <string.h>
+
+struct LTextCache_entry {
+  /// key
+  char* text;
+  TTF_Font* font;
+  SDL_Color color;
+  Uint32 wrap_length;
+  Uint32 hash;
+
+  /// value
+  LTexture* texture;
+  Uint64 bytes;
+
+  /// frame that this entry is used last time
+  Uint32 last_used_frame;
+
+  /// next entry in the same bucket
+  LTextCache_entry* next_in_bucket;
+
+  /// links in LRU list
+  LTextCache_entry* prev;
+  LTextCache_entry* next;
+};
+
+#define INITIAL_NUM_BUCKETS 64
+
+/// 32-bit FNV-1a
+static Uint32 hash_bytes(Uint32 hash, const void* data, size_t size)
+{
+  const Uint8* p = data;
+  for (size_t i=0; i<size; i++)
+  {
+    hash ^= p[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+static Uint32 hash_key(const char* text, TTF_Font* font, SDL_Color color, Uint32 wrap_length)
+{
+  Uint32 hash = hash_bytes(2166136261u, text, strlen(text));
+  hash = hash_bytes(hash, &font, sizeof(font));
+  hash = hash_bytes(hash, &color, sizeof(color));
+  return hash_bytes(hash, &wrap_length, sizeof(wrap_length));
+}
+
+static void unlink_lru(LTextCache* cache, LTextCache_entry* e)
+{
+  if (e->prev != NULL)
+    e->prev->next = e->next;
+  else
+    cache->head = e->next;
+
+  if (e->next != NULL)
+    e->next->prev = e->prev;
+  else
+    cache->tail = e->prev;
+
+  e->prev = NULL;
+  e->next = NULL;
+}
+
+static void push_front_lru(LTextCache* cache, LTextCache_entry* e)
+{
+  e->prev = NULL;
+  e->next = cache->head;
+  if (cache->head != NULL)
+    cache->head->prev = e;
+  cache->head = e;
+  if (cache->tail == NULL)
+    cache->tail = e;
+}
+
+static void unlink_bucket(LTextCache* cache, LTextCache_entry* e)
+{
+  LTextCache_entry** link = &cache->buckets[e->hash & (cache->num_buckets - 1)];
+  while (*link != e)
+  {
+    link = &(*link)->next_in_bucket;
+  }
+  *link = e->next_in_bucket;
+}
+
+static void free_entry(LTextCache* cache, LTextCache_entry* e)
+{
+  cache->stats.bytes -= e->bytes;
+  cache->stats.num_entries--;
+
+  LTexture_Free(e->texture);
+  free(e->text);
+  free(e);
+}
+
+/// double number of buckets when load factor goes over 1
+static void grow_buckets(LTextCache* cache)
+{
+  int new_num_buckets = cache->num_buckets * 2;
+  LTextCache_entry** new_buckets = calloc(new_num_buckets, sizeof(LTextCache_entry*));
+  if (new_buckets == NULL)
+  {
+    // keep using current buckets, only longer chains
+    return;
+  }
+
+  for (int i=0; i<cache->num_buckets; i++)
+  {
+    LTextCache_entry* e = cache->buckets[i];
+    while (e != NULL)
+    {
+      LTextCache_entry* next = e->next_in_bucket;
+      int index = e->hash & (new_num_buckets - 1);
+      e->next_in_bucket = new_buckets[index];
+      new_buckets[index] = e;
+      e = next;
+    }
+  }
+
+  free(cache->buckets);
+  cache->buckets = new_buckets;
+  cache->num_buckets = new_num_buckets;
+}
+
+/// evict least recently used entries until bytes is within budget
+/// entries used in current frame are kept
+static void evict(LTextCache* cache)
+{
+  LTextCache_entry* e = cache->tail;
+  while (cache->stats.bytes > cache->byte_budget && e != NULL && e->last_used_frame != cache->frame)
+  {
+    LTextCache_entry* prev = e->prev;
+    unlink_lru(cache, e);
+    unlink_bucket(cache, e);
+    free_entry(cache, e);
+    cache->stats.frame_evictions++;
+    e = prev;
+  }
+}
+
+LTextCache* LTextCache_new(Uint64 byte_budget)
+{
+  LTextCache* out = malloc(sizeof(LTextCache));
+  out->buckets = calloc(INITIAL_NUM_BUCKETS, sizeof(LTextCache_entry*));
+  out->num_buckets = INITIAL_NUM_BUCKETS;
+  out->head = NULL;
+  out->tail = NULL;
+  out->byte_budget = byte_budget;
+  out->frame = 0;
+  memset(&out->stats, 0, sizeof(out->stats));
+  return out;
+}
+
+LTexture* LTextCache_get(LTextCache* cache, const char* text, TTF_Font* font, SDL_Color color, Uint32 wrapLength)
+{
+  Uint32 hash = hash_key(text, font, color, wrapLength);
+
+  // look up
+  for (LTextCache_entry* e = cache->buckets[hash & (cache->num_buckets - 1)]; e != NULL; e = e->next_in_bucket)
+  {
+    if (e->hash == hash &&
+        e->font == font &&
+        e->wrap_length == wrapLength &&
+        e->color.r == color.r && e->color.g == color.g && e->color.b == color.b && e->color.a == color.a &&
+        strcmp(e->text, text) == 0)
+    {
+      // move to front as most recently used
+      unlink_lru(cache, e);
+      push_front_lru(cache, e);
+      e->last_used_frame = cache->frame;
+
+      cache->stats.frame_hits++;
+      cache->stats.total_hits++;
+      return e->texture;
+    }
+  }
+
+  cache->stats.frame_misses++;
+  cache->stats.total_misses++;
+
+  LTexture* texture = LTexture_LoadFromRenderedText_withFont(text, font, color, wrapLength);
+  if (texture == NULL)
+  {
+    return NULL;
+  }
+
+  LTextCache_entry* e = malloc(sizeof(LTextCache_entry));
+  size_t len = strlen(text);
+  char* e_text = malloc(len + 1);
+  if (e == NULL || e_text == NULL)
+  {
+    SDL_Log("Unable to allocate memory for text cache entry");
+    free(e);
+    free(e_text);
+    LTexture_Free(texture);
+    return NULL;
+  }
+  e->text = e_text;
+  memcpy(e->text, text, len + 1);
+  e->font = font;
+  e->color = color;
+  e->wrap_length = wrapLength;
+  e->hash = hash;
+  e->texture = texture;
+  e->bytes = (Uint64)texture->width * texture->height * 4;
+  e->last_used_frame = cache->frame;
+
+  if (cache->stats.num_entries + 1 > cache->num_buckets)
+  {
+    grow_buckets(cache);
+  }
+  int index = hash & (cache->num_buckets - 1);
+  e->next_in_bucket = cache->buckets[index];
+  cache->buckets[index] = e;
+  push_front_lru(cache, e);
+
+  cache->stats.num_entries++;
+  cache->stats.bytes += e->bytes;
+
+  evict(cache);
+  return texture;
+}
+
+void LTextCache_begin_frame(LTextCache* cache)
+{
+  cache->frame++;
+  cache->stats.frame_hits = 0;
+  cache->stats.frame_misses = 0;
+  cache->stats.frame_evictions = 0;
+
+  // entries kept over budget during last frame can be evicted now
+  evict(cache);
+}
+
+LTextCache_stats LTextCache_get_stats(const LTextCache* cache)
+{
+  return cache->stats;
+}
+
+void LTextCache_clear(LTextCache* cache)
+{
+  LTextCache_entry* e = cache->head;
+  while (e != NULL)
+  {
+    LTextCache_entry* next = e->next;
+    free_entry(cache, e);
+    e = next;
+  }
+  cache->head = NULL;
+  cache->tail = NULL;
+  memset(cache->buckets, 0, sizeof(LTextCache_entry*) * cache->num_buckets);
+}
+
+void LTextCache_free(LTextCache* cache)
+{
+  LTextCache_clear(cache);
+  free(cache->buckets);
+  free(cache);
+}
@@ -0,0 +1,120 @@
+#ifndef LTextCache_h_
+#define LTextCache_h_
+
+#include "SDL.h"
+#include "SDL_ttf.h"
+#include <stdbool.h>
+#include "LTexture.h"
+
+///
+/// LRU cache of textures rendered from text.
+/// Key is (text, font, color, wrap length), value is LTexture from LTexture_LoadFromRenderedText_withFont().
+///
+/// Textures are owned by the cache. Returned texture is valid until it's evicted, entries used
+/// in the current frame are never evicted thus it's safe to render them within the same frame.
+/// Call LTextCache_begin_frame() once at the start of each frame.
+///
+/// Memory usage is estimated as width * height * 4 bytes.
+///
+
+///
+/// Statistics of cache.
+///
+typedef struct {
+  /// number of hits in current frame
+  int frame_hits;
+
+  /// number of misses in current frame
+  int frame_misses;
+
+  /// number of evicted textures in current frame
+  int frame_evictions;
+
+  /// total number of hits since created
+  Uint64 total_hits;
+
+  /// total number of misses since created
+  Uint64 total_misses;
+
+  /// number of cached textures
+  int num_entries;
+
+  /// bytes used by cached textures
+  Uint64 bytes;
+} LTextCache_stats;
+
+/// cached entry, internally used
+typedef struct LTextCache_entry LTextCache_entry;
+
+typedef struct {
+  /// hash buckets, each is a chain of entries
+  LTextCache_entry** buckets;
+  int num_buckets;
+
+  /// most recently used entry
+  LTextCache_entry* head;
+
+  /// least recently used entry
+  LTextCache_entry* tail;
+
+  /// maximum bytes of cached textures, it can go over temporarily if entries are all used in current frame
+  Uint64 byte_budget;
+
+  /// current frame number
+  Uint32 frame;
+
+  /// statistics
+  LTextCache_stats stats;
+} LTextCache;
+
+///
+/// Create a new LTextCache
+///
+/// \param byte_budget Maximum bytes of cached textures
+/// \return Newly created LTextCache allocated memory space on heap.
+///
+extern LTextCache* LTextCache_new(Uint64 byte_budget);
+
+///
+/// Get texture for text, render and cache it if not cached yet.
+///
+/// \param cache LTextCache
+/// \param text Text to render
+/// \param font Font to render with
+/// \param color Color of text
+/// \param wrapLength Width in pixels to wrap text, 0 to not wrap
+/// \return LTexture owned by cache, or NULL if failed to render.
+///
+extern LTexture* LTextCache_get(LTextCache* cache, const char* text, TTF_Font* font, SDL_Color color, Uint32 wrapLength);
+
+///
+/// Start a new frame. Reset per-frame statistics.
+///
+/// \param cache LTextCache
+///
+extern void LTextCache_begin_frame(LTextCache* cache);
+
+///
+/// Get statistics of cache.
+///
+/// \param cache LTextCache
+/// \return Statistics
+///
+extern LTextCache_stats LTextCache_get_stats(const LTextCache* cache);
+
+///
+/// Free all cached textures.
+/// Call this before closing any font used with cache.
+///
+/// \param cache LTextCache
+///
+extern void LTextCache_clear(LTextCache* cache);
+
+///
+/// Free LTextCache and all cached textures.
+///
+/// \param cache LTextCache to free its allocated memory
+///
+extern void LTextCache_free(LTextCache* cache);
+
+#endif
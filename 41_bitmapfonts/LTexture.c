@@ -7,24 +7,56 @@
 extern LWindow* gWindow;
 
 /// underlying low level function to alloc and init things
-static LTexture* LTexture_LoadFromFileARGS(const char* path, bool withColorKey, Uint8 colorKeyRed, Uint8 colorKeyGreen, Uint8 colorKeyBlue, SDL_TextureAccess texture_access, Uint32 texture_format);
+static LTexture* LTexture_LoadFromFileARGS(const char* path, bool withColorKey, Uint8 colorKeyRed, Uint8 colorKeyGreen, Uint8 colorKeyBlue, SDL_TextureAccess texture_access, Uint32 texture_format, bool withShadow);
+
+/// init shadow related attributes to defaults
+static void init_shadow_defaults(LTexture* ltexture)
+{
+  ltexture->shadow_pixels = NULL;
+  ltexture->shadow_pitch = 0;
+  ltexture->shadow_dirty = false;
+  ltexture->shadow_dirty_rect.x = 0;
+  ltexture->shadow_dirty_rect.y = 0;
+  ltexture->shadow_dirty_rect.w = 0;
+  ltexture->shadow_dirty_rect.h = 0;
+}
+
+/// clip input rect against texture's dimensions
+/// if rect is NULL, then result is the whole texture
+/// return false if clipped result is empty
+static bool clip_to_texture(const LTexture* ltexture, const SDL_Rect* rect, SDL_Rect* out_rect)
+{
+  SDL_Rect whole = { 0, 0, ltexture->width, ltexture->height };
+  if (rect == NULL)
+  {
+    *out_rect = whole;
+    return true;
+  }
+  return SDL_IntersectRect(rect, &whole, out_rect) == SDL_TRUE;
+}
 
 LTexture* LTexture_LoadFromFile(const char* path)
 {
-  return LTexture_LoadFromFileARGS(path, false, 0x00, 0xFF, 0xFF, SDL_TEXTUREACCESS_STATIC, 0);
+  return LTexture_LoadFromFileARGS(path, false, 0x00, 0xFF, 0xFF, SDL_TEXTUREACCESS_STATIC, 0, false);
 }
 
 LTexture* LTexture_LoadFromFileWithColorKey(const char* path, Uint8 colorKeyRed, Uint8 colorKeyGreen, Uint8 colorKeyBlue)
 {
-  return LTexture_LoadFromFileARGS(path, true, colorKeyRed, colorKeyGreen, colorKeyBlue, SDL_TEXTUREACCESS_STATIC, 0);
+  return LTexture_LoadFromFileARGS(path, true, colorKeyRed, colorKeyGreen, colorKeyBlue, SDL_TEXTUREACCESS_STATIC, 0, false);
 }
 
 LTexture* LTexture_LoadFromFileWithColorKeyEx(const char* path, bool withColorKey, Uint8 colorKeyRed, Uint8 colorKeyGreen, Uint8 colorKeyBlue, SDL_TextureAccess texture_access, Uint32 texture_format)
 {
-  return LTexture_LoadFromFileARGS(path, withColorKey, colorKeyRed, colorKeyGreen, colorKeyBlue, texture_access, texture_format);
+  return LTexture_LoadFromFileARGS(path, withColorKey, colorKeyRed, colorKeyGreen, colorKeyBlue, texture_access, texture_format, false);
 }
 
-LTexture* LTexture_LoadFromFileARGS(const char* path, bool withColorKey, Uint8 colorKeyRed, Uint8 colorKeyGreen, Uint8 colorKeyBlue, SDL_TextureAccess texture_access, Uint32 texture_format)
+LTexture* LTexture_LoadFromFileWithShadow(const char* path, bool withColorKey, Uint8 colorKeyRed, Uint8 colorKeyGreen, Uint8 colorKeyBlue, Uint32 texture_format)
+{
+  // shadow pixels only make sense for streaming texture as it's the only one we can update later
+  return LTexture_LoadFromFileARGS(path, withColorKey, colorKeyRed, colorKeyGreen, colorKeyBlue, SDL_TEXTUREACCESS_STREAMING, texture_format, true);
+}
+
+LTexture* LTexture_LoadFromFileARGS(const char* path, bool withColorKey, Uint8 colorKeyRed, Uint8 colorKeyGreen, Uint8 colorKeyBlue, SDL_TextureAccess texture_access, Uint32 texture_format, bool withShadow)
 {
   // load image at specified path
   SDL_Surface* loadedSurface = IMG_Load(path);
@@ -77,6 +109,29 @@ LTexture* LTexture_LoadFromFileARGS(const char* path, bool withColorKey, Uint8 c
       return NULL;
     }
 
+    // shadow pixels to keep CPU-side copy of final pixel data
+    // it has the same layout as formatted surface, thus we can index both with the same offset
+    Uint32* shadow_pixels = NULL;
+    if (withShadow)
+    {
+      if (SDL_BYTESPERPIXEL(pixel_format) != 4)
+      {
+        SDL_Log("Shadow pixels need 32 bit per pixel format, but got %s", SDL_GetPixelFormatName(pixel_format));
+      }
+      else
+      {
+        shadow_pixels = malloc(formatted_surface->pitch * formatted_surface->h);
+        if (shadow_pixels == NULL)
+        {
+          SDL_Log("Unable to allocate shadow pixels for %s, continue without them", path);
+        }
+        else
+        {
+          memcpy(shadow_pixels, formatted_surface->pixels, formatted_surface->pitch * formatted_surface->h);
+        }
+      }
+    }
+
     // pixel data to be filled for holding after locking
     void* pixels_data = NULL;
     // pitch to be filld
@@ -113,6 +168,12 @@ LTexture* LTexture_LoadFromFileARGS(const char* path, bool withColorKey, Uint8 c
         if (read_pixels[i] == color_key)
         {
           pixels[i] = transparent_color;
+
+          // keep shadow in sync
+          if (shadow_pixels != NULL)
+          {
+            shadow_pixels[i] = transparent_color;
+          }
         }
       }
 
@@ -138,6 +199,12 @@ LTexture* LTexture_LoadFromFileARGS(const char* path, bool withColorKey, Uint8 c
     // init attributes
     out->pixels = NULL;
     out->pitch = 0;
+    init_shadow_defaults(out);
+    if (shadow_pixels != NULL)
+    {
+      out->shadow_pixels = shadow_pixels;
+      out->shadow_pitch = formatted_surface->pitch;
+    }
 
     // free both old surface and new formatted surface
     SDL_FreeSurface(formatted_surface);
@@ -170,6 +237,7 @@ LTexture* LTexture_LoadFromFileARGS(const char* path, bool withColorKey, Uint8 c
     // init attributes
     out->pixels = NULL;
     out->pitch = 0;
+    init_shadow_defaults(out);
 
     // free surface, we don't need it anymore
     SDL_FreeSurface(loadedSurface);
@@ -178,6 +246,35 @@ LTexture* LTexture_LoadFromFileARGS(const char* path, bool withColorKey, Uint8 c
   }
 }
 
+LTexture* LTexture_LoadFromPixels(const void* pixels, int pitch, int width, int height, Uint32 texture_format)
+{
+  SDL_Texture* newTexture = SDL_CreateTexture(gWindow->renderer, texture_format, SDL_TEXTUREACCESS_STATIC, width, height);
+  if (newTexture == NULL)
+  {
+    SDL_Log("Unable to create texture from pixels! SDL error: %s", SDL_GetError());
+    return NULL;
+  }
+
+  if (SDL_UpdateTexture(newTexture, NULL, pixels, pitch) != 0)
+  {
+    SDL_Log("Unable to update texture from pixels! SDL error: %s", SDL_GetError());
+    SDL_DestroyTexture(newTexture);
+    return NULL;
+  }
+
+  // allocate LTexture on heap
+  LTexture* out = malloc(sizeof(LTexture));
+  out->width = width;
+  out->height = height;
+  out->texture = newTexture;
+  // init attributes
+  out->pixels = NULL;
+  out->pitch = 0;
+  init_shadow_defaults(out);
+
+  return out;
+}
+
 #ifndef DISABLE_SDL_TTF_LIB
 LTexture* LTexture_LoadFromRenderedText(const char* textureText, SDL_Color textColor, Uint32 wrapLength)
 {
@@ -220,6 +317,10 @@ LTexture* LTexture_LoadFromRenderedText_withFont(const char* textureText, TTF_Fo
   out->width = textSurface->w;
   out->height = textSurface->h;
   out->texture = newTexture;
+  // init attributes
+  out->pixels = NULL;
+  out->pitch = 0;
+  init_shadow_defaults(out);
 
   // free surface, we don't need it anymore
   SDL_FreeSurface(textSurface);
@@ -323,6 +424,12 @@ bool LTexture_UnlockTexture(LTexture* ltexture)
 
 Uint32 LTexture_GetPixel32(LTexture* ltexture, unsigned int x, unsigned int y)
 {
+  // prefer shadow pixels as they're valid for reading
+  if (ltexture->shadow_pixels != NULL)
+  {
+    return ltexture->shadow_pixels[ y * (ltexture->shadow_pitch / 4) + x];
+  }
+
   // convert pixels to 32 bit
   Uint32 *pixels = ltexture->pixels;
 
@@ -330,6 +437,158 @@ Uint32 LTexture_GetPixel32(LTexture* ltexture, unsigned int x, unsigned int y)
   return pixels[ y * (ltexture->pitch / 4) + x];
 }
 
+bool LTexture_EnableShadow(LTexture* ltexture)
+{
+  // already has shadow pixels
+  if (ltexture->shadow_pixels != NULL)
+  {
+    return true;
+  }
+
+  Uint32 format = 0;
+  int access = 0;
+  if (SDL_QueryTexture(ltexture->texture, &format, &access, NULL, NULL) != 0)
+  {
+    SDL_Log("Unable to query texture! %s", SDL_GetError());
+    return false;
+  }
+  if (access != SDL_TEXTUREACCESS_STREAMING || SDL_BYTESPERPIXEL(format) != 4)
+  {
+    SDL_Log("Shadow pixels need streaming texture with 32 bit per pixel format");
+    return false;
+  }
+
+  ltexture->shadow_pitch = ltexture->width * 4;
+  ltexture->shadow_pixels = calloc(ltexture->width * ltexture->height, sizeof(Uint32));
+  if (ltexture->shadow_pixels == NULL)
+  {
+    SDL_Log("Unable to allocate memory for shadow pixels");
+    ltexture->shadow_pitch = 0;
+    return false;
+  }
+
+  // existing content of texture is unknown, so upload the whole cleared shadow later
+  LTexture_MarkShadowDirty(ltexture, NULL);
+  return true;
+}
+
+Uint32* LTexture_GetShadowRow(LTexture* ltexture, unsigned int y)
+{
+  if (ltexture->shadow_pixels == NULL)
+  {
+    return NULL;
+  }
+  return ltexture->shadow_pixels + y * (ltexture->shadow_pitch / 4);
+}
+
+void LTexture_SetPixel32(LTexture* ltexture, unsigned int x, unsigned int y, Uint32 pixel)
+{
+  if (ltexture->shadow_pixels == NULL)
+  {
+    SDL_Log("Texture has no shadow pixels");
+    return;
+  }
+
+  ltexture->shadow_pixels[ y * (ltexture->shadow_pitch / 4) + x] = pixel;
+
+  SDL_Rect rect = { x, y, 1, 1 };
+  LTexture_MarkShadowDirty(ltexture, &rect);
+}
+
+bool LTexture_ReadShadowRegion(LTexture* ltexture, const SDL_Rect* rect, void* dst, int dst_pitch)
+{
+  if (ltexture->shadow_pixels == NULL)
+  {
+    SDL_Log("Texture has no shadow pixels");
+    return false;
+  }
+
+  SDL_Rect region;
+  if (!clip_to_texture(ltexture, rect, &region))
+  {
+    return false;
+  }
+
+  // copy row by row as pitch of both might be different
+  const Uint8* src_row = (const Uint8*)LTexture_GetShadowRow(ltexture, region.y) + region.x * 4;
+  Uint8* dst_row = dst;
+  for (int i=0; i<region.h; i++)
+  {
+    memcpy(dst_row, src_row, region.w * 4);
+    src_row += ltexture->shadow_pitch;
+    dst_row += dst_pitch;
+  }
+
+  return true;
+}
+
+bool LTexture_WriteShadowRegion(LTexture* ltexture, const SDL_Rect* rect, const void* src, int src_pitch)
+{
+  if (ltexture->shadow_pixels == NULL)
+  {
+    SDL_Log("Texture has no shadow pixels");
+    return false;
+  }
+
+  SDL_Rect region;
+  if (!clip_to_texture(ltexture, rect, &region))
+  {
+    return false;
+  }
+
+  const Uint8* src_row = src;
+  Uint8* dst_row = (Uint8*)LTexture_GetShadowRow(ltexture, region.y) + region.x * 4;
+  for (int i=0; i<region.h; i++)
+  {
+    memcpy(dst_row, src_row, region.w * 4);
+    src_row += src_pitch;
+    dst_row += ltexture->shadow_pitch;
+  }
+
+  LTexture_MarkShadowDirty(ltexture, &region);
+  return true;
+}
+
+void LTexture_MarkShadowDirty(LTexture* ltexture, const SDL_Rect* rect)
+{
+  SDL_Rect region;
+  if (!clip_to_texture(ltexture, rect, &region))
+  {
+    return;
+  }
+
+  // grow dirty region to cover the new one
+  if (ltexture->shadow_dirty)
+  {
+    SDL_UnionRect(&ltexture->shadow_dirty_rect, &region, &ltexture->shadow_dirty_rect);
+  }
+  else
+  {
+    ltexture->shadow_dirty_rect = region;
+    ltexture->shadow_dirty = true;
+  }
+}
+
+bool LTexture_UploadShadow(LTexture* ltexture)
+{
+  // nothing to upload
+  if (ltexture->shadow_pixels == NULL || !ltexture->shadow_dirty)
+  {
+    return true;
+  }
+
+  const SDL_Rect* rect = &ltexture->shadow_dirty_rect;
+  const Uint8* src = (const Uint8*)LTexture_GetShadowRow(ltexture, rect->y) + rect->x * 4;
+  if (SDL_UpdateTexture(ltexture->texture, rect, src, ltexture->shadow_pitch) != 0)
+  {
+    SDL_Log("Unable to update texture from shadow pixels! %s", SDL_GetError());
+    return false;
+  }
+
+  ltexture->shadow_dirty = false;
+  return true;
+}
+
 void LTexture_Free(LTexture* ltexture)
 {
   // destroy texture as attached to its texture
@@ -339,6 +598,13 @@ void LTexture_Free(LTexture* ltexture)
     ltexture->texture = NULL;
   }
 
+  // free shadow pixels
+  if (ltexture->shadow_pixels != NULL)
+  {
+    free(ltexture->shadow_pixels);
+    ltexture->shadow_pixels = NULL;
+  }
+
   free(ltexture);
   ltexture = NULL; 
 }
@@ -31,6 +31,22 @@ typedef struct {
   /// Used this for *write-only* operation.
   /// will be present only when lock texture via LTexture_LockTexture()
   void* pixels;
+
+  /// CPU-side copy of texture's pixel data (32 bit per pixel).
+  /// It is NULL unless texture is created with shadow, or LTexture_EnableShadow() is called.
+  /// Unlike pixels, this one is valid for both read and write at any time.
+  Uint32* shadow_pixels;
+
+  /// pitch in bytes of shadow_pixels
+  int shadow_pitch;
+
+  /// region of shadow_pixels that has been modified but not yet uploaded to texture
+  /// (internally managed, read-only)
+  SDL_Rect shadow_dirty_rect;
+
+  /// whether shadow_dirty_rect holds modified region waiting to be uploaded
+  /// (internally managed, read-only)
+  bool shadow_dirty;
 } LTexture;
 
 /*
@@ -59,6 +75,32 @@ extern LTexture* LTexture_LoadFromFileWithColorKey(const char* path, Uint8 color
 ///
 extern LTexture* LTexture_LoadFromFileWithColorKeyEx(const char* path, bool withColorKey, Uint8 colorKeyRed, Uint8 colorKeyGreen, Uint8 colorKeyBlue, SDL_TextureAccess texture_access, Uint32 texture_format);
 
+///
+/// Load streaming texture at the specified path, and keep CPU-side shadow copy of its pixel data.
+/// Shadow copy allows reading pixel data via LTexture_GetPixel32() without locking texture.
+///
+/// \param path Path to image file
+/// \param withColorKey True to also set color key, otherwise false thus colorKeyRed, colorKeyGreen and colorKeyBlue will be ignored.
+/// \param colorKeyRed Color key red component 0-255
+/// \param colorKeyGreen Color key green component 0-255
+/// \param colorKeyBlue Color key blue component 0-255
+/// \param texture_format Texture format to create. It needs to be 32 bit per pixel format. Set to 0 to create texture format the same as in global main window.
+/// \return Newly created LTexture with shadow pixels.
+///
+extern LTexture* LTexture_LoadFromFileWithShadow(const char* path, bool withColorKey, Uint8 colorKeyRed, Uint8 colorKeyGreen, Uint8 colorKeyBlue, Uint32 texture_format);
+
+///
+/// Create a static texture from pixels data in memory.
+///
+/// \param pixels Pixels data
+/// \param pitch Pitch in bytes of pixels data
+/// \param width Width of texture
+/// \param height Height of texture
+/// \param texture_format Pixel format of pixels data, as well as texture to create
+/// \return Newly created LTexture, or NULL if failed.
+///
+extern LTexture* LTexture_LoadFromPixels(const void* pixels, int pitch, int width, int height, Uint32 texture_format);
+
 #ifndef DISABLE_SDL_TTF_LIB
 /*
  * Load texture from rendered text, and color.
@@ -131,12 +173,86 @@ extern bool LTexture_UnlockTexture(LTexture* ltexture);
 /// Get pixel 32 bit (RGBA) from texture at specified position.
 /// It will work only if texture has RGBA format with 8 bit each. If not, behavior is undefined.
 ///
+/// If texture has shadow pixels, it reads from them and texture doesn't need to be locked.
+/// Otherwise it reads from locked pixels which SDL defines as write-only, so result might not be valid.
+///
 /// \param ltexture LTexture got get pixel data at specified position from
 /// \param x Position x to get pixel data
 /// \param y Position y to get pixel data
 ///
 extern Uint32 LTexture_GetPixel32(LTexture* ltexture, unsigned int x, unsigned int y);
 
+///
+/// Enable CPU-side shadow pixels for streaming texture.
+/// As existing content of texture cannot be read back, shadow pixels will be cleared to 0 and
+/// whole texture is marked dirty to be uploaded with next LTexture_UploadShadow().
+///
+/// It has no effect if texture already has shadow pixels.
+///
+/// \param ltexture LTexture to enable shadow pixels for. It needs to be 32 bit per pixel format.
+/// \return True if enable successfully, otherwise return false.
+///
+extern bool LTexture_EnableShadow(LTexture* ltexture);
+
+///
+/// Get pointer to row span of shadow pixels.
+///
+/// \param ltexture LTexture with shadow pixels
+/// \param y Row to get
+/// \return Pointer to first pixel of row y, or NULL if texture has no shadow pixels.
+///
+extern Uint32* LTexture_GetShadowRow(LTexture* ltexture, unsigned int y);
+
+///
+/// Set pixel 32 bit into shadow pixels at specified position, and mark it dirty.
+///
+/// \param ltexture LTexture with shadow pixels
+/// \param x Position x to set pixel data
+/// \param y Position y to set pixel data
+/// \param pixel Pixel data in the same format as texture
+///
+extern void LTexture_SetPixel32(LTexture* ltexture, unsigned int x, unsigned int y, Uint32 pixel);
+
+///
+/// Copy region of shadow pixels out into destination buffer.
+///
+/// \param ltexture LTexture with shadow pixels
+/// \param rect Region to copy. Set to NULL to copy whole texture.
+/// \param dst Destination buffer
+/// \param dst_pitch Pitch in bytes of destination buffer
+/// \return True if copy successfully, otherwise return false.
+///
+extern bool LTexture_ReadShadowRegion(LTexture* ltexture, const SDL_Rect* rect, void* dst, int dst_pitch);
+
+///
+/// Copy source buffer into region of shadow pixels, and mark such region dirty.
+///
+/// \param ltexture LTexture with shadow pixels
+/// \param rect Region to write into. Set to NULL to write whole texture.
+/// \param src Source buffer in the same pixel format as texture
+/// \param src_pitch Pitch in bytes of source buffer
+/// \return True if copy successfully, otherwise return false.
+///
+extern bool LTexture_WriteShadowRegion(LTexture* ltexture, const SDL_Rect* rect, const void* src, int src_pitch);
+
+///
+/// Mark region of shadow pixels as dirty.
+/// Use this after modifying shadow pixels directly i.e. via LTexture_GetShadowRow().
+///
+/// \param ltexture LTexture with shadow pixels
+/// \param rect Region to mark. Set to NULL to mark whole texture.
+///
+extern void LTexture_MarkShadowDirty(LTexture* ltexture, const SDL_Rect* rect);
+
+///
+/// Upload dirty region of shadow pixels to texture via SDL_UpdateTexture().
+/// It has no effect if nothing is dirty.
+///
+/// \param ltexture LTexture with shadow pixels
+/// \return True if upload successfully or nothing to upload, otherwise return false.
+///
+extern bool LTexture_UploadShadow(LTexture* ltexture);
+
 /*
  * Free LTexture's resource.
  * After this call, texture will be NULL.
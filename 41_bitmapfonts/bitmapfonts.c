@@ -10,9 +10,25 @@
 #include "LTexture.h"
 #include "LTimer.h"
 #include "LBitmapFont.h"
+#include "LBitmapFontBatch.h"
+#include "LNumberLabel.h"
+#include "LTextCache.h"
+#include "LSDFFont.h"
+#include "LGlyphAtlas.h"
 
 #define SCREEN_WIDTH 640
 #define SCREEN_HEIGHT 480
+// maximum bytes of textures rendered from text to keep around
+#define TEXT_CACHE_BUDGET (1024*1024)
+// sizes of text baked from the same distance field atlas
+#define NUM_SDF_SIZES 3
+static const int sdf_sizes[NUM_SDF_SIZES] = { 12, 24, 48 };
+// fonts and sizes whose glyphs are rasterized up front
+#define NUM_ATLAS_FONTS 2
+static const LGlyphAtlas_fontspec atlas_fonts[NUM_ATLAS_FONTS] = {
+  { "../Minecraft.ttf", 16 },
+  { "../8bitwondor.ttf", 16 }
+};
 #define SETFRAME(var, arg1, arg2, arg3, arg4)		\
   do {										\
     var.x = arg1;							\
@@ -41,8 +57,9 @@ Uint32 currTime = 0;
 Uint32 prevTime = 0;
 
 #ifndef DISABLE_FPS_CALC
-#define FPS_BUFFER 7+1
-char fpsText[FPS_BUFFER];
+#define FPS_MAX_CHARS 7
+LDigitStrip* digit_strip = NULL;
+LNumberLabel* fps_label = NULL;
 #endif
 
 // content's rect to clear color in render loop
@@ -50,6 +67,12 @@ SDL_Rect content_rect = { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT };
 
 LTexture* bitmapfont_texture = NULL;
 LBitmapFont* bitmapfont = NULL;
+LBitmapFontBatch* text_batch = NULL;
+LBitmapFontText* text_layout = NULL;
+LTextCache* text_cache = NULL;
+LSDFFont* sdf_font = NULL;
+LSDFFont_baked* sdf_baked[NUM_SDF_SIZES];
+LGlyphAtlas* glyph_atlases = NULL;
 
 bool init() {
   // initialize sdl
@@ -107,10 +130,62 @@ bool setup()
     return false;
   }
 
+  // distance field atlas generated once from ttf at high resolution, then baked into multiple sizes
+  // without opening the font again at each size
+  sdf_font = LSDFFont_new("../Minecraft.ttf", 128, 4, 4, 0);
+  if (sdf_font == NULL)
+  {
+    SDL_Log("Failed to create distance field font");
+    return false;
+  }
+  for (int i=0; i<NUM_SDF_SIZES; i++)
+  {
+    sdf_baked[i] = LSDFFont_bake(sdf_font, sdf_sizes[i]);
+    if (sdf_baked[i] == NULL)
+    {
+      SDL_Log("Failed to bake distance field font at size %d", sdf_sizes[i]);
+      return false;
+    }
+  }
+
+  // rasterize all printable characters of all fonts in parallel now, rather than on first use
+  char charset[96];
+  for (int i=0; i<95; i++)
+    charset[i] = 32 + i;
+  charset[95] = '\0';
+  glyph_atlases = LGlyphAtlas_prewarm(charset, atlas_fonts, NUM_ATLAS_FONTS, 0);
+  if (glyph_atlases == NULL)
+  {
+    SDL_Log("Failed to prewarm glyph atlases");
+    return false;
+  }
+  LTexture_SetColor(glyph_atlases[1].texture, 30, 30, 30);
+
+  // static text rendered via ttf is cached, thus not re-rasterized every frame
+  text_cache = LTextCache_new(TEXT_CACHE_BUDGET);
+
+#ifndef DISABLE_FPS_CALC
+  // pre-render digits once, fps label composes from it without re-rasterizing text every frame
+  digit_strip = LDigitStrip_new(gFont);
+  if (digit_strip == NULL)
+  {
+    SDL_Log("Failed to create digit strip");
+    return false;
+  }
+  fps_label = LNumberLabel_new(digit_strip, FPS_MAX_CHARS);
+  if (fps_label == NULL)
+  {
+    SDL_Log("Failed to create fps label");
+    return false;
+  }
+  LNumberLabel_setcolor(fps_label, 30, 30, 30);
+#endif
+
   // load bitmap font texture
-  // we need to create as streaming texture (lockable) as we need to build font thus accessing pixel data
+  // we need to create it with shadow pixels as we need to build font thus reading pixel data
+  // (locked pixels of streaming texture are write-only)
   // as well we want to use LTexture_GetPixel32() thus we need the texture to be in format of RGBA8888 (so SDL_PIXELFORMAT_RGBA8888)
-  bitmapfont_texture = LTexture_LoadFromFileWithColorKeyEx("lazyfont.png", true, 0x00, 0xff, 0xff, SDL_TEXTUREACCESS_STREAMING, SDL_PIXELFORMAT_RGBA8888);
+  bitmapfont_texture = LTexture_LoadFromFileWithShadow("lazyfont.png", true, 0x00, 0xff, 0xff, SDL_PIXELFORMAT_RGBA8888);
   if (bitmapfont_texture == NULL)
   {
     SDL_Log("Failed to load lazyfont.png");
@@ -119,7 +194,14 @@ bool setup()
 
   // bitmapfont
   bitmapfont = LBitmapFont_new();
-  LBitmapFont_buildfont(bitmapfont, bitmapfont_texture, 16, 16);
+  // use glyph metrics generated at build time (see Makefile) if still valid for the image, otherwise scan bitmap
+  LBitmapFont_buildfont_with_metrics(bitmapfont, bitmapfont_texture, "lazyfont.png", 16, 16);
+
+  // batch to draw all text with a single geometry call per frame
+  text_batch = LBitmapFontBatch_new(bitmapfont);
+  // text doesn't change, lay it out once
+  text_layout = LBitmapFontText_new();
+  LBitmapFontText_set(text_layout, bitmapfont, "Bitmap Font.\nABCDEFGHIJKLMNOPQRSTUVWXY\nabcdefghijklmnopqrstuvwxyz\n0123456789");
 
   return true;
 }
@@ -137,6 +219,13 @@ void handleEvent(SDL_Event *e, float deltaTime)
   {
     quit = true;
   }
+#ifndef DISABLE_FPS_CALC
+  // content of render targets is lost, redraw all of label
+  else if (e->type == SDL_RENDER_TARGETS_RESET)
+  {
+    LNumberLabel_invalidate(fps_label);
+  }
+#endif
   // toggle fullscreen via enter key
   else if (e->type == SDL_KEYDOWN && e->key.keysym.sym == SDLK_RETURN)
   {
@@ -175,29 +264,72 @@ void render(float deltaTime)
 
 #ifndef DISABLE_FPS_CALC
     // render fps on the top right corner
-    snprintf(fpsText, FPS_BUFFER-1, "%d", (int)common_avgFPS);
+    // only changed digits are redrawn
+    LNumberLabel_set_int(fps_label, (int)common_avgFPS);
+    LNumberLabel_render(fps_label, SCREEN_WIDTH - fps_label->width - 5, 10);
+#endif
 
-    // generate fps texture
-    SDL_Color color = {30, 30, 30, 255};
-    LTexture *fpsTexture = LTexture_LoadFromRenderedText(fpsText, color, 0);
-    if (fpsTexture != NULL)
+    // caption rendered via ttf, only rasterized once then reused from cache
+    LTextCache_begin_frame(text_cache);
+    SDL_Color caption_color = {30, 30, 30, 255};
+    LTexture* caption = LTextCache_get(text_cache, "Enter: toggle fullscreen", gFont, caption_color, 0);
+    if (caption != NULL)
     {
-      LTexture_Render(fpsTexture, SCREEN_WIDTH - fpsTexture->width - 5, 10);
-      LTexture_Free(fpsTexture);
+      LTexture_Render(caption, 5, SCREEN_HEIGHT - caption->height - 5);
+    }
+
+    // text at multiple sizes from a single distance field atlas
+    int sdf_y = 10;
+    for (int i=0; i<NUM_SDF_SIZES; i++)
+    {
+      LSDFFont_baked* baked = sdf_baked[i];
+      LTexture_SetColor(baked->texture, 30, 30, 30);
+      LSDFFont_rendertext(baked, 5, sdf_y, "SDF text");
+      sdf_y += baked->line_height;
     }
-#endif
 
-    // get dimension of text to render (for performance, should get this values once then use in render, but in case of dynamic text that changes per frame putting here is ok)
-    int text_width = 0;
-    int text_height = 0;
-    const char* text = "Bitmap Font.\nABCDEFGHIJKLMNOPQRSTUVWXY\nabcdefghijklmnopqrstuvwxyz\n0123456789";
-    LBitmapFont_measuretext(bitmapfont, text, &text_width, &text_height);
-    LBitmapFont_rendertext(bitmapfont, SCREEN_WIDTH/2 - text_width/2, SCREEN_HEIGHT/2 - text_height/2, text);
+    // text from prewarmed glyph atlas
+    LGlyphAtlas_rendertext(&glyph_atlases[1], 5, SCREEN_HEIGHT - 2*glyph_atlases[1].line_height - 5, "Prewarmed atlas");
+
+    // text is laid out once in setup(), its dimension is known from layout
+    // for dynamic text, call LBitmapFontText_set() every frame, it only re-layouts when text changes
+    LBitmapFontBatch_begin(text_batch);
+    LBitmapFontBatch_addcached(text_batch, text_layout, SCREEN_WIDTH/2 - text_layout->width/2, SCREEN_HEIGHT/2 - text_layout->height/2);
+    LBitmapFontBatch_flush(text_batch);
   }
 }
 
 void close()
 {
+  // glyph atlases
+  if (glyph_atlases != NULL)
+  {
+    LGlyphAtlas_free(glyph_atlases, NUM_ATLAS_FONTS);
+    glyph_atlases = NULL;
+  }
+
+  // distance field font
+  for (int i=0; i<NUM_SDF_SIZES; i++)
+  {
+    if (sdf_baked[i] != NULL)
+    {
+      LSDFFont_baked_free(sdf_baked[i]);
+      sdf_baked[i] = NULL;
+    }
+  }
+  if (sdf_font != NULL)
+  {
+    LSDFFont_free(sdf_font);
+    sdf_font = NULL;
+  }
+
+  // free cached textures before closing font
+  if (text_cache != NULL)
+  {
+    LTextCache_free(text_cache);
+    text_cache = NULL;
+  }
+
   // free font
   if (gFont != NULL)
   {
@@ -205,10 +337,24 @@ void close()
     gFont = NULL;
   }
 
+#ifndef DISABLE_FPS_CALC
+  // fps label
+  if (fps_label != NULL)
+    LNumberLabel_free(fps_label);
+  if (digit_strip != NULL)
+    LDigitStrip_free(digit_strip);
+#endif
+
   // bitmap texture
   if (bitmapfont_texture != NULL)
     LTexture_Free(bitmapfont_texture);
 
+  // text batch and layout
+  if (text_layout != NULL)
+    LBitmapFontText_free(text_layout);
+  if (text_batch != NULL)
+    LBitmapFontBatch_free(text_batch);
+
   // bitmapfont
   if (bitmapfont != NULL)
     LBitmapFont_free(bitmapfont);
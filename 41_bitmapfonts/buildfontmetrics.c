@@ -0,0 +1,77 @@
+/**
+ * Build step tool to generate glyph metrics file for bitmap font image.
+ * Generated file is placed next to input image, see LBITMAPFONT_METRICS_EXT.
+ *
+ * Usage: buildfontmetrics <image-path> <num-rows> <num-columns>
+ */
+
+#include "SDL.h"
+#include "SDL_image.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include "LBitmapFont.h"
+
+int main(int argc, char* argv[])
+{
+  if (argc < 4)
+  {
+    fprintf(stderr, "Usage: %s <image-path> <num-rows> <num-columns>\n", argv[0]);
+    return 1;
+  }
+
+  const char* image_path = argv[1];
+  int num_rows = atoi(argv[2]);
+  int num_columns = atoi(argv[3]);
+  if (num_rows <= 0 || num_columns <= 0)
+  {
+    fprintf(stderr, "Number of rows and columns should be positive\n");
+    return 1;
+  }
+
+  // only image loading is needed, no video subsystem
+  if ((IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG) != IMG_INIT_PNG)
+  {
+    fprintf(stderr, "SDL_image could not initialize: %s\n", IMG_GetError());
+    return 1;
+  }
+
+  SDL_Surface* loaded_surface = IMG_Load(image_path);
+  if (loaded_surface == NULL)
+  {
+    fprintf(stderr, "Unable to load image %s: %s\n", image_path, IMG_GetError());
+    IMG_Quit();
+    return 1;
+  }
+
+  // convert to the same pixel format as the program uses at runtime
+  // note: color keying is not needed as it doesn't change which pixels equal to background color
+  SDL_Surface* surface = SDL_ConvertSurfaceFormat(loaded_surface, SDL_PIXELFORMAT_RGBA8888, 0);
+  SDL_FreeSurface(loaded_surface);
+  if (surface == NULL)
+  {
+    fprintf(stderr, "Unable to convert surface: %s\n", SDL_GetError());
+    IMG_Quit();
+    return 1;
+  }
+
+  LBitmapFont bfont;
+  SDL_LockSurface(surface);
+  LBitmapFont_buildfont_from_pixels(&bfont, surface->pixels, surface->pitch, surface->w, surface->h, num_rows, num_columns);
+  SDL_UnlockSurface(surface);
+  SDL_FreeSurface(surface);
+
+  int result = 1;
+  Uint64 image_hash = 0;
+  char metrics_path[256];
+  snprintf(metrics_path, sizeof(metrics_path), "%s%s", image_path, LBITMAPFONT_METRICS_EXT);
+
+  if (LBitmapFont_hash_file(image_path, &image_hash) &&
+      LBitmapFont_save_metrics(&bfont, metrics_path, image_hash, num_rows, num_columns))
+  {
+    printf("Generated %s\n", metrics_path);
+    result = 0;
+  }
+
+  IMG_Quit();
+  return result;
+}
@@ -7,7 +7,154 @@
 extern LWindow* gWindow;
 
 /// underlying low level function to alloc and init things
-static LTexture* LTexture_LoadFromFileARGS(const char* path, bool withColorKey, Uint8 colorKeyRed, Uint8 colorKeyGreen, Uint8 colorKeyBlue, SDL_TextureAccess texture_access, Uint32 texture_format);
+static LTexture* LTexture_LoadFromFileARGS(const char* path, bool withColorKey, Uint8 colorKeyRed, Uint8 colorKeyGreen, Uint8 colorKeyBlue, SDL_TextureAccess texture_access, Uint32 texture_format, bool withShadow);
+
+/// number of rows grouped together when comparing pixels against shadow pixels
+#define DIRTY_BAND_HEIGHT 8
+
+/// init shadow related attributes to defaults
+static void init_shadow_defaults(LTexture* ltexture)
+{
+  ltexture->shadow_pixels = NULL;
+  ltexture->shadow_pitch = 0;
+  ltexture->num_dirty_rects = 0;
+  ltexture->dirty_reported = false;
+  ltexture->locked_rect.x = 0;
+  ltexture->locked_rect.y = 0;
+  ltexture->locked_rect.w = 0;
+  ltexture->locked_rect.h = 0;
+}
+
+/// clip input rect against texture's dimensions
+/// if rect is NULL, then result is the whole texture
+/// return false if clipped result is empty
+static bool clip_to_texture(const LTexture* ltexture, const SDL_Rect* rect, SDL_Rect* out_rect)
+{
+  SDL_Rect whole = { 0, 0, ltexture->width, ltexture->height };
+  if (rect == NULL)
+  {
+    *out_rect = whole;
+    return true;
+  }
+  return SDL_IntersectRect(rect, &whole, out_rect) == SDL_TRUE;
+}
+
+/// whether two dirty rects are worth merging into one
+/// merge if the union doesn't cover much more area than both rects combined
+static bool should_merge_rects(const SDL_Rect* a, const SDL_Rect* b, SDL_Rect* out_union)
+{
+  SDL_UnionRect(a, b, out_union);
+  int union_area = out_union->w * out_union->h;
+  int sum_area = a->w * a->h + b->w * b->h;
+  // allow 25% of wasted area, uploading slightly more is cheaper than one more upload call
+  return union_area * 4 <= sum_area * 5;
+}
+
+/// add rect to dirty list of ltexture, coalescing with existing rects whenever possible
+static void add_dirty_rect(LTexture* ltexture, SDL_Rect rect)
+{
+  SDL_Rect merged;
+
+  // keep merging until no existing rect is worth merging with the new one
+  // as once merged, it might now overlap with others
+  int i = 0;
+  while (i < ltexture->num_dirty_rects)
+  {
+    if (should_merge_rects(&ltexture->dirty_rects[i], &rect, &merged))
+    {
+      rect = merged;
+      // remove merged one by swapping with the last, then re-check from the start
+      ltexture->dirty_rects[i] = ltexture->dirty_rects[--ltexture->num_dirty_rects];
+      i = 0;
+    }
+    else
+    {
+      i++;
+    }
+  }
+
+  // list is full, merge into the one that grows the least
+  if (ltexture->num_dirty_rects == LTEXTURE_MAX_DIRTY_RECTS)
+  {
+    int best_index = 0;
+    int best_growth = -1;
+    for (int j=0; j<ltexture->num_dirty_rects; j++)
+    {
+      SDL_UnionRect(&ltexture->dirty_rects[j], &rect, &merged);
+      int growth = merged.w * merged.h - ltexture->dirty_rects[j].w * ltexture->dirty_rects[j].h;
+      if (best_growth < 0 || growth < best_growth)
+      {
+        best_growth = growth;
+        best_index = j;
+      }
+    }
+    // take it out then add it back merged as it might overlap with others now
+    SDL_UnionRect(&ltexture->dirty_rects[best_index], &rect, &merged);
+    ltexture->dirty_rects[best_index] = ltexture->dirty_rects[--ltexture->num_dirty_rects];
+    add_dirty_rect(ltexture, merged);
+    return;
+  }
+
+  ltexture->dirty_rects[ltexture->num_dirty_rects++] = rect;
+}
+
+/// copy only modified spans of region from src into shadow pixels and mark them dirty
+/// src has the same dimension and pitch as the whole texture
+static void copy_modified_to_shadow(LTexture* ltexture, const SDL_Rect* region, const Uint8* src, int src_pitch)
+{
+  for (int band_y = region->y; band_y < region->y + region->h; band_y += DIRTY_BAND_HEIGHT)
+  {
+    int band_end = band_y + DIRTY_BAND_HEIGHT;
+    if (band_end > region->y + region->h)
+    {
+      band_end = region->y + region->h;
+    }
+
+    // bounds of modified pixels within this band
+    int min_x = region->x + region->w;
+    int max_x = -1;
+    int min_y = band_end;
+    int max_y = -1;
+
+    for (int y = band_y; y < band_end; y++)
+    {
+      const Uint32* src_row = (const Uint32*)(src + y * src_pitch);
+      Uint32* dst_row = LTexture_GetShadowRow(ltexture, y);
+
+      // skip row quickly if nothing changed
+      if (memcmp(dst_row + region->x, src_row + region->x, region->w * 4) == 0)
+      {
+        continue;
+      }
+
+      // find modified span from both ends
+      int left = region->x;
+      while (dst_row[left] == src_row[left])
+      {
+        left++;
+      }
+      int right = region->x + region->w - 1;
+      while (dst_row[right] == src_row[right])
+      {
+        right--;
+      }
+
+      memcpy(dst_row + left, src_row + left, (right - left + 1) * 4);
+
+      if (left < min_x) min_x = left;
+      if (right > max_x) max_x = right;
+      if (y < min_y) min_y = y;
+      if (y > max_y) max_y = y;
+    }
+
+    if (max_x >= 0)
+    {
+      SDL_Rect dirty = { min_x, min_y, max_x - min_x + 1, max_y - min_y + 1 };
+      add_dirty_rect(ltexture, dirty);
+    }
+  }
+  ltexture->dirty_reported = true;
+}
 
 LTexture* LTexture_NewBlank(int width, int height, Uint32 texture_format)
 {
@@ -26,25 +173,32 @@ LTexture* LTexture_NewBlank(int width, int height, Uint32 texture_format)
   out->texture = blank_texture;
   out->pitch = 0;
   out->pixels = NULL;
+  init_shadow_defaults(out);
   return out;
 }
 
 LTexture* LTexture_LoadFromFile(const char* path)
 {
-  return LTexture_LoadFromFileARGS(path, false, 0x00, 0xFF, 0xFF, SDL_TEXTUREACCESS_STATIC, 0);
+  return LTexture_LoadFromFileARGS(path, false, 0x00, 0xFF, 0xFF, SDL_TEXTUREACCESS_STATIC, 0, false);
 }
 
 LTexture* LTexture_LoadFromFileWithColorKey(const char* path, Uint8 colorKeyRed, Uint8 colorKeyGreen, Uint8 colorKeyBlue)
 {
-  return LTexture_LoadFromFileARGS(path, true, colorKeyRed, colorKeyGreen, colorKeyBlue, SDL_TEXTUREACCESS_STATIC, 0);
+  return LTexture_LoadFromFileARGS(path, true, colorKeyRed, colorKeyGreen, colorKeyBlue, SDL_TEXTUREACCESS_STATIC, 0, false);
 }
 
 LTexture* LTexture_LoadFromFileWithColorKeyEx(const char* path, bool withColorKey, Uint8 colorKeyRed, Uint8 colorKeyGreen, Uint8 colorKeyBlue, SDL_TextureAccess texture_access, Uint32 texture_format)
 {
-  return LTexture_LoadFromFileARGS(path, withColorKey, colorKeyRed, colorKeyGreen, colorKeyBlue, texture_access, texture_format);
+  return LTexture_LoadFromFileARGS(path, withColorKey, colorKeyRed, colorKeyGreen, colorKeyBlue, texture_access, texture_format, false);
+}
+
+LTexture* LTexture_LoadFromFileWithShadow(const char* path, bool withColorKey, Uint8 colorKeyRed, Uint8 colorKeyGreen, Uint8 colorKeyBlue, Uint32 texture_format)
+{
+  // shadow pixels only make sense for streaming texture as it's the only one we can update later
+  return LTexture_LoadFromFileARGS(path, withColorKey, colorKeyRed, colorKeyGreen, colorKeyBlue, SDL_TEXTUREACCESS_STREAMING, texture_format, true);
 }
 
-LTexture* LTexture_LoadFromFileARGS(const char* path, bool withColorKey, Uint8 colorKeyRed, Uint8 colorKeyGreen, Uint8 colorKeyBlue, SDL_TextureAccess texture_access, Uint32 texture_format)
+LTexture* LTexture_LoadFromFileARGS(const char* path, bool withColorKey, Uint8 colorKeyRed, Uint8 colorKeyGreen, Uint8 colorKeyBlue, SDL_TextureAccess texture_access, Uint32 texture_format, bool withShadow)
 {
   // load image at specified path
   SDL_Surface* loadedSurface = IMG_Load(path);
@@ -97,6 +251,29 @@ LTexture* LTexture_LoadFromFileARGS(const char* path, bool withColorKey, Uint8 c
       return NULL;
     }
 
+    // shadow pixels to keep CPU-side copy of final pixel data
+    // it has the same layout as formatted surface, thus we can index both with the same offset
+    Uint32* shadow_pixels = NULL;
+    if (withShadow)
+    {
+      if (SDL_BYTESPERPIXEL(pixel_format) != 4)
+      {
+        SDL_Log("Shadow pixels need 32 bit per pixel format, but got %s", SDL_GetPixelFormatName(pixel_format));
+      }
+      else
+      {
+        shadow_pixels = malloc(formatted_surface->pitch * formatted_surface->h);
+        if (shadow_pixels == NULL)
+        {
+          SDL_Log("Unable to allocate shadow pixels for %s, continue without them", path);
+        }
+        else
+        {
+          memcpy(shadow_pixels, formatted_surface->pixels, formatted_surface->pitch * formatted_surface->h);
+        }
+      }
+    }
+
     // pixel data to be filled for holding after locking
     void* pixels_data = NULL;
     // pitch to be filld
@@ -134,6 +311,12 @@ LTexture* LTexture_LoadFromFileARGS(const char* path, bool withColorKey, Uint8 c
         if (read_pixels[i] == color_key)
         {
           pixels[i] = transparent_color;
+
+          // keep shadow in sync
+          if (shadow_pixels != NULL)
+          {
+            shadow_pixels[i] = transparent_color;
+          }
         }
       }
 
@@ -159,6 +342,12 @@ LTexture* LTexture_LoadFromFileARGS(const char* path, bool withColorKey, Uint8 c
     // init attributes
     out->pixels = NULL;
     out->pitch = 0;
+    init_shadow_defaults(out);
+    if (shadow_pixels != NULL)
+    {
+      out->shadow_pixels = shadow_pixels;
+      out->shadow_pitch = formatted_surface->pitch;
+    }
 
     // free both old surface and new formatted surface
     SDL_FreeSurface(formatted_surface);
@@ -191,6 +380,7 @@ LTexture* LTexture_LoadFromFileARGS(const char* path, bool withColorKey, Uint8 c
     // init attributes
     out->pixels = NULL;
     out->pitch = 0;
+    init_shadow_defaults(out);
 
     // free surface, we don't need it anymore
     SDL_FreeSurface(loadedSurface);
@@ -241,6 +431,10 @@ LTexture* LTexture_LoadFromRenderedText_withFont(const char* textureText, TTF_Fo
   out->width = textSurface->w;
   out->height = textSurface->h;
   out->texture = newTexture;
+  // init attributes
+  out->pixels = NULL;
+  out->pitch = 0;
+  init_shadow_defaults(out);
 
   // free surface, we don't need it anymore
   SDL_FreeSurface(textSurface);
@@ -304,6 +498,11 @@ void LTexture_SetAlpha(LTexture* ltexture, Uint8 alpha)
 }
 
 bool LTexture_LockTexture(LTexture* ltexture)
+{
+  return LTexture_LockTextureRect(ltexture, NULL);
+}
+
+bool LTexture_LockTextureRect(LTexture* ltexture, const SDL_Rect* rect)
 {
   // if texture is already locked
   if (ltexture->pixels != NULL)
@@ -311,16 +510,32 @@ bool LTexture_LockTexture(LTexture* ltexture)
     SDL_Log("Texture is already locked");
     return false;
   }
+
+  SDL_Rect region;
+  if (!clip_to_texture(ltexture, rect, &region))
+  {
+    SDL_Log("Region to lock is outside of texture");
+    return false;
+  }
+
+  // with shadow pixels, writing goes to shadow pixels then only dirty regions get uploaded when unlock
+  if (ltexture->shadow_pixels != NULL)
+  {
+    ltexture->pixels = (Uint8*)LTexture_GetShadowRow(ltexture, region.y) + region.x * 4;
+    ltexture->pitch = ltexture->shadow_pitch;
+  }
   // lock texture
   else
   {
-    if (SDL_LockTexture(ltexture->texture, NULL, &ltexture->pixels, &ltexture->pitch) != 0)
+    if (SDL_LockTexture(ltexture->texture, &region, &ltexture->pixels, &ltexture->pitch) != 0)
     {
       SDL_Log("Unable to lock texture! %s", SDL_GetError());
       return false;
     }
   }
 
+  ltexture->locked_rect = region;
+  ltexture->dirty_reported = false;
   return true;
 }
 
@@ -334,16 +549,35 @@ bool LTexture_UnlockTexture(LTexture* ltexture)
   }
   else
   {
-    SDL_UnlockTexture(ltexture->texture);
+    bool result = true;
+    if (ltexture->shadow_pixels != NULL)
+    {
+      // nothing reported while locked, so conservatively treat the whole locked region as dirty
+      if (!ltexture->dirty_reported)
+      {
+        LTexture_MarkShadowDirty(ltexture, &ltexture->locked_rect);
+      }
+      result = LTexture_UploadShadow(ltexture);
+    }
+    else
+    {
+      SDL_UnlockTexture(ltexture->texture);
+    }
     ltexture->pixels = NULL;
     ltexture->pitch = 0;
 
-    return true;
+    return result;
   }
 }
 
 Uint32 LTexture_GetPixel32(LTexture* ltexture, unsigned int x, unsigned int y)
 {
+  // prefer shadow pixels as they're valid for reading
+  if (ltexture->shadow_pixels != NULL)
+  {
+    return ltexture->shadow_pixels[ y * (ltexture->shadow_pitch / 4) + x];
+  }
+
   // convert pixels to 32 bit
   Uint32 *pixels = ltexture->pixels;
 
@@ -351,13 +585,192 @@ Uint32 LTexture_GetPixel32(LTexture* ltexture, unsigned int x, unsigned int y)
   return pixels[ y * (ltexture->pitch / 4) + x];
 }
 
+bool LTexture_EnableShadow(LTexture* ltexture)
+{
+  // already has shadow pixels
+  if (ltexture->shadow_pixels != NULL)
+  {
+    return true;
+  }
+  // switching while locked would leave pixels pointing to texture's memory
+  if (ltexture->pixels != NULL)
+  {
+    SDL_Log("Cannot enable shadow pixels while texture is locked");
+    return false;
+  }
+
+  Uint32 format = 0;
+  int access = 0;
+  if (SDL_QueryTexture(ltexture->texture, &format, &access, NULL, NULL) != 0)
+  {
+    SDL_Log("Unable to query texture! %s", SDL_GetError());
+    return false;
+  }
+  if (access != SDL_TEXTUREACCESS_STREAMING || SDL_BYTESPERPIXEL(format) != 4)
+  {
+    SDL_Log("Shadow pixels need streaming texture with 32 bit per pixel format");
+    return false;
+  }
+
+  ltexture->shadow_pitch = ltexture->width * 4;
+  ltexture->shadow_pixels = calloc(ltexture->width * ltexture->height, sizeof(Uint32));
+  if (ltexture->shadow_pixels == NULL)
+  {
+    SDL_Log("Unable to allocate memory for shadow pixels");
+    ltexture->shadow_pitch = 0;
+    return false;
+  }
+
+  // existing content of texture is unknown, so upload the whole cleared shadow later
+  LTexture_MarkShadowDirty(ltexture, NULL);
+  return true;
+}
+
+Uint32* LTexture_GetShadowRow(LTexture* ltexture, unsigned int y)
+{
+  if (ltexture->shadow_pixels == NULL)
+  {
+    return NULL;
+  }
+  return ltexture->shadow_pixels + y * (ltexture->shadow_pitch / 4);
+}
+
+void LTexture_SetPixel32(LTexture* ltexture, unsigned int x, unsigned int y, Uint32 pixel)
+{
+  if (ltexture->shadow_pixels == NULL)
+  {
+    SDL_Log("Texture has no shadow pixels");
+    return;
+  }
+
+  ltexture->shadow_pixels[ y * (ltexture->shadow_pitch / 4) + x] = pixel;
+
+  SDL_Rect rect = { x, y, 1, 1 };
+  LTexture_MarkShadowDirty(ltexture, &rect);
+}
+
+bool LTexture_ReadShadowRegion(LTexture* ltexture, const SDL_Rect* rect, void* dst, int dst_pitch)
+{
+  if (ltexture->shadow_pixels == NULL)
+  {
+    SDL_Log("Texture has no shadow pixels");
+    return false;
+  }
+
+  SDL_Rect region;
+  if (!clip_to_texture(ltexture, rect, &region))
+  {
+    return false;
+  }
+
+  // copy row by row as pitch of both might be different
+  const Uint8* src_row = (const Uint8*)LTexture_GetShadowRow(ltexture, region.y) + region.x * 4;
+  Uint8* dst_row = dst;
+  for (int i=0; i<region.h; i++)
+  {
+    memcpy(dst_row, src_row, region.w * 4);
+    src_row += ltexture->shadow_pitch;
+    dst_row += dst_pitch;
+  }
+
+  return true;
+}
+
+bool LTexture_WriteShadowRegion(LTexture* ltexture, const SDL_Rect* rect, const void* src, int src_pitch)
+{
+  if (ltexture->shadow_pixels == NULL)
+  {
+    SDL_Log("Texture has no shadow pixels");
+    return false;
+  }
+
+  SDL_Rect region;
+  if (!clip_to_texture(ltexture, rect, &region))
+  {
+    return false;
+  }
+
+  const Uint8* src_row = src;
+  Uint8* dst_row = (Uint8*)LTexture_GetShadowRow(ltexture, region.y) + region.x * 4;
+  for (int i=0; i<region.h; i++)
+  {
+    memcpy(dst_row, src_row, region.w * 4);
+    src_row += src_pitch;
+    dst_row += ltexture->shadow_pitch;
+  }
+
+  LTexture_MarkShadowDirty(ltexture, &region);
+  return true;
+}
+
+void LTexture_MarkShadowDirty(LTexture* ltexture, const SDL_Rect* rect)
+{
+  // regardless of result, caller has told us what was modified
+  ltexture->dirty_reported = true;
+
+  SDL_Rect region;
+  if (!clip_to_texture(ltexture, rect, &region))
+  {
+    return;
+  }
+  add_dirty_rect(ltexture, region);
+}
+
+bool LTexture_UploadShadow(LTexture* ltexture)
+{
+  if (ltexture->shadow_pixels == NULL)
+  {
+    return true;
+  }
+
+  bool result = true;
+  for (int i=0; i<ltexture->num_dirty_rects; i++)
+  {
+    const SDL_Rect* rect = &ltexture->dirty_rects[i];
+    const Uint8* src = (const Uint8*)LTexture_GetShadowRow(ltexture, rect->y) + rect->x * 4;
+    if (SDL_UpdateTexture(ltexture->texture, rect, src, ltexture->shadow_pitch) != 0)
+    {
+      SDL_Log("Unable to update texture from shadow pixels! %s", SDL_GetError());
+      result = false;
+    }
+  }
+
+  ltexture->num_dirty_rects = 0;
+  return result;
+}
+
 void LTexture_CopyPixels(LTexture* ltexture, void* pixels)
 {
   // texture is locked
   if (ltexture->pixels != NULL)
   {
-    // copy pixel data to texture
-    memcpy(ltexture->pixels, pixels, ltexture->pitch * ltexture->height);
+    // source has the same dimension as texture, and tightly packed
+    int src_pitch = ltexture->width * 4;
+
+    // only copy what's actually modified into shadow pixels
+    if (ltexture->shadow_pixels != NULL)
+    {
+      copy_modified_to_shadow(ltexture, &ltexture->locked_rect, pixels, src_pitch);
+    }
+    // locked the whole texture, copy all at once
+    else if (ltexture->locked_rect.w == ltexture->width && ltexture->locked_rect.h == ltexture->height)
+    {
+      // copy pixel data to texture
+      memcpy(ltexture->pixels, pixels, ltexture->pitch * ltexture->height);
+    }
+    // otherwise copy only locked region row by row
+    else
+    {
+      const SDL_Rect* region = &ltexture->locked_rect;
+      const Uint8* src_row = (const Uint8*)pixels + region->y * src_pitch + region->x * 4;
+      Uint8* dst_row = ltexture->pixels;
+      for (int i=0; i<region->h; i++)
+      {
+        memcpy(dst_row, src_row, region->w * 4);
+        src_row += src_pitch;
+        dst_row += ltexture->pitch;
+      }
+    }
   }
 }
 
@@ -370,6 +783,13 @@ void LTexture_Free(LTexture* ltexture)
     ltexture->texture = NULL;
   }
 
+  // free shadow pixels
+  if (ltexture->shadow_pixels != NULL)
+  {
+    free(ltexture->shadow_pixels);
+    ltexture->shadow_pixels = NULL;
+  }
+
   free(ltexture);
   ltexture = NULL; 
 }
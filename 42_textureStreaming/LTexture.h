@@ -14,6 +14,9 @@
 #include "SDL_ttf.h"
 #endif
 
+/// maximum number of dirty regions to track before they're forced to be merged together
+#define LTEXTURE_MAX_DIRTY_RECTS 16
+
 // i know guys, we will care about byte alignment of struct later ;)
 typedef struct {
 	SDL_Texture* texture;
@@ -31,6 +34,32 @@ typedef struct {
   /// Use this for *write-only* operation.
   /// will be present only when lock texture via LTexture_LockTexture()
   void* pixels;
+
+  /// region of texture that is currently locked
+  /// will be valid only when lock texture via LTexture_LockTexture() or LTexture_LockTextureRect()
+  SDL_Rect locked_rect;
+
+  /// CPU-side copy of texture's pixel data (32 bit per pixel).
+  /// It is NULL unless texture is created with shadow, or LTexture_EnableShadow() is called.
+  /// Unlike pixels, this one is valid for both read and write at any time.
+  Uint32* shadow_pixels;
+
+  /// pitch in bytes of shadow_pixels
+  int shadow_pitch;
+
+  /// regions of shadow_pixels that have been modified but not yet uploaded to texture.
+  /// Overlapping or nearby regions are coalesced together.
+  /// (internally managed, read-only)
+  SDL_Rect dirty_rects[LTEXTURE_MAX_DIRTY_RECTS];
+
+  /// number of regions in dirty_rects
+  /// (internally managed, read-only)
+  int num_dirty_rects;
+
+  /// whether modified regions have been reported since texture is locked.
+  /// If not, the whole locked region is treated as dirty when unlock.
+  /// (internally managed, read-only)
+  bool dirty_reported;
 } LTexture;
 
 ///
@@ -69,6 +98,21 @@ extern LTexture* LTexture_LoadFromFileWithColorKey(const char* path, Uint8 color
 ///
 extern LTexture* LTexture_LoadFromFileWithColorKeyEx(const char* path, bool withColorKey, Uint8 colorKeyRed, Uint8 colorKeyGreen, Uint8 colorKeyBlue, SDL_TextureAccess texture_access, Uint32 texture_format);
 
+///
+/// Load streaming texture at the specified path, and keep CPU-side shadow copy of its pixel data.
+/// Shadow copy allows reading pixel data via LTexture_GetPixel32() without locking texture, and
+/// uploading only modified regions when unlock.
+///
+/// \param path Path to image file
+/// \param withColorKey True to also set color key, otherwise false thus colorKeyRed, colorKeyGreen and colorKeyBlue will be ignored.
+/// \param colorKeyRed Color key red component 0-255
+/// \param colorKeyGreen Color key green component 0-255
+/// \param colorKeyBlue Color key blue component 0-255
+/// \param texture_format Texture format to create. It needs to be 32 bit per pixel format. Set to 0 to create texture format the same as in global main window.
+/// \return Newly created LTexture with shadow pixels.
+///
+extern LTexture* LTexture_LoadFromFileWithShadow(const char* path, bool withColorKey, Uint8 colorKeyRed, Uint8 colorKeyGreen, Uint8 colorKeyBlue, Uint32 texture_format);
+
 #ifndef DISABLE_SDL_TTF_LIB
 /*
  * Load texture from rendered text, and color.
@@ -124,14 +168,33 @@ extern void LTexture_SetAlpha(LTexture* ltexture, Uint8 alpha);
 ///
 /// Lock texture for write-only operation.
 ///
+/// If texture has shadow pixels, pixels will point to shadow pixels instead, and only dirty regions
+/// will be uploaded when unlock. See LTexture_MarkShadowDirty().
+///
 /// \param ltexture LTexture to lock
 /// \return True if lock successfully, otherwise return false.
 ///
 extern bool LTexture_LockTexture(LTexture* ltexture);
 
+///
+/// Lock only region of texture for write-only operation.
+/// pixels will point to the first pixel of such region, and pitch is still the pitch of the whole row.
+///
+/// Only locked region will be uploaded when unlock. If texture has shadow pixels,
+/// only dirty regions within it will be uploaded.
+///
+/// \param ltexture LTexture to lock
+/// \param rect Region to lock. Set to NULL to lock the whole texture.
+/// \return True if lock successfully, otherwise return false.
+///
+extern bool LTexture_LockTextureRect(LTexture* ltexture, const SDL_Rect* rect);
+
 ///
 /// Unlock texture
 ///
+/// If texture has shadow pixels, dirty regions will be uploaded via LTexture_UploadShadow().
+/// In case no dirty region has been reported while locked, the whole locked region is uploaded.
+///
 /// \param ltexture LTexture to unlock
 /// \return True if unlock successfully, otherwise return false.
 ///
@@ -141,12 +204,88 @@ extern bool LTexture_UnlockTexture(LTexture* ltexture);
 /// Get pixel 32 bit (RGBA) from texture at specified position.
 /// It will work only if texture has RGBA format with 8 bit each. If not, behavior is undefined.
 ///
+/// If texture has shadow pixels, it reads from them and texture doesn't need to be locked.
+/// Otherwise it reads from locked pixels which SDL defines as write-only, so result might not be valid.
+///
 /// \param ltexture LTexture got get pixel data at specified position from
 /// \param x Position x to get pixel data
 /// \param y Position y to get pixel data
 ///
 extern Uint32 LTexture_GetPixel32(LTexture* ltexture, unsigned int x, unsigned int y);
 
+///
+/// Enable CPU-side shadow pixels for streaming texture.
+/// As existing content of texture cannot be read back, shadow pixels will be cleared to 0 and
+/// whole texture is marked dirty to be uploaded with next LTexture_UploadShadow().
+///
+/// It has no effect if texture already has shadow pixels.
+///
+/// \param ltexture LTexture to enable shadow pixels for. It needs to be 32 bit per pixel format.
+/// \return True if enable successfully, otherwise return false.
+///
+extern bool LTexture_EnableShadow(LTexture* ltexture);
+
+///
+/// Get pointer to row span of shadow pixels.
+///
+/// \param ltexture LTexture with shadow pixels
+/// \param y Row to get
+/// \return Pointer to first pixel of row y, or NULL if texture has no shadow pixels.
+///
+extern Uint32* LTexture_GetShadowRow(LTexture* ltexture, unsigned int y);
+
+///
+/// Set pixel 32 bit into shadow pixels at specified position, and mark it dirty.
+///
+/// \param ltexture LTexture with shadow pixels
+/// \param x Position x to set pixel data
+/// \param y Position y to set pixel data
+/// \param pixel Pixel data in the same format as texture
+///
+extern void LTexture_SetPixel32(LTexture* ltexture, unsigned int x, unsigned int y, Uint32 pixel);
+
+///
+/// Copy region of shadow pixels out into destination buffer.
+///
+/// \param ltexture LTexture with shadow pixels
+/// \param rect Region to copy. Set to NULL to copy whole texture.
+/// \param dst Destination buffer
+/// \param dst_pitch Pitch in bytes of destination buffer
+/// \return True if copy successfully, otherwise return false.
+///
+extern bool LTexture_ReadShadowRegion(LTexture* ltexture, const SDL_Rect* rect, void* dst, int dst_pitch);
+
+///
+/// Copy source buffer into region of shadow pixels, and mark such region dirty.
+///
+/// \param ltexture LTexture with shadow pixels
+/// \param rect Region to write into. Set to NULL to write whole texture.
+/// \param src Source buffer in the same pixel format as texture
+/// \param src_pitch Pitch in bytes of source buffer
+/// \return True if copy successfully, otherwise return false.
+///
+extern bool LTexture_WriteShadowRegion(LTexture* ltexture, const SDL_Rect* rect, const void* src, int src_pitch);
+
+///
+/// Mark region of shadow pixels as dirty.
+/// Use this after modifying shadow pixels directly i.e. via pixels while locked, or LTexture_GetShadowRow().
+///
+/// It will be coalesced with existing dirty regions that overlap or are nearby.
+///
+/// \param ltexture LTexture with shadow pixels
+/// \param rect Region to mark. Set to NULL to mark whole texture.
+///
+extern void LTexture_MarkShadowDirty(LTexture* ltexture, const SDL_Rect* rect);
+
+///
+/// Upload dirty regions of shadow pixels to texture via SDL_UpdateTexture().
+/// It has no effect if nothing is dirty.
+///
+/// \param ltexture LTexture with shadow pixels
+/// \return True if upload successfully or nothing to upload, otherwise return false.
+///
+extern bool LTexture_UploadShadow(LTexture* ltexture);
+
 ///
 /// Copy pixels data into LTexture.
 /// This will work only when LTexture is SDL_TEXTUREACCESS_STREAMING which has ability to lock texture.
@@ -157,6 +296,10 @@ extern Uint32 LTexture_GetPixel32(LTexture* ltexture, unsigned int x, unsigned i
 ///
 /// It also assumes that pixels are in the same dimension of texture.
 ///
+/// If texture is locked via LTexture_LockTextureRect(), only locked region will be copied.
+/// If texture has shadow pixels, input pixels are compared against them and only modified spans
+/// will be copied and marked dirty, thus only those get uploaded when unlock.
+///
 /// \param ltexture LTexture
 /// \param pixels Pixels data to copy to
 ///
@@ -125,6 +125,12 @@ bool setup()
     SDL_Log("Failed to create streaming texture");
     return false;
   }
+  // keep CPU-side copy of pixels, thus only modified regions between frames get uploaded
+  if (!LTexture_EnableShadow(streaming_texture))
+  {
+    SDL_Log("Failed to enable shadow pixels for streaming texture");
+    return false;
+  }
 
   return true;
 }
@@ -195,8 +201,9 @@ void render(float deltaTime)
     // lock texture
     LTexture_LockTexture(streaming_texture);
     // copy pixel data from feeder to it
+    // only spans that differ from previous frame are copied and marked dirty
     LTexture_CopyPixels(streaming_texture, feeder_stream->current_image->pixels);
-    // unlock texture
+    // unlock texture, this uploads only dirty regions
     LTexture_UnlockTexture(streaming_texture);
 
     LTexture_Render(streaming_texture, SCREEN_WIDTH/2 - streaming_texture->width/2, SCREEN_HEIGHT/2 - streaming_texture->height/2);
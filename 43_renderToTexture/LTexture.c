@@ -1,6 +1,9 @@
+// don't wrap our own definitions with call site recording macros
+#define LTEXTURE_IMPLEMENTATION
 #include "LTexture.h"
 #include "SDL.h"
 #include "common.h"
+#include "LTextureRegistry.h"
 #include <stdlib.h>
 
 // variables defined in common.h
@@ -38,6 +41,10 @@ LTexture* newblank(int width, int height, Uint32 texture_format, SDL_TextureAcce
   out->texture = blank_texture;
   out->pitch = 0;
   out->pixels = NULL;
+
+#ifndef DISABLE_TEXTURE_REGISTRY
+  LTextureRegistry_add(out, blank_texture, texture_access == SDL_TEXTUREACCESS_TARGET ? "blank render target" : "blank");
+#endif
   return out;
 }
 
@@ -172,6 +179,10 @@ LTexture* LTexture_LoadFromFileARGS(const char* path, bool withColorKey, Uint8 c
     out->pixels = NULL;
     out->pitch = 0;
 
+#ifndef DISABLE_TEXTURE_REGISTRY
+    LTextureRegistry_add(out, newTexture, path);
+#endif
+
     // free both old surface and new formatted surface
     SDL_FreeSurface(formatted_surface);
     SDL_FreeSurface(loadedSurface);
@@ -204,6 +215,10 @@ LTexture* LTexture_LoadFromFileARGS(const char* path, bool withColorKey, Uint8 c
     out->pixels = NULL;
     out->pitch = 0;
 
+#ifndef DISABLE_TEXTURE_REGISTRY
+    LTextureRegistry_add(out, newTexture, path);
+#endif
+
     // free surface, we don't need it anymore
     SDL_FreeSurface(loadedSurface);
 
@@ -253,6 +268,13 @@ LTexture* LTexture_LoadFromRenderedText_withFont(const char* textureText, TTF_Fo
   out->width = textSurface->w;
   out->height = textSurface->h;
   out->texture = newTexture;
+  // init attributes
+  out->pixels = NULL;
+  out->pitch = 0;
+
+#ifndef DISABLE_TEXTURE_REGISTRY
+  LTextureRegistry_add(out, newTexture, textureText);
+#endif
 
   // free surface, we don't need it anymore
   SDL_FreeSurface(textSurface);
@@ -384,6 +406,10 @@ void LTexture_SetAsRenderTarget(LTexture* ltexture)
 
 void LTexture_Free(LTexture* ltexture)
 {
+#ifndef DISABLE_TEXTURE_REGISTRY
+  LTextureRegistry_remove(ltexture);
+#endif
+
   // destroy texture as attached to its texture
   if (ltexture->texture != NULL)
   {
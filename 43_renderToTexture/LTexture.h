@@ -188,4 +188,19 @@ extern void LTexture_SetAsRenderTarget(LTexture* ltexture);
  */
 extern void LTexture_Free(LTexture* texture);
 
+// record call site of user's code that creates LTexture, see LTextureRegistry.h
+#if !defined(DISABLE_TEXTURE_REGISTRY) && !defined(LTEXTURE_IMPLEMENTATION)
+#include "LTextureRegistry.h"
+#define LTEXTURE_RECORD_CALLSITE(call) (LTextureRegistry_set_callsite(__FILE__, __LINE__), call)
+#define LTexture_NewBlank(...) LTEXTURE_RECORD_CALLSITE(LTexture_NewBlank(__VA_ARGS__))
+#define LTexture_NewBlankRenderTarget(...) LTEXTURE_RECORD_CALLSITE(LTexture_NewBlankRenderTarget(__VA_ARGS__))
+#define LTexture_LoadFromFile(...) LTEXTURE_RECORD_CALLSITE(LTexture_LoadFromFile(__VA_ARGS__))
+#define LTexture_LoadFromFileWithColorKey(...) LTEXTURE_RECORD_CALLSITE(LTexture_LoadFromFileWithColorKey(__VA_ARGS__))
+#define LTexture_LoadFromFileWithColorKeyEx(...) LTEXTURE_RECORD_CALLSITE(LTexture_LoadFromFileWithColorKeyEx(__VA_ARGS__))
+#ifndef DISABLE_SDL_TTF_LIB
+#define LTexture_LoadFromRenderedText(...) LTEXTURE_RECORD_CALLSITE(LTexture_LoadFromRenderedText(__VA_ARGS__))
+#define LTexture_LoadFromRenderedText_withFont(...) LTEXTURE_RECORD_CALLSITE(LTexture_LoadFromRenderedText_withFont(__VA_ARGS__))
+#endif
+#endif
+
 #endif /* LTexture_h_ */
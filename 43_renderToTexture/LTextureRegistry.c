@@ -0,0 +1,206 @@
+#include "LTextureRegistry.h"
+#include <stdlib.h>
+#include <string.h>
+
+/// tracking information for each live texture
+typedef struct {
+  const void* ltexture;
+  Uint32 format;
+  int width;
+  int height;
+  Uint64 bytes;
+  const char* file;
+  int line;
+  char label[LTEXTUREREGISTRY_LABEL_LENGTH];
+} Entry;
+
+static Entry* entries = NULL;
+static int num_entries = 0;
+static int capacity_entries = 0;
+
+static LTextureRegistry_stats stats;
+static bool atexit_registered = false;
+
+/// pending call site to be consumed by the next allocation
+static const char* callsite_file = NULL;
+static int callsite_line = 0;
+
+/// find statistics for pixel format, create a new one if not exist yet
+/// return NULL if no more room for a new format
+static LTextureRegistry_format_stats* get_format_stats(Uint32 format)
+{
+  for (int i=0; i<stats.num_formats; i++)
+  {
+    if (stats.formats[i].format == format)
+    {
+      return &stats.formats[i];
+    }
+  }
+
+  if (stats.num_formats == LTEXTUREREGISTRY_MAX_FORMATS)
+  {
+    return NULL;
+  }
+
+  LTextureRegistry_format_stats* fs = &stats.formats[stats.num_formats++];
+  fs->format = format;
+  fs->live_count = 0;
+  fs->live_bytes = 0;
+  return fs;
+}
+
+static void atexit_report()
+{
+  LTextureRegistry_print_leaks();
+
+  free(entries);
+  entries = NULL;
+  num_entries = 0;
+  capacity_entries = 0;
+}
+
+void LTextureRegistry_set_callsite(const char* file, int line)
+{
+  callsite_file = file;
+  callsite_line = line;
+}
+
+void LTextureRegistry_add(const void* ltexture, SDL_Texture* texture, const char* label)
+{
+  if (!atexit_registered)
+  {
+    atexit(atexit_report);
+    atexit_registered = true;
+  }
+
+  // grow space as needed
+  if (num_entries == capacity_entries)
+  {
+    int new_capacity = capacity_entries == 0 ? 64 : capacity_entries * 2;
+    Entry* new_entries = realloc(entries, sizeof(Entry) * new_capacity);
+    if (new_entries == NULL)
+    {
+      SDL_Log("Unable to allocate memory to track texture");
+      return;
+    }
+    entries = new_entries;
+    capacity_entries = new_capacity;
+  }
+
+  Entry* e = &entries[num_entries++];
+  e->ltexture = ltexture;
+  e->format = 0;
+  e->width = 0;
+  e->height = 0;
+  SDL_QueryTexture(texture, &e->format, NULL, &e->width, &e->height);
+  e->bytes = (Uint64)e->width * e->height * SDL_BYTESPERPIXEL(e->format);
+  e->file = callsite_file != NULL ? callsite_file : "(unknown)";
+  e->line = callsite_line;
+  if (label != NULL)
+  {
+    strncpy(e->label, label, LTEXTUREREGISTRY_LABEL_LENGTH-1);
+    e->label[LTEXTUREREGISTRY_LABEL_LENGTH-1] = '\0';
+  }
+  else
+  {
+    e->label[0] = '\0';
+  }
+
+  // consume call site, so it won't be wrongly used for next allocation
+  callsite_file = NULL;
+  callsite_line = 0;
+
+  // update statistics
+  stats.live_count++;
+  stats.live_bytes += e->bytes;
+  stats.total_allocs++;
+  if (stats.live_count > stats.peak_count)
+  {
+    stats.peak_count = stats.live_count;
+  }
+  if (stats.live_bytes > stats.peak_bytes)
+  {
+    stats.peak_bytes = stats.live_bytes;
+  }
+
+  LTextureRegistry_format_stats* fs = get_format_stats(e->format);
+  if (fs != NULL)
+  {
+    fs->live_count++;
+    fs->live_bytes += e->bytes;
+  }
+}
+
+void LTextureRegistry_remove(const void* ltexture)
+{
+  // search from the end as short-lived textures i.e. rendered text are likely the most recent ones
+  for (int i=num_entries-1; i>=0; i--)
+  {
+    if (entries[i].ltexture == ltexture)
+    {
+      Entry* e = &entries[i];
+
+      stats.live_count--;
+      stats.live_bytes -= e->bytes;
+
+      LTextureRegistry_format_stats* fs = get_format_stats(e->format);
+      if (fs != NULL)
+      {
+        fs->live_count--;
+        fs->live_bytes -= e->bytes;
+      }
+
+      // swap with the last one
+      entries[i] = entries[--num_entries];
+      return;
+    }
+  }
+
+  SDL_Log("Freeing texture %p which is not tracked", ltexture);
+}
+
+void LTextureRegistry_get_stats(LTextureRegistry_stats* out_stats)
+{
+  *out_stats = stats;
+}
+
+void LTextureRegistry_print_stats()
+{
+  SDL_Log("Textures: %d live (peak %d), %.2f KB live (peak %.2f KB), %u total allocations",
+      stats.live_count,
+      stats.peak_count,
+      stats.live_bytes / 1024.0,
+      stats.peak_bytes / 1024.0,
+      stats.total_allocs);
+
+  for (int i=0; i<stats.num_formats; i++)
+  {
+    const LTextureRegistry_format_stats* fs = &stats.formats[i];
+    if (fs->live_count > 0)
+    {
+      SDL_Log("  %s: %d live, %.2f KB", SDL_GetPixelFormatName(fs->format), fs->live_count, fs->live_bytes / 1024.0);
+    }
+  }
+}
+
+void LTextureRegistry_print_leaks()
+{
+  if (num_entries == 0)
+  {
+    return;
+  }
+
+  SDL_Log("%d texture(s) leaked, %.2f KB in total", num_entries, stats.live_bytes / 1024.0);
+  for (int i=0; i<num_entries; i++)
+  {
+    const Entry* e = &entries[i];
+    SDL_Log("  %dx%d %s (%.2f KB) '%s' allocated at %s:%d",
+        e->width,
+        e->height,
+        SDL_GetPixelFormatName(e->format),
+        e->bytes / 1024.0,
+        e->label,
+        e->file,
+        e->line);
+  }
+}
@@ -0,0 +1,109 @@
+#ifndef LTextureRegistry_h_
+#define LTextureRegistry_h_
+
+#include "SDL.h"
+#include <stdbool.h>
+
+/// maximum length of label to describe each allocation
+#define LTEXTUREREGISTRY_LABEL_LENGTH 48
+
+/// maximum number of different pixel formats to keep statistics for
+#define LTEXTUREREGISTRY_MAX_FORMATS 16
+
+///
+/// Keep track of memory used by all live LTextures.
+/// Every LTexture constructor reports to it, as well as LTexture_Free().
+///
+/// Memory usage is estimated from width * height * bytes per pixel of texture's format,
+/// thus it doesn't include any padding or internal allocation done by renderer's driver.
+///
+/// Not thread-safe. Create and free LTextures from the same thread.
+///
+/// Define DISABLE_TEXTURE_REGISTRY to disable tracking.
+///
+
+///
+/// Statistics of memory usage for a single pixel format.
+///
+typedef struct {
+  /// pixel format
+  Uint32 format;
+
+  /// number of live textures with this format
+  int live_count;
+
+  /// bytes used by live textures with this format
+  Uint64 live_bytes;
+} LTextureRegistry_format_stats;
+
+///
+/// Statistics of memory usage for all live textures.
+///
+typedef struct {
+  /// number of live textures
+  int live_count;
+
+  /// bytes used by all live textures
+  Uint64 live_bytes;
+
+  /// highest number of live textures at the same time
+  int peak_count;
+
+  /// highest bytes used by all live textures at the same time
+  Uint64 peak_bytes;
+
+  /// total number of allocations since start
+  Uint32 total_allocs;
+
+  /// statistics separated by pixel format
+  LTextureRegistry_format_stats formats[LTEXTUREREGISTRY_MAX_FORMATS];
+
+  /// number of valid elements in formats
+  int num_formats;
+} LTextureRegistry_stats;
+
+///
+/// Set call site for the next LTexture allocation.
+/// It's called automatically via macros in LTexture.h to record where user creates LTexture.
+///
+/// \param file Source file name
+/// \param line Line number
+///
+extern void LTextureRegistry_set_callsite(const char* file, int line);
+
+///
+/// Record a new allocated texture.
+/// The first call also registers leak report to be printed at exit.
+///
+/// \param ltexture Texture wrapper as a key to track
+/// \param texture Underlying SDL texture to get its format and dimension
+/// \param label Short text describing the allocation i.e. path of image file. Can be NULL.
+///
+extern void LTextureRegistry_add(const void* ltexture, SDL_Texture* texture, const char* label);
+
+///
+/// Remove texture from tracking as it's about to be freed.
+///
+/// \param ltexture Texture wrapper used as a key when added
+///
+extern void LTextureRegistry_remove(const void* ltexture);
+
+///
+/// Get current statistics.
+///
+/// \param out_stats Statistics to be filled
+///
+extern void LTextureRegistry_get_stats(LTextureRegistry_stats* out_stats);
+
+///
+/// Print current statistics via SDL_Log().
+///
+extern void LTextureRegistry_print_stats();
+
+///
+/// Print all live textures along with where they were allocated via SDL_Log().
+/// This is automatically called at exit, if there's any live texture left then it's a leak.
+///
+extern void LTextureRegistry_print_leaks();
+
+#endif
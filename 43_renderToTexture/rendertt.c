@@ -229,6 +229,11 @@ void close()
   if (rendertarget_texture != NULL)
     LTexture_Free(rendertarget_texture);
 
+#ifndef DISABLE_TEXTURE_REGISTRY
+  // report texture memory usage, leaked textures will be reported at exit
+  LTextureRegistry_print_stats();
+#endif
+
   // destroy window
   LWindow_free(gWindow);
 